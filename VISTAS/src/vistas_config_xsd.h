@@ -1,4 +1,4 @@
-// File generated from <vistas_config.xsd> at 2018-06-21T11:11:07
+// File generated from <vistas_config.xsd> at 2026-10-17T22:25:25
 static const char* vistas_config_xsd =
 "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
 "\n"
@@ -60,6 +60,44 @@ static const char* vistas_config_xsd =
 "      <xs:element name=\"NAD_Channel\" type=\"extended-channel-type\" />\n"
 "    </xs:choice>\n"
 "    <xs:attribute name=\"Name\" type=\"non-empty-type\" use=\"required\" />\n"
+"    <xs:attribute name=\"SocketEngine\" type=\"socket-engine-type\" use=\"optional\" default=\"Poll\" />\n"
+"    <!-- ThreadSafe: sampling messages can be read and written by several threads while another\n"
+"         one calls ims_import() and ims_send_all(). Queuing, NAD, discrete and analogue messages\n"
+"         must still be accessed by the thread calling ims_import() and ims_send_all(). -->\n"
+"    <xs:attribute name=\"ThreadSafe\" type=\"xs:boolean\" use=\"optional\" default=\"false\" />\n"
+"    <!-- IoThread: a library thread drains the input sockets as soon as data arrives, imports only\n"
+"         read what it received. IoThreadCpu pins it on a CPU, IoThreadPriority gives it a SCHED_FIFO\n"
+"         priority. Linux only.\n"
+"         AsyncSend: with IoThread and ThreadSafe, ims_send_all() only asks this thread to send the\n"
+"         ports and doesn't wait: a peer may not have received them yet when it returns.\n"
+"         TimeTriggered: with IoThread and ThreadSafe, this thread sends the discrete, analogue and NAD\n"
+"         outputs on the boundaries of their PeriodUs, whatever the ims_send_all() calls. Those calls\n"
+"         then only send the modified discrete outputs, and are asynchronous. -->\n"
+"    <xs:attribute name=\"IoThread\" type=\"xs:boolean\" use=\"optional\" default=\"false\" />\n"
+"    <xs:attribute name=\"IoThreadCpu\" type=\"xs:int\" use=\"optional\" default=\"-1\" />\n"
+"    <xs:attribute name=\"IoThreadPriority\" type=\"xs:nonNegativeInteger\" use=\"optional\" default=\"0\" />\n"
+"    <xs:attribute name=\"AsyncSend\" type=\"xs:boolean\" use=\"optional\" default=\"false\" />\n"
+"    <xs:attribute name=\"TimeTriggered\" type=\"xs:boolean\" use=\"optional\" default=\"false\" />\n"
+"    <!-- ImportWorkers: number of threads reading the input sockets during ims_import(), the calling\n"
+"         one included. Ports are split in shards, a port is always read by one thread at a time.\n"
+"         Ignored with IoThread or the IoUring engine. Linux only. -->\n"
+"    <xs:attribute name=\"ImportWorkers\" type=\"xs:positiveInteger\" use=\"optional\" default=\"1\" />\n"
+"    <!-- SendWorkers: number of threads building the datagrams during ims_send_all(), the calling\n"
+"         one included. The datagrams are then submitted together. Linux only. -->\n"
+"    <xs:attribute name=\"SendWorkers\" type=\"xs:positiveInteger\" use=\"optional\" default=\"1\" />\n"
+"    <!-- MulticastSockets: PerPort shares one input socket between the multicast channels of the same\n"
+"         UDP port and interface, datagrams are told apart by their destination group. Multicast outputs\n"
+"         without SrcPort then have no socket of their own. Linux only. -->\n"
+"    <xs:attribute name=\"MulticastSockets\" type=\"multicast-sockets-type\" use=\"optional\" default=\"PerGroup\" />\n"
+"    <!-- UdpGro: the kernel coalesces the bursts of same-size datagrams of the AFDX queuing inputs, read\n"
+"         in one call and split again. Not used with IoThread or SocketEngine=\"IoUring\". Linux only. -->\n"
+"    <xs:attribute name=\"UdpGro\" type=\"xs:boolean\" use=\"optional\" default=\"false\" />\n"
+"    <!-- MaxFrameRate: max number of datagrams per second of all the outputs together. They are then\n"
+"         all sent by a pacing thread (@see Bag). 0 for no limit. Linux only. -->\n"
+"    <xs:attribute name=\"MaxFrameRate\" type=\"xs:nonNegativeInteger\" use=\"optional\" default=\"0\" />\n"
+"    <!-- SendBufferBytes: send buffer size (SO_SNDBUF) of the output sockets. Datagrams a full buffer\n"
+"         refuses wait for the next ims_send_all (@see ims_message_send_counters). 0 for the system default. -->\n"
+"    <xs:attribute name=\"SendBufferBytes\" type=\"xs:nonNegativeInteger\" use=\"optional\" default=\"0\" />\n"
 "    <xs:anyAttribute namespace=\"##other\" processContents=\"skip\" />\n"
 "  </xs:complexType>\n"
 "\n"
@@ -96,6 +134,22 @@ static const char* vistas_config_xsd =
 "    <xs:attribute name=\"SrcPort\" type=\"xs:positiveInteger\" use=\"optional\" />\n"
 "    <xs:attribute name=\"MulticastInterfaceIP\" type=\"ip-type\" use=\"optional\" />\n"
 "    <xs:attribute name=\"TTL\" type=\"xs:positiveInteger\" use=\"optional\" />\n"
+"    <!-- Transport: Shm exchanges the datagrams with the other processes of the host through a\n"
+"         shared memory ring named after DstIP and DstPort, instead of the network. Auto uses Shm\n"
+"         when the traffic cannot leave the host (loopback DstIP, or multicast on a loopback SrcIP).\n"
+"         Both sides of a channel must use the same transport. Linux only.\n"
+"         Process copies the datagrams directly between the contexts of the same process which\n"
+"         use DstIP and DstPort. Peers in other processes don't receive them. -->\n"
+"    <xs:attribute name=\"Transport\" type=\"socket-transport-type\" use=\"optional\" default=\"Udp\" />\n"
+"    <!-- Bag: bandwidth allocation gap of an output, in us. Its datagrams are sent in order by a pacing\n"
+"         thread, at most one per Bag, instead of all at once by ims_send_all(): a peer may not have\n"
+"         received them yet when it returns. Up to 256 datagrams wait, the oldest ones are then dropped\n"
+"         (@see ims_message_send_counters()). Ignored for inputs. Linux only. -->\n"
+"    <xs:attribute name=\"Bag\" type=\"xs:nonNegativeInteger\" use=\"optional\" default=\"0\" />\n"
+"    <!-- Priority: ims_send_all() sends the ports of the highest priority first, and imports read\n"
+"         them first. When an import runs out of time, the lower priority inputs left are read by\n"
+"         the next one. Channels sharing a socket share its priority. -->\n"
+"    <xs:attribute name=\"Priority\" type=\"priority-type\" use=\"optional\" default=\"0\" />\n"
 "    <xs:anyAttribute namespace=\"##other\" processContents=\"skip\" />\n"
 "  </xs:complexType>\n"
 "\n"
@@ -143,6 +197,43 @@ static const char* vistas_config_xsd =
 "    </xs:restriction>\n"
 "  </xs:simpleType>\n"
 "\n"
+"  <xs:simpleType name='socket-transport-type'>\n"
+"    <xs:restriction base=\"xs:string\">\n"
+"      <xs:enumeration value=\"Udp\" />\n"
+"      <xs:enumeration value=\"Shm\" />\n"
+"      <xs:enumeration value=\"Auto\" />\n"
+"      <xs:enumeration value=\"Process\" />\n"
+"    </xs:restriction>\n"
+"  </xs:simpleType>\n"
+"\n"
+"  <!-- Multicast sockets type: PerPort is Linux only, PerGroup is used when not available -->\n"
+"  <xs:simpleType name='multicast-sockets-type'>\n"
+"    <xs:restriction base=\"xs:string\">\n"
+"      <xs:enumeration value=\"PerGroup\" />\n"
+"      <xs:enumeration value=\"PerPort\" />\n"
+"    </xs:restriction>\n"
+"  </xs:simpleType>\n"
+"\n"
+"  <!-- Socket engine type: IoUring and PacketRing are Linux only, Poll is used when not available.\n"
+"       PacketRing reads the multicast inputs from an AF_PACKET ring on their interface (needs\n"
+"       CAP_NET_RAW, else their sockets are read as with MulticastSockets=\"PerPort\"). Imports may\n"
+"       wait up to a kernel tick for the ring, and datagrams bigger than 1472 bytes still go\n"
+"       through the sockets. -->\n"
+"  <xs:simpleType name='socket-engine-type'>\n"
+"    <xs:restriction base=\"xs:string\">\n"
+"      <xs:enumeration value=\"Poll\" />\n"
+"      <xs:enumeration value=\"IoUring\" />\n"
+"      <xs:enumeration value=\"PacketRing\" />\n"
+"    </xs:restriction>\n"
+"  </xs:simpleType>\n"
+"\n"
+"  <!-- Priority type: 0 is the lowest -->\n"
+"  <xs:simpleType name='priority-type'>\n"
+"    <xs:restriction base=\"xs:nonNegativeInteger\">\n"
+"      <xs:maxInclusive value=\"3\" />\n"
+"    </xs:restriction>\n"
+"  </xs:simpleType>\n"
+"\n"
 "  <xs:simpleType name='speed-type'>\n"
 "    <xs:restriction base=\"xs:string\">\n"
 "      <xs:enumeration value=\"Low\" />\n"
@@ -14,28 +14,296 @@
 // vistas root class
 //
 #include "vistas_context.hh"
+#include "vistas_reactor.hh"
 
+#include <algorithm>
 #include <sys/time.h>
 
+// Send workers: number of chunks of ports per thread. Chunks are claimed one
+// at a time, so a thread done with cheap ports takes the next chunk.
+#define SEND_CHUNKS_PER_WORKER 4
+
 namespace vistas
 {
+context::~context()
+{
+    if (_reactor) _reactor->remove(this);
+
+    if (!_socket_pool) return;
+    _socket_pool->pause_io_thread();
+
+#ifdef VISTAS_HAVE_IO_THREAD
+    // Don't lose the last send_all
+    io_thread_ptr thread = _socket_pool->get_io_thread();
+    if (_async_send && thread && thread->take_request()) {
+        try {
+            emit();
+        } catch (ims::exception&) {}
+    }
+#endif
+}
+
+// Start the I/O thread of the socket pool, if enabled
+void context::start_io_thread(bool async_send, bool time_triggered)
+throw(ims::exception)
+{
+#ifdef VISTAS_HAVE_IO_THREAD
+    io_thread_ptr thread = _socket_pool->get_io_thread();
+    if (!thread) {
+        if (time_triggered) {
+            LOG_WARN("Time-triggered mode needs the I/O thread: periodic ports are sent by ims_send_all.");
+        }
+        return;
+    }
+
+    if (time_triggered && _thread_safe == false) {
+        LOG_WARN("Time-triggered mode needs the thread-safe mode: periodic ports are sent by ims_send_all.");
+        time_triggered = false;
+    }
+    if (time_triggered) {
+        start_scheduler(thread);
+
+        // send_all sends the modified ports: in the same thread as the scheduler
+        async_send = true;
+    }
+
+    if (async_send && _thread_safe == false) {
+        LOG_WARN("Asynchronous sends need the thread-safe mode: ports are sent by ims_send_all.");
+    } else if (async_send) {
+        _async_send = true;
+        thread->set_task(&_emit_task);
+    }
+    thread->start();
+#else
+    if (async_send || time_triggered) {
+        LOG_WARN("Asynchronous sends need the I/O thread: ports are sent by ims_send_all.");
+    }
+#endif
+}
+
+#ifdef VISTAS_HAVE_SCHEDULER
+//
+// The periodic ports with a period leave the wheel of send_all
+//
+void context::start_scheduler(io_thread_ptr thread)
+throw(ims::exception)
+{
+    _scheduler = scheduler_ptr(new scheduler(_socket_pool->get_send_batch()));
+
+    for (port_vector_t::iterator ischeduled = _scheduled_ports.begin();
+         ischeduled != _scheduled_ports.end();
+         ischeduled++)
+    {
+        _periodic_wheel.cancel((*ischeduled)->get_wheel_entry());
+        _scheduler->add(ischeduled->get());
+    }
+    _scheduled_ports.clear();
+
+    _scheduler->start();
+    thread->set_timer(_scheduler->get_timer_fd(), _scheduler.get());
+    _time_triggered = true;
+    LOG_INFO("Time-triggered mode: " << _scheduler->size() << " periodic ports are sent by the I/O thread.");
+}
+#endif
+
+//
+// Build the datagrams with a pool of threads. Ports are split in chunks,
+// a few per thread, each staged in its own lane of the send batch.
+//
+void context::enable_send_workers(__attribute__((__unused__)) uint32_t worker_count)
+throw(ims::exception)
+{
+    if (worker_count <= 1) return;
+
+#ifdef VISTAS_HAVE_WORKER_POOL
+    _send_workers = worker_pool_ptr(new worker_pool(worker_count - 1));
+    _send_chunk_count = (_send_workers->get_thread_count() + 1) * SEND_CHUNKS_PER_WORKER;
+    _socket_pool->get_send_batch()->set_lane_count(_send_chunk_count);
+    LOG_INFO("Sending with " << _send_workers->get_thread_count() + 1 << " threads.");
+#else
+    LOG_WARN("Send workers are only available on Linux, ports will be sent by the caller.");
+#endif
+}
+
 // Send All prepared and periodic ports
 ims_return_code_t context::send_all()
 {
+    // The ports are sent at the dates of the call, even if the application
+    // progresses before the I/O thread sends them (AsyncSend)
     struct timeval tv;
     gettimeofday(&tv, NULL);
-    _posix_timestamp = (tv.tv_sec * 1000000ULL) + tv.tv_usec;
-    
-    _output_queue->send_all();
+    __atomic_store_n(&_posix_timestamp, (tv.tv_sec * 1000000ULL) + tv.tv_usec, __ATOMIC_RELAXED);
+    __atomic_store_n(&_send_time_us, get_time_us(), __ATOMIC_RELEASE);
+
+#ifdef VISTAS_HAVE_IO_THREAD
+    // Let the I/O thread send them. It is stopped while sockets are replaced.
+    io_thread_ptr thread = _socket_pool->get_io_thread();
+    if (_async_send && thread->is_running()) {
+        thread->request();
+        return ims_no_error;
+    }
+#endif
+    return emit();
+}
+
+// Send the ports in the calling thread, at the dates stamped by send_all
+ims_return_code_t context::emit()
+{
+    // Ports datagrams are staged and submitted together at the end
+    send_batch_ptr batch = _socket_pool->get_send_batch();
+    batch->open();
+
+    try {
+#ifdef VISTAS_HAVE_WORKER_POOL
+        if (_send_workers) {
+            emit_parallel(_send_ports);
+        } else
+#endif
+        {
+            // A failing port doesn't prevent the next ones from being sent
+            ims_return_code_t error = ims_no_error;
+            try {
+                _output_queue->send_all();
+            } catch (ims::exception& e) {
+                error = e.get_ims_return_code();
+            }
 
+            for (port_vector_t::iterator iperiodic = _periodic_output_ports.begin();
+                 iperiodic != _periodic_output_ports.end();
+                 iperiodic++)
+            {
+                try {
+                    (*iperiodic)->send();
+                } catch (ims::exception& e) {
+                    if (error == ims_no_error) error = e.get_ims_return_code();
+                }
+            }
+
+            take_due_ports();
+            for (uint32_t idue = 0; idue < _due_entries.size(); idue++) {
+                try {
+                    _due_entries[idue]->port->send();
+                } catch (ims::exception& e) {
+                    if (error == ims_no_error) error = e.get_ims_return_code();
+                }
+            }
+            reschedule_due_ports();
+
+            if (error != ims_no_error) {
+                throw ims::exception(error);
+            }
+        }
+    } catch (...) {
+        // Don't lose what is already staged
+        batch->flush();
+        throw;
+    }
+
+    batch->flush();
+
+    return ims_no_error;
+}
+
+#ifdef VISTAS_HAVE_WORKER_POOL
+//
+// Send the queued and periodic ports with the send workers.
+// A port is in one chunk only, so it is sent by one thread.
+//
+void context::emit_parallel(std::vector<port_weak_ptr>& ports)
+throw(ims::exception)
+{
+    ports.clear();
+    _output_queue->take_all(ports);
     for (port_vector_t::iterator iperiodic = _periodic_output_ports.begin();
          iperiodic != _periodic_output_ports.end();
          iperiodic++)
     {
-        (*iperiodic)->send();
+        ports.push_back(iperiodic->get());
     }
 
-    return ims_no_error;
+    take_due_ports();
+    for (uint32_t idue = 0; idue < _due_entries.size(); idue++) {
+        ports.push_back(_due_entries[idue]->port);
+    }
+
+    uint32_t chunk_count = std::min((uint32_t)ports.size(), _send_chunk_count);
+    send_job job(ports, chunk_count);
+    try {
+        _send_workers->run(job, chunk_count);
+    } catch (...) {
+        reschedule_due_ports();
+        throw;
+    }
+    reschedule_due_ports();
+}
+
+void context::send_job::run(uint32_t chunk)
+{
+    uint32_t first = (uint64_t)_ports.size() * chunk / _chunk_count;
+    uint32_t last = (uint64_t)_ports.size() * (chunk + 1) / _chunk_count;
+
+    // A failing port doesn't prevent the next ones from being sent
+    ims::exception first_error(ims_no_error);
+
+    send_batch::select_lane(chunk);
+    try {
+        for (uint32_t iport = first; iport < last; iport++) {
+            try {
+                _ports[iport]->send();
+            } catch (ims::exception& e) {
+                if (first_error.get_ims_return_code() == ims_no_error) first_error = e;
+            }
+        }
+    } catch (...) {
+        send_batch::select_lane(0);
+        throw;
+    }
+    send_batch::select_lane(0);
+
+    if (first_error.get_ims_return_code() != ims_no_error) {
+        throw first_error;
+    }
+}
+#endif
+
+//
+// Only the due ports are taken from the wheel: the ports sent since their
+// wheel date (modified discretes) are not due yet when their port checks it.
+//
+void context::take_due_ports()
+{
+    // The time went back to 0 (reset_all): all the ports are due again
+    if (__atomic_exchange_n(&_periodic_wheel_reset, false, __ATOMIC_ACQ_REL)) {
+        _periodic_wheel.reset(0);
+        for (port_vector_t::iterator ischeduled = _scheduled_ports.begin();
+             ischeduled != _scheduled_ports.end();
+             ischeduled++)
+        {
+            _periodic_wheel.schedule((*ischeduled)->get_wheel_entry(), 0);
+        }
+    }
+    _due_entries.clear();
+    _periodic_wheel.advance(get_send_time_us(), _due_entries);
+    std::stable_sort(_due_entries.begin(), _due_entries.end(), due_before);
+}
+
+// A port not sent (error) keeps a date already passed: it is due again at the next send_all
+void context::reschedule_due_ports()
+{
+    for (uint32_t idue = 0; idue < _due_entries.size(); idue++) {
+        _periodic_wheel.schedule(_due_entries[idue], _due_entries[idue]->port->get_send_next_date_us());
+    }
+    _due_entries.clear();
+}
+
+bool context::due_before(timing_wheel::entry* a, timing_wheel::entry* b)
+{
+    return a->port->get_priority() > b->port->get_priority();
+}
+
+void context::emit_task::run()
+{
+    _owner->emit();
 }
 
 // Reset all messages
@@ -43,8 +311,9 @@ ims_return_code_t context::reset_all()
 {
     ims_return_code_t result = ims_no_error;
     
-    _time_us = 0;
+    __atomic_store_n(&_time_us, 0, __ATOMIC_RELEASE);
     _time_us_before_notify = 0;
+    __atomic_store_n(&_periodic_wheel_reset, true, __ATOMIC_RELEASE);
 
     for(port_list_t::iterator iport = _port_list.begin();
         iport != _port_list.end();
@@ -74,7 +343,7 @@ ims_return_code_t context::invalidate_all()
 
 ims_return_code_t context::progress(uint32_t duration_us)
 {
-    _time_us += duration_us;
+    __atomic_add_fetch(&_time_us, duration_us, __ATOMIC_RELEASE);
     
     // check if a F_SYNCHRO has been received
     if (_time_us_before_notify > 0)
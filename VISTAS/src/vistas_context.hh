@@ -19,14 +19,20 @@
 #include "vistas_output_queue.hh"
 #include "vistas_port_application.hh"
 #include "vistas_port_instrumentation.hh"
+#include "vistas_scheduler.hh"
 #include "vistas_socket_pool.hh"
+#include "vistas_worker_pool.hh"
 #include <list>
 
+// Duration of a slot of the timing wheel of the periodic ports, in us of context time
+#define PERIODIC_WHEEL_TICK_US 1000
+
 namespace vistas
 {
 class context;
 typedef shared_ptr<context> context_ptr;
 typedef context* context_weak_ptr;
+class reactor;
 
 class context : public backend::context
 {
@@ -46,6 +52,16 @@ public:
     
     inline void set_step_by_step_enabled(bool step_by_step_enabled);
     inline bool is_step_by_step_enabled();
+
+    // Thread-safe mode: application threads may read and write sampling
+    // messages while another thread calls import and send_all.
+    // Must be set before the creation of the messages.
+    inline void set_thread_safe(bool thread_safe);
+    inline bool is_thread_safe();
+
+    // Time-triggered mode: the periodic output ports are sent on their period
+    // boundaries by the scheduler of the I/O thread, not by send_all.
+    inline bool is_time_triggered() { return _time_triggered; }
     
     // Running state
     inline ims_running_state_t get_running_state();
@@ -71,9 +87,26 @@ public:
     // Import incoming data into messages
     inline ims_return_code_t import(uint32_t timeout);
 
-    // Send All prepared and periodic ports
+    // Send All prepared and periodic ports.
+    // With asynchronous sends, only ask the I/O thread to send them.
     ims_return_code_t send_all();
 
+    // Start the I/O thread of the socket pool, if enabled.
+    // async_send: send_all doesn't wait for the ports to be sent (thread-safe mode only).
+    // time_triggered: the I/O thread sends the periodic ports on time (thread-safe mode
+    // only). send_all is then asynchronous too.
+    void start_io_thread(bool async_send, bool time_triggered) throw(ims::exception);
+
+    // Build the datagrams of send_all with worker_count threads, caller included
+    void enable_send_workers(uint32_t worker_count) throw(ims::exception);
+
+    // Stop the I/O thread before anything is freed, and leave the reactor
+    ~context();
+
+    // Reactor importing this context, NULL if none
+    inline reactor* get_reactor() { return _reactor; }
+    inline void set_reactor(reactor* reactor) { _reactor = reactor; }
+
     // Access to the list of prepared ports
     inline output_queue_ptr get_output_queue();
 
@@ -88,11 +121,57 @@ public:
 
     // Time handling
     inline uint64_t get_time_us();
-    inline uint64_t get_posix_timestamp();
     ims_return_code_t progress(uint32_t duration_us);
 
+    // Dates of the current or last emission, stamped by send_all.
+    // Read by the ports it sends, maybe in the I/O thread.
+    inline uint64_t get_send_time_us();
+    inline uint64_t get_posix_timestamp();
+
 private:
     inline context();
+
+    // Send the ports, in the calling thread and the send workers if any
+    ims_return_code_t emit();
+
+    // Take the periodic ports due at the current time, by decreasing priority,
+    // then schedule them again at their next date once sent
+    void take_due_ports();
+    void reschedule_due_ports();
+    static bool due_before(timing_wheel::entry* a, timing_wheel::entry* b);
+
+#ifdef VISTAS_HAVE_SCHEDULER
+    // Move the periodic ports to the scheduler, run by the I/O thread
+    void start_scheduler(io_thread_ptr thread) throw(ims::exception);
+#endif
+
+#ifdef VISTAS_HAVE_WORKER_POOL
+    // Send the given ports, split between the send workers
+    void emit_parallel(std::vector<port_weak_ptr>& ports) throw(ims::exception);
+
+    // Sends consecutive ports of the list, staged in the lane of their chunk
+    class send_job : public worker_pool::job
+    {
+    public:
+        inline send_job(std::vector<port_weak_ptr>& ports, uint32_t chunk_count) :
+            _ports(ports), _chunk_count(chunk_count) {}
+        void run(uint32_t chunk);
+    private:
+        std::vector<port_weak_ptr>& _ports;
+        uint32_t                    _chunk_count;
+    };
+#endif
+
+    // Runs emit() in the I/O thread
+    class emit_task : public io_task
+    {
+    public:
+        inline emit_task(context* owner) : _owner(owner) {}
+        void run();
+    private:
+        context* _owner;
+    };
+
     typedef std::list<port_application_ptr> port_list_t;
     typedef std::vector<port_application_ptr> port_vector_t;
     std::string              _vc_name;
@@ -100,18 +179,36 @@ private:
     uint32_t                 _period_us;
     uint64_t                 _time_us_before_notify;    // in xxx us, must respond R_SYNCHRO
     bool                     _step_by_step_enabled;
+    bool                     _thread_safe;
+    bool                     _async_send;
+    bool                     _time_triggered;
     ims_running_state_t      _running_state;
     bool                     _autonomous_realtime;
     uint32_t                 _steps_requested;
     port_instrumentation*    _port_instrumentation;
     bool                     _powersupply_on;
     float                    _time_ratio;
-    uint64_t                 _time_us;                 // Current time
+    uint64_t                 _time_us;                 // Current time, atomic: read by the I/O thread
+    uint64_t                 _send_time_us;            // Atomic, _time_us at the last send_all
     output_queue_ptr         _output_queue;            // Messages to be send
-    port_vector_t            _periodic_output_ports;   // Ports to be send periodicaly
+    port_vector_t            _periodic_output_ports;   // Ports to be send at each send_all (no period)
+    port_vector_t            _scheduled_ports;         // Ports to be send periodicaly, in the wheel
+    timing_wheel             _periodic_wheel;          // Scheduled ports by next date
+    bool                     _periodic_wheel_reset;    // Atomic, set by reset_all
+    std::vector<timing_wheel::entry*> _due_entries;    // Scheduled ports of the current send_all
     socket_pool_ptr          _socket_pool;             // All sockets
     port_list_t              _port_list;               // All defined ports
-    uint64_t                 _posix_timestamp;         // POSIX timestamp
+    uint64_t                 _posix_timestamp;         // Atomic, POSIX timestamp at the last send_all
+    emit_task                _emit_task;
+    reactor*                 _reactor;                 // Not owned
+#ifdef VISTAS_HAVE_SCHEDULER
+    scheduler_ptr            _scheduler;               // NULL unless time-triggered
+#endif
+#ifdef VISTAS_HAVE_WORKER_POOL
+    worker_pool_ptr          _send_workers;            // NULL when disabled
+    uint32_t                 _send_chunk_count;        // Lanes of the send batch
+    std::vector<port_weak_ptr> _send_ports;            // Ports of the current send_all
+#endif
 };
 
 //***************************************************************************
@@ -122,6 +219,9 @@ context::context() :
     _period_us(0),
     _time_us_before_notify(0),
     _step_by_step_enabled(true),
+    _thread_safe(false),
+    _async_send(false),
+    _time_triggered(false),
     _running_state(ims_running_state_run),
     _autonomous_realtime(true),
     _steps_requested(0),
@@ -129,7 +229,15 @@ context::context() :
     _powersupply_on(false),
     _time_ratio(1.0f),
     _time_us(0),
-    _output_queue(new output_queue())
+    _send_time_us(0),
+    _output_queue(new output_queue()),
+    _periodic_wheel(PERIODIC_WHEEL_TICK_US),
+    _periodic_wheel_reset(false),
+    _emit_task(this),
+    _reactor(NULL)
+#ifdef VISTAS_HAVE_WORKER_POOL
+    , _send_chunk_count(0)
+#endif
 {
 }
 
@@ -178,6 +286,17 @@ bool context::is_step_by_step_enabled()
     return _step_by_step_enabled;
 }
 
+void context::set_thread_safe(bool thread_safe)
+{
+    _thread_safe = thread_safe;
+    _output_queue->set_concurrent(thread_safe);
+}
+
+bool context::is_thread_safe()
+{
+    return _thread_safe;
+}
+
 ims_running_state_t context::get_running_state()
 {
     return _running_state;
@@ -249,12 +368,17 @@ socket_pool_ptr context::get_socket_pool()
 
 uint64_t context::get_time_us()
 {
-    return _time_us;
+    return __atomic_load_n(&_time_us, __ATOMIC_ACQUIRE);
+}
+
+uint64_t context::get_send_time_us()
+{
+    return __atomic_load_n(&_send_time_us, __ATOMIC_ACQUIRE);
 }
 
 uint64_t context::get_posix_timestamp()
 {
-    return _posix_timestamp;
+    return __atomic_load_n(&_posix_timestamp, __ATOMIC_RELAXED);
 }
 
 }
@@ -29,6 +29,8 @@
 #include "vistas_socket_multicast_output.hh"
 #include "vistas_socket_unicast_input.hh"
 #include "vistas_socket_unicast_output.hh"
+#include "vistas_socket_shm.hh"
+#include "vistas_socket_loopback.hh"
 #include "ims_context.hh"
 
 namespace vistas
@@ -41,6 +43,16 @@ namespace vistas
 #define NODE_PROTO_ANALOGUE_NAME "Analog_Channel"
 #define NODE_PROTO_NAD_NAME      "NAD_Channel"
 
+//
+// How the datagrams of a port are exchanged
+//
+enum transport_t
+{
+    transport_udp,                              // Network
+    transport_shm,                              // Shared memory, between the processes of the host
+    transport_process                           // Memory, between the contexts of the process
+};
+
 //
 // Store information on a port
 //
@@ -54,6 +66,7 @@ struct port_info_t
     bool               seq_num_enabled;
     bool               qos_timestamp_enabled;
     bool               data_timestamp_enabled;
+    transport_t        transport;
 };
 typedef shared_ptr<port_info_t>  port_info_ptr;
 
@@ -106,23 +119,29 @@ struct port_factory<port_afdx_queuing_ptr>
     typedef port_afdx_queuing     port_t;
     typedef port_afdx_queuing_ptr port_ptr_t;
 
-    inline port_factory(uint32_t max_size, uint32_t expected_max_size, uint32_t queue_depth) :
+    inline port_factory(uint32_t max_size, uint32_t expected_max_size, uint32_t queue_depth, bool gro) :
         max_size(max_size),
         expected_max_size(expected_max_size),
-        queue_depth(queue_depth)
+        queue_depth(queue_depth),
+        gro(gro)
     {
     }
 
     inline port_afdx_queuing_ptr create_port(context_ptr context,
                                              socket_ptr socket,
-                                             __attribute__((__unused__)) port_info_ptr port_info)
+                                             port_info_ptr port_info)
     {
+        // Bursts of a queuing port are worth coalescing
+        if (gro && port_info->addr->get_direction() == ims_input && socket->set_gro(true) == false) {
+            LOG_INFO(socket->to_string() << ": UDP GRO is not available, datagrams are received one by one.");
+        }
         return port_afdx_queuing_ptr(new vistas::port_afdx_queuing(context.get(), socket, max_size, expected_max_size, queue_depth));
     }
 
     uint32_t max_size;
     uint32_t expected_max_size;
     uint32_t queue_depth;
+    bool     gro;
 };
 
 //
@@ -264,6 +283,17 @@ public:
     socket_address_ptr get_synchronization_address();
     socket_address_ptr get_modes_address();
 
+    // Return the socket engine of the virtual component
+    socket_engine_t get_socket_engine();
+    bool is_thread_safe();
+    bool get_io_thread(int& cpu, int& priority, bool& async_send, bool& time_triggered);
+    uint32_t get_import_workers();
+    uint32_t get_send_workers();
+    bool use_shared_multicast();
+    bool use_udp_gro();
+    uint32_t get_max_frame_rate();
+    uint32_t get_send_buffer_size();
+
     // Generate the XPATHof the given ims node
     std::string build_node_xpath(ims::weak_node_ptr ims_node);
 
@@ -397,6 +427,156 @@ socket_address_ptr context::factory::parser::get_modes_address()
     }
 }
 
+//
+// Return the socket engine of the virtual component (poll by default)
+//
+socket_engine_t context::factory::parser::get_socket_engine()
+{
+    std::string engine = "";
+
+    xmlNodeSetPtr node_set = xpath_query("/Network/VirtualComponent[@Name=\"" + _context->get_vc_name() + "\"]");
+    if (node_set != NULL)
+    {
+        engine = xml_node_property(node_set->nodeTab[0], "SocketEngine", true);
+        xmlXPathFreeNodeSet(node_set);
+    }
+
+    if (engine == "IoUring") {
+        LOG_INFO("io_uring socket engine requested.");
+        return socket_engine_io_uring;
+    }
+    if (engine == "PacketRing") {
+#ifdef VISTAS_HAVE_PACKET_RING
+        LOG_INFO("AF_PACKET ring socket engine requested.");
+        return socket_engine_packet_ring;
+#else
+        LOG_WARN("The packet ring is only available on Linux, using the poll engine.");
+#endif
+    }
+    return socket_engine_poll;
+}
+
+//
+// Return true if the virtual component asks for the thread-safe mode
+//
+bool context::factory::parser::is_thread_safe()
+{
+    std::string thread_safe = "";
+
+    xmlNodeSetPtr node_set = xpath_query("/Network/VirtualComponent[@Name=\"" + _context->get_vc_name() + "\"]");
+    if (node_set != NULL)
+    {
+        thread_safe = xml_node_property(node_set->nodeTab[0], "ThreadSafe", true);
+        xmlXPathFreeNodeSet(node_set);
+    }
+
+    if (thread_safe == "true" || thread_safe == "1") {
+        LOG_INFO("Thread-safe mode requested.");
+        return true;
+    }
+    return false;
+}
+
+//
+// Return true if the virtual component asks for a background I/O thread.
+// cpu, priority, async_send and time_triggered are set to its options
+// (-1, 0, false and false by default).
+//
+bool context::factory::parser::get_io_thread(int& cpu, int& priority, bool& async_send, bool& time_triggered)
+{
+    std::string io_thread = "";
+    std::string async = "";
+    std::string triggered = "";
+    cpu = -1;
+    priority = 0;
+
+    xmlNodeSetPtr node_set = xpath_query("/Network/VirtualComponent[@Name=\"" + _context->get_vc_name() + "\"]");
+    if (node_set != NULL)
+    {
+        io_thread = xml_node_property(node_set->nodeTab[0], "IoThread", true);
+        cpu = xml_node_property_int(node_set->nodeTab[0], "IoThreadCpu", -1);
+        priority = xml_node_property_uint(node_set->nodeTab[0], "IoThreadPriority", 0);
+        async = xml_node_property(node_set->nodeTab[0], "AsyncSend", true);
+        triggered = xml_node_property(node_set->nodeTab[0], "TimeTriggered", true);
+        xmlXPathFreeNodeSet(node_set);
+    }
+
+    async_send = (async == "true" || async == "1");
+    time_triggered = (triggered == "true" || triggered == "1");
+
+    if (io_thread == "true" || io_thread == "1") {
+        LOG_INFO("Background I/O thread requested.");
+        return true;
+    }
+    return false;
+}
+
+//
+// Return the number of threads importing the input sockets (1 by default)
+//
+uint32_t context::factory::parser::get_import_workers()
+{
+    uint32_t import_workers = 1;
+
+    xmlNodeSetPtr node_set = xpath_query("/Network/VirtualComponent[@Name=\"" + _context->get_vc_name() + "\"]");
+    if (node_set != NULL)
+    {
+        import_workers = xml_node_property_uint(node_set->nodeTab[0], "ImportWorkers", 1);
+        xmlXPathFreeNodeSet(node_set);
+    }
+
+    if (import_workers > 1) {
+        LOG_INFO(import_workers << " import workers requested.");
+    }
+    return import_workers;
+}
+
+//
+// Return the number of threads building the datagrams of send_all (1 by default)
+//
+uint32_t context::factory::parser::get_send_workers()
+{
+    uint32_t send_workers = 1;
+
+    xmlNodeSetPtr node_set = xpath_query("/Network/VirtualComponent[@Name=\"" + _context->get_vc_name() + "\"]");
+    if (node_set != NULL)
+    {
+        send_workers = xml_node_property_uint(node_set->nodeTab[0], "SendWorkers", 1);
+        xmlXPathFreeNodeSet(node_set);
+    }
+
+    if (send_workers > 1) {
+        LOG_INFO(send_workers << " send workers requested.");
+    }
+    return send_workers;
+}
+
+//
+// Return true if the multicast sockets of the virtual component are shared
+// by the channels of the same UDP port (PerGroup by default)
+//
+bool context::factory::parser::use_shared_multicast()
+{
+    std::string multicast_sockets = "";
+
+    xmlNodeSetPtr node_set = xpath_query("/Network/VirtualComponent[@Name=\"" + _context->get_vc_name() + "\"]");
+    if (node_set != NULL)
+    {
+        multicast_sockets = xml_node_property(node_set->nodeTab[0], "MulticastSockets", true);
+        xmlXPathFreeNodeSet(node_set);
+    }
+
+    if (multicast_sockets == "PerPort") {
+#ifdef VISTAS_HAVE_SHARED_MULTICAST
+        LOG_INFO("Multicast sockets shared by UDP port requested.");
+        return true;
+#else
+        LOG_WARN("Multicast sockets can only be shared on Linux, using one socket per group.");
+#endif
+    }
+    return false;
+}
+
 //
 // Generate the XPATH of the given ims node
 //
@@ -496,6 +676,7 @@ port_info_ptr context::factory::parser::parse_port(xmlNodePtr      port_node,
     info->seq_num_enabled = false;
     info->qos_timestamp_enabled = false;
     info->data_timestamp_enabled = false;
+    info->transport = transport_udp;
     xmlNodeSetPtr header_node_set = xml_xpath_get_children(_doc, port_node, "Header");
     if (header_node_set != NULL)
     {
@@ -551,6 +732,13 @@ port_info_ptr context::factory::parser::parse_port(xmlNodePtr      port_node,
         std::string interface_ip = xml_node_property(socket_node, "SrcIP", true);
         uint32_t output_port = xml_node_property_uint(socket_node, "SrcPort", 0);
         uint32_t output_TTL = xml_node_property_uint(socket_node, "TTL", 1);
+        std::string transport = xml_node_property(socket_node, "Transport", true);
+        uint32_t bag_us = xml_node_property_uint(socket_node, "Bag", 0);
+        uint32_t priority = xml_node_property_uint(socket_node, "Priority", 0);
+        if (priority >= VISTAS_PRIORITY_COUNT) {
+            xmlXPathFreeNodeSet(socket_node_set);
+            THROW_XML_ERROR(this, "Priority " << priority << " is above the highest one (" << VISTAS_PRIORITY_COUNT - 1 << ")");
+        }
 
         info->addr = socket_address_ptr(new socket_address_t(direction,
                                                              address_ip,
@@ -558,7 +746,16 @@ port_info_ptr context::factory::parser::parse_port(xmlNodePtr      port_node,
                                                              interface_ip,
                                                              output_TTL,
                                                              output_port));
+        if (direction == ims_output) {
+            info->addr->set_bag_us(bag_us);
+        }
+        info->addr->set_priority(priority);
 
+        if (transport == "Shm" || (transport == "Auto" && info->addr->is_local())) {
+            info->transport = transport_shm;
+        } else if (transport == "Process") {
+            info->transport = transport_process;
+        }
     }
     
     xmlXPathFreeNodeSet(socket_node_set);
@@ -577,11 +774,28 @@ typename port_factory::port_ptr_t context::factory::get_or_create_port(port_fact
         // Port doesn't exists, create a new one and its socket
         socket_ptr socket;
         bool is_multicast = port_info->addr->is_multicast();
+        if (port_info->transport == transport_process)
+        {
+            socket = socket_ptr(new socket_loopback(port_info->addr));
+        }
+        else
+#ifdef VISTAS_HAVE_SHM
+        if (port_info->transport == transport_shm)
+        {
+            socket = socket_ptr(new socket_shm(port_info->addr));
+        }
+        else
+#else
+        if (port_info->transport == transport_shm)
+        {
+            LOG_WARN("Shared memory sockets are only available on Linux, " << port_info->addr->to_string() << " uses UDP.");
+        }
+#endif
         if (port_info->addr->get_direction() == ims_input)
         {
             if (is_multicast)
             {
-                socket = socket_ptr(new socket_multicast_input(port_info->addr));
+                socket = create_multicast_input(port_info->addr);
             }
             else
             {
@@ -592,7 +806,7 @@ typename port_factory::port_ptr_t context::factory::get_or_create_port(port_fact
         {
             if (is_multicast)
             {
-                socket = socket_ptr(new socket_multicast_output(port_info->addr));
+                socket = create_multicast_output(port_info->addr);
             }
             else
             {
@@ -624,6 +838,16 @@ typename port_factory::port_ptr_t context::factory::get_or_create_port(port_fact
                             port_info->addr->to_string() << ") with different outgoing port!");
         }
 
+        if (port_info->addr->get_bag_us() != port->get_socket()->get_address()->get_bag_us()) {
+            THROW_IMS_ERROR(ims_invalid_configuration, "Same address (" <<
+                            port_info->addr->to_string() << ") with different BAG!");
+        }
+
+        if (port_info->addr->get_priority() != port->get_socket()->get_address()->get_priority()) {
+            THROW_IMS_ERROR(ims_invalid_configuration, "Same address (" <<
+                            port_info->addr->to_string() << ") with different priority!");
+        }
+
         port_application_base * weak_port_application =  dynamic_cast<port_application_base *>(port.get());
         if (weak_port_application != NULL)
         {
@@ -658,8 +882,18 @@ typename port_factory::port_ptr_t context::factory::get_or_create_port(port_fact
 void context::factory::context_register_port(port_application_ptr port)
 {
     _context->_port_list.push_back(port);
-    if (port->is_periodic_output()) {
-        _context->_periodic_output_ports.push_back(port);
+    if (port->is_periodic_output() && port->get_send_period_us() > 0) {
+        // Due at the first send_all
+        _context->_scheduled_ports.push_back(port);
+        _context->_periodic_wheel.schedule(port->get_wheel_entry(), 0);
+    } else if (port->is_periodic_output()) {
+        // Highest priority first, then in registration order
+        port_vector_t::iterator iperiodic = _context->_periodic_output_ports.begin();
+        while (iperiodic != _context->_periodic_output_ports.end() &&
+               (*iperiodic)->get_priority() >= port->get_priority()) {
+            iperiodic++;
+        }
+        _context->_periodic_output_ports.insert(iperiodic, port);
     }
 }
 
@@ -676,6 +910,124 @@ void context::factory::init(std::string vc_name,
     _context->set_prod_id(prod_id);
     _context->set_period_us(period_us);
     _context->set_step_by_step_enabled(step_by_step_enabled);
+    _context->set_thread_safe(_parser->is_thread_safe());
+    _shared_multicast = _parser->use_shared_multicast();
+    _udp_gro = _parser->use_udp_gro();
+    _socket_pool_factory.set_socket_engine(_parser->get_socket_engine());
+}
+
+//
+// Create the socket of a multicast input. When shared, it joins the latest
+// socket opened for its interface and port, or a new one if that one is full.
+// The packet ring engine reads the members of the shared sockets.
+//
+socket_ptr context::factory::create_multicast_input(socket_address_ptr address)
+{
+#ifdef VISTAS_HAVE_SHARED_MULTICAST
+    if (_shared_multicast || _socket_pool_factory.get_socket_engine() == socket_engine_packet_ring) {
+        socket_multicast_member* member = new socket_multicast_member(address);
+        socket_ptr socket(member);
+
+        std::stringstream key;
+        key << address->get_interface_ip() << ':' << address->get_port();
+        socket_multicast_shared_ptr& shared = _shared_multicast_inputs[key.str()];
+
+        if (!shared || member->join(shared) == false) {
+            if (shared) {
+                LOG_INFO(shared->to_string() << " cannot join more groups, opening another one. "
+                         "Raise net.ipv4.igmp_max_memberships to share it more.");
+            }
+            shared = socket_multicast_shared_ptr(new socket_multicast_shared(address->get_port(),
+                                                                             address->get_interface_ip()));
+            member->join(shared);
+        }
+        return socket;
+    }
+#endif
+    return socket_ptr(new socket_multicast_input(address));
+}
+
+//
+// Create the socket of a multicast output. When shared, outputs without
+// outgoing port have no socket of their own: the send batch carrier sends them.
+//
+socket_ptr context::factory::create_multicast_output(socket_address_ptr address)
+{
+    if (_shared_multicast && address->get_outgoing_port() == 0) {
+        socket_multicast_output* output = new socket_multicast_output();
+        socket_ptr socket(output);
+        output->create_shared(address);
+        return socket;
+    }
+    return socket_ptr(new socket_multicast_output(address));
+}
+
+//
+// Return true if the AFDX queuing inputs of the virtual component let the
+// kernel coalesce their datagrams
+//
+bool context::factory::parser::use_udp_gro()
+{
+    std::string udp_gro = "";
+
+    xmlNodeSetPtr node_set = xpath_query("/Network/VirtualComponent[@Name=\"" + _context->get_vc_name() + "\"]");
+    if (node_set != NULL)
+    {
+        udp_gro = xml_node_property(node_set->nodeTab[0], "UdpGro", true);
+        xmlXPathFreeNodeSet(node_set);
+    }
+
+    if (udp_gro == "true" || udp_gro == "1") {
+#ifdef VISTAS_HAVE_UDP_GRO
+        LOG_INFO("UDP GRO requested for the AFDX queuing inputs.");
+        return true;
+#else
+        LOG_WARN("UDP GRO is only available on Linux, datagrams are received one by one.");
+#endif
+    }
+    return false;
+}
+
+//
+// Return the max number of datagrams per second of all the outputs of the
+// virtual component, 0 for no limit (default)
+//
+uint32_t context::factory::parser::get_max_frame_rate()
+{
+    uint32_t max_frame_rate = 0;
+
+    xmlNodeSetPtr node_set = xpath_query("/Network/VirtualComponent[@Name=\"" + _context->get_vc_name() + "\"]");
+    if (node_set != NULL)
+    {
+        max_frame_rate = xml_node_property_uint(node_set->nodeTab[0], "MaxFrameRate", 0);
+        xmlXPathFreeNodeSet(node_set);
+    }
+
+    if (max_frame_rate != 0) {
+        LOG_INFO("Max frame rate of the outputs: " << max_frame_rate << " datagrams/s.");
+    }
+    return max_frame_rate;
+}
+
+//
+// Return the send buffer size of the output sockets of the virtual
+// component, 0 for the system default (default)
+//
+uint32_t context::factory::parser::get_send_buffer_size()
+{
+    uint32_t send_buffer_size = 0;
+
+    xmlNodeSetPtr node_set = xpath_query("/Network/VirtualComponent[@Name=\"" + _context->get_vc_name() + "\"]");
+    if (node_set != NULL)
+    {
+        send_buffer_size = xml_node_property_uint(node_set->nodeTab[0], "SendBufferBytes", 0);
+        xmlXPathFreeNodeSet(node_set);
+    }
+
+    if (send_buffer_size != 0) {
+        LOG_INFO("Send buffer of the output sockets: " << send_buffer_size << " bytes.");
+    }
+    return send_buffer_size;
 }
 
 //
@@ -733,7 +1085,7 @@ ims::message_ptr context::factory::create_afdx_queuing(ims::node_ptr        ims_
                   port_info->message_max_size << " in VISTAS config. IMS will use the smallest value : " << buffer_size);
     }
 
-    port_afdx_queuing_ptr port = get_or_create_port(port_factory<port_afdx_queuing_ptr>(buffer_size, max_size, queue_depth), port_info);
+    port_afdx_queuing_ptr port = get_or_create_port(port_factory<port_afdx_queuing_ptr>(buffer_size, max_size, queue_depth, _udp_gro), port_info);
 
     return port->get_message(message_name, local_name);
 
@@ -952,7 +1304,19 @@ backend::context_ptr context::factory::build()
         LOG_INFO("Registered to modes controller");
     }
 
+    int io_thread_cpu;
+    int io_thread_priority;
+    bool async_send;
+    bool time_triggered;
+    bool io_thread = _parser->get_io_thread(io_thread_cpu, io_thread_priority, async_send, time_triggered);
+    _socket_pool_factory.set_io_thread(io_thread, io_thread_cpu, io_thread_priority);
+    _socket_pool_factory.set_import_workers(_parser->get_import_workers());
+    _socket_pool_factory.set_max_frame_rate(_parser->get_max_frame_rate());
+    _socket_pool_factory.set_send_buffer_size(_parser->get_send_buffer_size());
+
     _context->_socket_pool = _socket_pool_factory.create_pool();
+    _context->enable_send_workers(_parser->get_send_workers());
+    _context->start_io_thread(io_thread && async_send, time_triggered);
     return _context;
 }
 
@@ -960,7 +1324,9 @@ backend::context_ptr context::factory::build()
 // Main Ctor
 //
 context::factory::factory(const char* vistas_config_file_path) throw(ims::exception) :
-    _context(new context())
+    _context(new context()),
+    _shared_multicast(false),
+    _udp_gro(false)
 {
 #ifdef _WIN32
     WSADATA wsaData;
@@ -19,6 +19,8 @@
 #include "shared_ptr.hh"
 #include "backend_context.hh"
 #include "vistas_context.hh"
+#include "vistas_socket_multicast_shared.hh"
+#include <map>
 
 namespace vistas
 {
@@ -135,12 +137,22 @@ private:
                                                          port_info_ptr port_info);
 
     void context_register_port(port_application_ptr port);
+
+    // Create the socket of a multicast input, or of an output without outgoing port
+    socket_ptr create_multicast_input(socket_address_ptr address);
+    socket_ptr create_multicast_output(socket_address_ptr address);
     
     class parser;
 
     parser*              _parser;
     socket_pool::factory _socket_pool_factory;
     context_ptr          _context;
+    bool                 _shared_multicast;     // One socket per UDP port for the multicast inputs
+    bool                 _udp_gro;              // Coalesced receives for the AFDX queuing inputs
+#ifdef VISTAS_HAVE_SHARED_MULTICAST
+    typedef std::map<std::string, socket_multicast_shared_ptr> shared_multicast_map_t;
+    shared_multicast_map_t _shared_multicast_inputs;   // By interface and port: the latest one opened
+#endif
 };
 }
 
@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Pre-allocated datagram slots to drain an input socket in batches
+//
+#ifndef _VISTAS_DATAGRAM_BATCH_HH_
+#define _VISTAS_DATAGRAM_BATCH_HH_
+#include "vistas_socket.hh"
+
+// Default number of slots of a batch
+#define DATAGRAM_BATCH_SIZE 16
+
+namespace vistas
+{
+
+class datagram_batch
+{
+public:
+    // Slots are only allocated on first receive, so output ports don't pay for them.
+    inline datagram_batch(uint32_t slot_size, uint32_t slot_count = DATAGRAM_BATCH_SIZE);
+    inline ~datagram_batch();
+
+    // Read the next pending datagrams of the socket.
+    // @return The number of filled slots. When it equals capacity(), more
+    // datagrams may be pending.
+    inline uint32_t receive(socket_ptr& socket) throw(ims::exception);
+
+    // Number of slots
+    inline uint32_t capacity() { return _slot_count; }
+
+    // Access to a filled slot
+    inline char*       data(uint32_t id) { return _datagrams[id].buffer; }
+    inline uint32_t    size(uint32_t id) { return _datagrams[id].size;   }
+
+private:
+    uint32_t          _slot_size;
+    uint32_t          _slot_count;
+    char*             _buffer;
+    socket::datagram* _datagrams;
+};
+
+//***************************************************************************
+// Inlines
+//***************************************************************************
+datagram_batch::datagram_batch(uint32_t slot_size, uint32_t slot_count) :
+    _slot_size(slot_size),
+    _slot_count(slot_count),
+    _buffer(NULL),
+    _datagrams(NULL)
+{
+}
+
+datagram_batch::~datagram_batch()
+{
+    delete[] _datagrams;
+    delete[] _buffer;
+}
+
+uint32_t datagram_batch::receive(socket_ptr& socket)
+throw(ims::exception)
+{
+    if (_datagrams == NULL) {
+        _buffer = new char[_slot_size * _slot_count];
+        _datagrams = new socket::datagram[_slot_count];
+        for (uint32_t id = 0; id < _slot_count; id++) {
+            _datagrams[id].buffer = _buffer + id * _slot_size;
+            _datagrams[id].buffer_size = _slot_size;
+            _datagrams[id].size = 0;
+        }
+    }
+
+    return socket->receive_many(_datagrams, _slot_count);
+}
+
+}
+#endif
@@ -0,0 +1,441 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Background network I/O thread (Linux only).
+//
+#include "vistas_io_thread.hh"
+#include <algorithm>
+#include <string.h>
+
+#ifdef VISTAS_HAVE_IO_THREAD
+#include <errno.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#endif
+
+// Size of an inbox. Records are packed, so small datagrams don't waste it.
+#define IO_INBOX_SIZE        (256 * 1024)
+
+// Biggest UDP datagram
+#define IO_DATAGRAM_MAX      65536
+
+// Size of a record, header included
+#define IO_RECORD_SIZE(size) ((sizeof(record) + (size) + 7) & ~7)
+
+// Record size marking the end of the buffer as unused
+#define IO_RECORD_SKIP       0xFFFFFFFF
+
+#ifdef VISTAS_HAVE_IO_THREAD
+// Max events handled by one epoll_wait call
+#define IO_EVENTS_MAX        64
+
+// Poll period of the stalled sockets, in ms
+#define IO_STALLED_WAIT_MS   1
+
+// Event user data of the wake up eventfd
+#define IO_WAKE_DATA         0xFFFFFFFFU
+
+// Event data of the timer
+#define IO_TIMER_DATA        0xFFFFFFFEU
+#endif
+
+namespace vistas
+{
+//===========================================================================
+// Inbox
+//===========================================================================
+void io_inbox::allocate()
+{
+    _buffer.resize(IO_INBOX_SIZE);
+}
+
+//
+// Return a record able to store size bytes, or NULL if there is no room.
+// A record is never split: if it doesn't fit before the end of the buffer,
+// the end is skipped.
+//
+io_inbox::record* io_inbox::reserve(uint32_t size)
+{
+    uint64_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    uint32_t free_size = _buffer.size() - (uint32_t)(_tail - head);
+    uint32_t offset = _tail % _buffer.size();
+    uint32_t contiguous = _buffer.size() - offset;
+
+    if (contiguous < size) {
+        if (free_size < contiguous + size) return NULL;
+
+        ((record*)&_buffer[offset])->size = IO_RECORD_SKIP;
+        __atomic_store_n(&_tail, _tail + contiguous, __ATOMIC_RELEASE);
+        offset = 0;
+    } else if (free_size < size) {
+        return NULL;
+    }
+
+    return (record*)&_buffer[offset];
+}
+
+#ifdef VISTAS_HAVE_IO_THREAD
+//
+// Move the pending datagrams of the socket into the inbox
+//
+bool io_inbox::fill(IMS_SOCKET fd)
+{
+    for (;;) {
+        uint32_t max_size = IO_DATAGRAM_MAX;
+        record* current = reserve(IO_RECORD_SIZE(max_size));
+
+        if (current == NULL) {
+            // No room for the biggest datagram: check the size of the next one
+            int pending = 0;
+            if (ioctl(fd, FIONREAD, &pending) != 0) pending = IO_DATAGRAM_MAX;
+            max_size = std::min(pending, IO_DATAGRAM_MAX);
+            current = reserve(IO_RECORD_SIZE(max_size));
+            if (current == NULL) return false;
+        }
+
+        socklen_t from_size = sizeof(struct sockaddr_in);
+        int res = recvfrom(fd, (char*)(current + 1), max_size, MSG_DONTWAIT,
+                           (struct sockaddr*)&current->from, &from_size);
+        if (res < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_ERROR_RATE_LIMITED("I/O thread: failed to read from socket. error: " << socket::getlasterror());
+            }
+            return true;
+        }
+
+        current->size = res;
+        __atomic_store_n(&_tail, _tail + IO_RECORD_SIZE(res), __ATOMIC_RELEASE);
+    }
+}
+#endif
+
+//
+// Copy a datagram made of a header and its payload in the inbox
+//
+bool io_inbox::push(const char* header, uint32_t header_size,
+                    const char* payload, uint32_t payload_size,
+                    const struct sockaddr_in& from)
+{
+    uint32_t size = header_size + payload_size;
+    record* current = reserve(IO_RECORD_SIZE(size));
+    if (current == NULL) return false;
+
+    memcpy(current + 1, header, header_size);
+    if (payload_size > 0) memcpy((char*)(current + 1) + header_size, payload, payload_size);
+    current->size = size;
+    current->from = from;
+
+    __atomic_store_n(&_tail, _tail + IO_RECORD_SIZE(size), __ATOMIC_RELEASE);
+    return true;
+}
+
+//
+// Copy datagrams of the inbox in the given slots
+//
+uint32_t io_inbox::receive_many(socket::datagram* datagrams, uint32_t count)
+{
+    uint64_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+    uint64_t head = _head;
+    uint32_t received = 0;
+
+    while (received < count && head != tail) {
+        uint32_t offset = head % _buffer.size();
+        record* pending = (record*)&_buffer[offset];
+
+        if (pending->size == IO_RECORD_SKIP) {
+            head += _buffer.size() - offset;
+            continue;
+        }
+
+        // Same behaviour as recvmmsg: a too big datagram is truncated,
+        // and what doesn't fit in the buffer goes to the payload segment.
+        socket::datagram& current = datagrams[received];
+        const char* payload = (const char*)(pending + 1);
+        uint32_t head_size = std::min(pending->size, current.buffer_size);
+        uint32_t tail_size = (current.payload != NULL)? std::min(pending->size - head_size, current.payload_size) : 0;
+        memcpy(current.buffer, payload, head_size);
+        if (tail_size > 0) memcpy(current.payload, payload + head_size, tail_size);
+        current.size = head_size + tail_size;
+
+#ifdef ENABLE_INSTRUMENTATION
+        // Call handler
+        if(ims_socket_handler_recv){
+            ims_socket_handler_recv(payload,
+                                    current.size,
+                                    inet_ntoa(pending->from.sin_addr),
+                                    ntohs(pending->from.sin_port));
+        }
+#endif
+
+        head += IO_RECORD_SIZE(pending->size);
+        received++;
+    }
+
+    // Give the room back to the I/O thread
+    __atomic_store_n(&_head, head, __ATOMIC_RELEASE);
+    return received;
+}
+
+#ifdef VISTAS_HAVE_IO_THREAD
+//===========================================================================
+// Thread
+//===========================================================================
+io_thread::io_thread(uint32_t slots, int cpu, int priority)
+throw(ims::exception) :
+    _entries(slots),
+    _epoll_fd(-1),
+    _wake_fd(-1),
+    _cpu(cpu),
+    _priority(priority),
+    _task(NULL),
+    _timer_task(NULL),
+    _running(false),
+    _stop_requested(0),
+    _task_requested(0)
+{
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    _wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_epoll_fd < 0 || _wake_fd < 0) {
+        if (_epoll_fd >= 0) ::close(_epoll_fd);
+        if (_wake_fd >= 0) ::close(_wake_fd);
+        THROW_IMS_ERROR(ims_init_failure, "Cannot create the I/O thread poller! errno: " << errno);
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = IO_WAKE_DATA;
+    epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _wake_fd, &event);
+}
+
+io_thread::~io_thread()
+{
+    stop();
+    ::close(_wake_fd);
+    ::close(_epoll_fd);
+}
+
+//
+// Drain the given datagram socket in the inbox
+//
+void io_thread::watch(uint32_t id, IMS_SOCKET fd, io_inbox* inbox)
+throw(ims::exception)
+{
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = id;
+
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        THROW_IMS_ERROR(ims_implementation_specific_error, "I/O thread cannot poll socket! errno: " << errno);
+    }
+
+    _entries[id].fd = fd;
+    _entries[id].inbox = inbox;
+    _entries[id].stalled = false;
+}
+
+//
+// Stop draining a socket
+//
+bool io_thread::unwatch(uint32_t id)
+{
+    entry& current = _entries[id];
+    if (current.fd == INVALID_SOCKET) return false;
+
+    // Event pointer is ignored but must not be NULL for kernels < 2.6.9
+    struct epoll_event event;
+    epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, current.fd, &event);
+
+    if (current.stalled) {
+        _stalled.erase(std::find(_stalled.begin(), _stalled.end(), id));
+    }
+    current = entry();
+    return true;
+}
+
+//
+// Run the task when the timer expires
+//
+void io_thread::set_timer(int timer_fd, io_task* task)
+throw(ims::exception)
+{
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = IO_TIMER_DATA;
+
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, timer_fd, &event) != 0) {
+        THROW_IMS_ERROR(ims_implementation_specific_error, "I/O thread cannot poll its timer! errno: " << errno);
+    }
+    _timer_task = task;
+}
+
+//
+// Start the thread, pinned and with the requested priority if possible
+//
+void io_thread::start()
+throw(ims::exception)
+{
+    if (_running) return;
+
+    __atomic_store_n(&_stop_requested, 0, __ATOMIC_RELAXED);
+    int res = pthread_create(&_thread, NULL, thread_main, this);
+    if (res != 0) {
+        THROW_IMS_ERROR(ims_implementation_specific_error, "Cannot create the I/O thread! error: " << strerror(res));
+    }
+    _running = true;
+
+    if (_cpu >= 0) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(_cpu, &cpu_set);
+        res = pthread_setaffinity_np(_thread, sizeof(cpu_set_t), &cpu_set);
+        if (res != 0) {
+            LOG_WARN("Cannot pin the I/O thread on CPU " << _cpu << ": " << strerror(res));
+        }
+    }
+
+    if (_priority > 0) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = _priority;
+        res = pthread_setschedparam(_thread, SCHED_FIFO, &param);
+        if (res != 0) {
+            LOG_WARN("Cannot set the I/O thread SCHED_FIFO priority " << _priority << ": " << strerror(res));
+        }
+    }
+}
+
+void io_thread::stop()
+{
+    if (!_running) return;
+
+    __atomic_store_n(&_stop_requested, 1, __ATOMIC_RELEASE);
+    wake();
+    pthread_join(_thread, NULL);
+    _running = false;
+}
+
+//
+// Ask the thread to run the task
+//
+void io_thread::request()
+{
+    if (__atomic_exchange_n(&_task_requested, 1, __ATOMIC_ACQ_REL) == 0) {
+        wake();
+    }
+}
+
+void io_thread::wake()
+{
+    uint64_t one = 1;
+    while (write(_wake_fd, &one, sizeof(one)) < 0 && errno == EINTR);
+}
+
+void* io_thread::thread_main(void* self)
+{
+    ((io_thread*)self)->run();
+    return NULL;
+}
+
+//
+// Thread loop: sleep until a socket is readable, a request is posted or the
+// timer expires
+//
+void io_thread::run()
+{
+    struct epoll_event events[IO_EVENTS_MAX];
+
+    while (__atomic_load_n(&_stop_requested, __ATOMIC_ACQUIRE) == 0) {
+        // Also handles the requests posted while the thread was stopped
+        if (_task != NULL && take_request()) {
+            try {
+                _task->run();
+            } catch (ims::exception&) {
+                // Already logged where it was thrown
+            }
+        }
+
+        int timeout = _stalled.empty()? -1 : IO_STALLED_WAIT_MS;
+        int nb_events = epoll_wait(_epoll_fd, events, IO_EVENTS_MAX, timeout);
+        if (nb_events < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERROR("I/O thread: epoll_wait fail! errno: " << errno);
+            return;
+        }
+
+        for (int ievent = 0; ievent < nb_events; ievent++) {
+            if (events[ievent].data.u64 == IO_WAKE_DATA) {
+                uint64_t count;
+                while (read(_wake_fd, &count, sizeof(count)) < 0 && errno == EINTR);
+            } else if (events[ievent].data.u64 == IO_TIMER_DATA) {
+                try {
+                    _timer_task->run();
+                } catch (ims::exception&) {
+                    // Already logged where it was thrown
+                }
+            } else {
+                drain(events[ievent].data.u64);
+            }
+        }
+
+        retry_stalled();
+    }
+}
+
+//
+// Drain a socket. Stop polling it if its inbox is full.
+//
+void io_thread::drain(uint32_t id)
+{
+    entry& current = _entries[id];
+    if (current.stalled || current.inbox->fill(current.fd)) return;
+
+    struct epoll_event event;
+    event.events = 0;
+    event.data.u64 = id;
+    epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, current.fd, &event);
+
+    current.stalled = true;
+    _stalled.push_back(id);
+}
+
+//
+// Drain the stalled sockets whose inbox has room again, and poll them again
+//
+void io_thread::retry_stalled()
+{
+    uint32_t nb_stalled = 0;
+    for (uint32_t istalled = 0; istalled < _stalled.size(); istalled++) {
+        uint32_t id = _stalled[istalled];
+        entry& current = _entries[id];
+
+        if (current.inbox->fill(current.fd) == false) {
+            _stalled[nb_stalled++] = id;
+            continue;
+        }
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u64 = id;
+        epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, current.fd, &event);
+        current.stalled = false;
+    }
+    _stalled.resize(nb_stalled);
+}
+
+#endif
+
+}
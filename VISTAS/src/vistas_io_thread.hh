@@ -0,0 +1,202 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Background network I/O thread (Linux only).
+// The thread drains the input datagram sockets as soon as data arrives, so
+// bursts don't overflow the socket buffers between two imports. Datagrams
+// wait in the inbox of their socket until its port reads them during import.
+// On request, the thread also runs the emission of send_all (@see io_task),
+// and the time-triggered emission when its timer expires (@see scheduler).
+//
+#ifndef _VISTAS_IO_THREAD_HH_
+#define _VISTAS_IO_THREAD_HH_
+#include "vistas_socket.hh"
+#include "vistas_sync.hh"
+#include <vector>
+
+#ifdef __linux
+#include <pthread.h>
+#define VISTAS_HAVE_IO_THREAD
+#endif
+
+namespace vistas
+{
+class io_thread;
+typedef shared_ptr<io_thread> io_thread_ptr;
+
+//
+// Datagrams received for one socket, not yet read by its port.
+// Single producer (the I/O thread, or the emitters of an in-process channel
+// taking turns), single consumer (the import thread): neither of them ever
+// waits for the other.
+//
+class io_inbox
+{
+public:
+    inline io_inbox();
+
+    // Allocate the buffer. Must be called before the first fill.
+    void allocate();
+
+#ifdef VISTAS_HAVE_IO_THREAD
+    // Producer side: move the pending datagrams of the socket into the inbox.
+    // @return false if the inbox is full while the socket still has pending datagrams.
+    bool fill(IMS_SOCKET fd);
+#endif
+
+    // Producer side: copy a datagram made of a header and its payload.
+    // @return false if there is no room for it.
+    bool push(const char* header, uint32_t header_size,
+              const char* payload, uint32_t payload_size,
+              const struct sockaddr_in& from);
+
+    // Consumer side
+    inline bool empty();
+
+    // Copy up to count datagrams in the given slots, like socket::receive_many
+    // @return The number of datagrams copied
+    uint32_t receive_many(socket::datagram* datagrams, uint32_t count);
+
+    // Drop all the datagrams. Only when the I/O thread is stopped.
+    inline void clear();
+
+private:
+    // Header of a datagram in the buffer. Records are aligned on 8 bytes.
+    struct record
+    {
+        uint32_t           size;
+        uint32_t           reserved;
+        struct sockaddr_in from;
+    };
+
+    // Return a record able to store size bytes, or NULL if there is no room
+    record* reserve(uint32_t size);
+
+    std::vector<char> _buffer;
+    char              _padding_begin[VISTAS_CACHE_LINE_SIZE];
+    uint64_t          _head;        // Consumer position, only written by the import thread
+    char              _padding_middle[VISTAS_CACHE_LINE_SIZE - sizeof(uint64_t)];
+    uint64_t          _tail;        // Producer position, only written by the I/O thread
+    char              _padding_end[VISTAS_CACHE_LINE_SIZE - sizeof(uint64_t)];
+};
+
+//
+// Work run by the I/O thread on request
+//
+class io_task
+{
+public:
+    virtual void run() = 0;
+    virtual ~io_task() {}
+};
+
+#ifdef VISTAS_HAVE_IO_THREAD
+class io_thread
+{
+public:
+    // cpu: CPU the thread is pinned on, or -1.
+    // priority: SCHED_FIFO priority of the thread, or 0 for the default policy.
+    // slots: number of input ids which can be watched.
+    io_thread(uint32_t slots, int cpu, int priority)
+    throw(ims::exception);
+
+    // Stop the thread
+    ~io_thread();
+
+    // Drain the given datagram socket in the inbox. id (< slots) identifies
+    // the socket for unwatch(). Only while the thread is stopped.
+    void watch(uint32_t id, IMS_SOCKET fd, io_inbox* inbox)
+    throw(ims::exception);
+
+    // Stop draining the socket registered with the given id.
+    // Only while the thread is stopped.
+    // @return false if no socket is registered with this id.
+    bool unwatch(uint32_t id);
+
+    // Task run when a request is posted
+    inline void set_task(io_task* task) { _task = task; }
+
+    // Task run when the timer fd (a timerfd) expires. The task reads it.
+    // Only while the thread is stopped.
+    void set_timer(int timer_fd, io_task* task)
+    throw(ims::exception);
+
+    // Start/stop the thread. Requests posted while it is stopped are kept.
+    void start() throw(ims::exception);
+    void stop();
+    inline bool is_running() { return _running; }
+
+    // Ask the thread to run the task. Requests posted before the task runs are merged.
+    void request();
+
+    // Return true if a request was not handled yet, and drop it.
+    // Used to run the task in the caller thread once the thread is stopped.
+    inline bool take_request() { return __atomic_exchange_n(&_task_requested, 0, __ATOMIC_ACQ_REL) != 0; }
+
+private:
+    struct entry
+    {
+        inline entry() : fd(INVALID_SOCKET), inbox(NULL), stalled(false) {}
+        IMS_SOCKET fd;
+        io_inbox*  inbox;
+        bool       stalled;     // Inbox full: the socket is not polled anymore
+    };
+
+    static void* thread_main(void* self);
+    void run();
+
+    // Wake up the thread
+    void wake();
+
+    // Drain a socket. Stop polling it if its inbox is full.
+    void drain(uint32_t id);
+
+    // Drain the stalled sockets whose inbox has room again
+    void retry_stalled();
+
+    std::vector<entry>    _entries;            // By id
+    std::vector<uint32_t> _stalled;            // Ids of the stalled sockets
+    int                   _epoll_fd;
+    int                   _wake_fd;            // eventfd
+    int                   _cpu;
+    int                   _priority;
+    io_task*              _task;
+    io_task*              _timer_task;
+    pthread_t             _thread;
+    bool                  _running;
+    uint32_t              _stop_requested;     // Atomic
+    uint32_t              _task_requested;     // Atomic
+};
+#endif
+
+//***************************************************************************
+// Inlines
+//***************************************************************************
+io_inbox::io_inbox() :
+    _head(0),
+    _tail(0)
+{
+}
+
+bool io_inbox::empty()
+{
+    return _head == __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+}
+
+void io_inbox::clear()
+{
+    _head = _tail;
+}
+
+}
+#endif
@@ -26,4 +26,18 @@ void message::dump(std::string prefix)
             _port->get_socket()->to_string());
 }
 
+ims_return_code_t message::send_counters(uint32_t* retried_count, uint32_t* dropped_count)
+throw(ims::exception)
+{
+    if (get_direction() != ims_output) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Message " << get_name() << " is not an output message !");
+    }
+
+    socket_ptr socket = _port->get_socket();
+    *retried_count = (socket)? socket->get_retried_count() : 0;
+    *dropped_count = (socket)? socket->get_dropped_count() : 0;
+    return ims_no_error;
+}
+
 }
@@ -38,6 +38,10 @@ protected:
 
     
     virtual void dump(std::string prefix = std::string());
+
+    // Counters of the port socket
+    virtual ims_return_code_t send_counters(uint32_t* retried_count, uint32_t* dropped_count)
+    throw(ims::exception);
 };
 
 //***************************************************************************
@@ -16,6 +16,7 @@
 #ifndef _VISTAS_MESSAGE_BUFFERED_HH_
 #define _VISTAS_MESSAGE_BUFFERED_HH_
 #include "vistas_message.hh"
+#include "vistas_sync.hh"
 
 namespace vistas
 {
@@ -51,6 +52,15 @@ namespace vistas
     inline void     set_data_size(uint32_t size) { _data_size = size; }
     inline uint32_t get_max_size()               { return _max_size;  }
 
+    // Sequence lock of the data, enabled for sampling messages in thread-safe mode.
+    // Ports writing the data in place must do it between write_begin() and write_end().
+    inline seqlock& get_lock()                   { return _lock;      }
+
+    // Size of the data not sent yet, 0 if none.
+    // In thread-safe mode, sent data is tracked with the lock sequence instead
+    // of clearing the size, so a write during a send is never lost.
+    inline uint32_t get_pending_size();
+
     // API implementation
     inline ims_return_code_t get_max_size(uint32_t* max_size)
       throw(ims::exception);
@@ -67,11 +77,16 @@ namespace vistas
 
     // Set new data. 
     // Default implementation just update internal buffer and size
-    // and call port_set_received() function below
+    // and call port_set_received() function below, under the data lock
     inline virtual void port_set_data(const char* data, uint32_t size);
 
+    // Data was written in place, in the buffer returned by get_data().
+    // Update its size and call port_set_received().
+    // The caller holds the data lock.
+    inline void port_set_data_size(uint32_t size);
+
     // Read data and return readed size
-    // Default implementation just copy internal buffer
+    // Default implementation just copy internal buffer, under the data lock,
     // and call port_set_sent() function below
     inline virtual uint32_t port_read_data(char* data, uint32_t max_size);
 
@@ -91,6 +106,8 @@ namespace vistas
     uint32_t  _data_size;  // Size of content
     char*     _init_data;  // a copy of the init value if this message has an init value, else NULL
     uint32_t  _init_size;  // Size of the init value if this message has an init value, else 0
+    seqlock   _lock;       // Protects _data, _data_size and the reception state of derived classes
+    uint32_t  _sent_sequence; // Thread-safe mode: lock sequence of the last data sent
   };
 
 
@@ -114,7 +131,8 @@ namespace vistas
     _max_size(max_size),
     _data_size(0),
     _init_data(NULL),
-    _init_size(0)
+    _init_size(0),
+    _sent_sequence(0)
   {
     memset(_data, 0, max_size);
   }
@@ -138,19 +156,41 @@ namespace vistas
 
   void message_buffered::port_set_data(const char* data, uint32_t size)
   {
+    _lock.write_begin();
     memcpy(_data, data, size);
     _data_size = size;
     port_set_received();
+    _lock.write_end();
+  }
+
+  void message_buffered::port_set_data_size(uint32_t size)
+  {
+    _data_size = size;
+    port_set_received();
   }
 
   uint32_t message_buffered::port_read_data(char* data, uint32_t max_size)
   {
-    uint32_t size = std::min(_data_size, max_size);
-    memcpy(data, _data, size);
+    uint32_t size;
+    uint32_t sequence;
+    do {
+      sequence = _lock.read_begin();
+      size = std::min(_data_size, max_size);
+      memcpy(data, _data, size);
+    } while (_lock.read_retry(sequence));
+    _sent_sequence = sequence;
     port_set_sent();
     return size;
   }
 
+  uint32_t message_buffered::get_pending_size()
+  {
+    if (_lock.is_enabled() && _lock.get_sequence() == _sent_sequence) {
+      return 0;
+    }
+    return _data_size;
+  }
+
   ims_return_code_t message_buffered::get_max_size(uint32_t* max_size) 
     throw(ims::exception)
   {
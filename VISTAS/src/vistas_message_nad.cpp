@@ -38,7 +38,8 @@ message_nad::message_nad(context_weak_ptr context,
     message(context, name, ims_nad, direction, ims_sampling, local_name, bus_name, period_us, port),
     _data(data),
     _size(size),
-    _validity(ims_never_received)
+    _validity(ims_never_received),
+    _generation(0)
 {
     _nad_type = nad_type;
     _nad_dim1 = nad_dim1;
@@ -73,6 +74,39 @@ throw(ims::exception)
     return ims_no_error;
 }
 
+//
+// In place write: the application writes directly in the port fifo.
+// NAD ports are periodic, so there is nothing to queue on commit.
+//
+ims_return_code_t message_nad::acquire_output_buffer(char**    buffer,
+                                                     uint32_t* capacity)
+throw(ims::exception)
+{
+    if (get_direction() == ims_input) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot write to an INPUT message !");
+    }
+
+    *buffer = (char*)_data;
+    *capacity = _size;
+    return ims_no_error;
+}
+
+ims_return_code_t message_nad::commit_output_buffer(uint32_t message_size)
+throw(ims::exception)
+{
+    if (get_direction() == ims_input) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot write to an INPUT message !");
+    }
+
+    if (message_size != _size) {
+        return ims_message_invalid_size;
+    }
+
+    return ims_no_error;
+}
+
 //
 // Read data
 //
@@ -97,6 +131,30 @@ throw(ims::exception)
     return ims_no_error;
 }
 
+//
+// Read data without copy: the view points to the port fifo
+//
+ims_return_code_t message_nad::read_nad_view(ims_message_view_t* view)
+throw(ims::exception)
+{
+    if (get_direction() == ims_output) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot read from an OUTPUT message !");
+    }
+
+    if (_validity == ims_valid) {
+        view->data = (const char*)_data;
+        view->size = _size;
+    } else {
+        view->data = NULL;
+        view->size = 0;
+    }
+
+    view->validity = _validity;
+    view->generation = _generation;
+    return ims_no_error;
+}
+
 //
 // Reset this message
 //
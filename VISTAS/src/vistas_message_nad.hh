@@ -55,6 +55,16 @@ public:
                                        ims_validity_t* message_validity)
     throw(ims::exception);
 
+    virtual ims_return_code_t read_nad_view(ims_message_view_t* view)
+    throw(ims::exception);
+
+    virtual ims_return_code_t acquire_output_buffer(char**    buffer,
+                                                    uint32_t* capacity)
+    throw(ims::exception);
+
+    virtual ims_return_code_t commit_output_buffer(uint32_t message_size)
+    throw(ims::exception);
+
     inline virtual uint32_t get_data(char       *data,
                                      uint32_t   max_size,
                                      uint32_t   queue_index = 0)
@@ -79,6 +89,7 @@ private:
     uint8_t*       _data;
     uint32_t       _size;
     ims_validity_t _validity;
+    uint32_t       _generation;     // Number of data received, for views
 };
 
 //***************************************************************************
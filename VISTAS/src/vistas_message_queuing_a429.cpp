@@ -61,12 +61,12 @@ throw(ims::exception)
     }
 
     if (message_size % 4 != 0) {
-        THROW_IMS_ERROR(ims_message_invalid_size, "An A429 queuing should have a size multiple of 4.");
+        RETURN_IMS_ERROR(ims_message_invalid_size, "An A429 queuing should have a size multiple of 4.");
     }
 
     if (_data_size + message_size > _depth * 4) {
-        THROW_IMS_ERROR(ims_message_queue_full,
-                        "Not enough space in internal buffer of A429 " << get_name() << "! (max : " << _depth << " labels)");
+        RETURN_IMS_ERROR(ims_message_queue_full,
+                         "Not enough space in internal buffer of A429 " << get_name() << "! (max : " << _depth << " labels)");
     }
 
     if (message_size % 4 != 0) {
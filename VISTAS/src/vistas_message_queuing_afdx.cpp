@@ -52,7 +52,9 @@ throw(ims::exception)
                         "Cannot push to an INPUT message !");
     }
 
-    static_cast<port_afdx_queuing*>(_port)->push(message_addr, message_size);
+    ims_return_code_t result = static_cast<port_afdx_queuing*>(_port)->push(message_addr, message_size);
+    if (result != ims_no_error) return result;
+
     _context->get_output_queue()->push(_port);
     return ims_no_error;
 }
@@ -40,8 +40,13 @@ message_sampling::message_sampling(context_weak_ptr context,
     message_buffered(context, name, protocol, direction, ims_sampling, size, local_name, bus_name, period_us, port),
     _validity_duration_us(validity_duration_us),
     _data_time_us(INVALID_DATE),
-    _expected_size(expected_size)
+    _expected_size(expected_size),
+    _generation(0),
+    _acquired(0)
 {
+    if (context->is_thread_safe()) {
+        _lock.enable();
+    }
 }
 
 //
@@ -72,13 +77,104 @@ throw(ims::exception)
         result = ims_message_invalid_size;
     }
 
+    _lock.write_begin();
     memcpy(_data, message_addr, message_size);
     _data_size = message_size;
+    _lock.write_end();
     
     _context->get_output_queue()->push(_port);
     return result;
 }
 
+//
+// In place write: the application writes directly in the internal buffer
+//
+ims_return_code_t message_sampling::acquire_output_buffer(char**    buffer,
+                                                          uint32_t* capacity)
+throw(ims::exception)
+{
+    if (get_direction() == ims_input) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot write to an INPUT message !");
+    }
+
+    if (get_mode() == ims_queuing) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot write to a QUEUING message ! Use push() method instead.");
+    }
+
+    // In thread-safe mode, the application writes in a private copy of the data:
+    // readers and the sending thread are not held until the commit.
+    if (_lock.is_enabled()) {
+        uint32_t acquired = 0;
+        if (__atomic_compare_exchange_n(&_acquired, &acquired, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) == false) {
+            RETURN_IMS_ERROR(ims_implementation_specific_error,
+                             "The output buffer of message " << get_name() << " is already acquired!");
+        }
+
+        if (_staging.empty()) {
+            _staging.resize(_max_size);
+        }
+
+        uint32_t sequence;
+        do {
+            sequence = _lock.read_begin();
+            memcpy(&_staging[0], _data, _max_size);
+        } while (_lock.read_retry(sequence));
+
+        *buffer = &_staging[0];
+    } else {
+        *buffer = _data;
+    }
+
+    *capacity = _max_size;
+    return ims_no_error;
+}
+
+ims_return_code_t message_sampling::commit_output_buffer(uint32_t message_size)
+throw(ims::exception)
+{
+    LOG_DEBUG("Commit " << message_size << " bytes on sampling message " << get_name());
+
+    if (get_direction() == ims_input) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot write to an INPUT message !");
+    }
+
+    if (get_mode() == ims_queuing) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot write to a QUEUING message ! Use push() method instead.");
+    }
+
+    ims_return_code_t result = ims_no_error;
+    if (message_size > _max_size) {
+        result = ims_message_invalid_size;
+        message_size = _max_size;
+    }
+    if (message_size < _max_size) {
+        result = ims_message_invalid_size;
+    }
+
+    if (_lock.is_enabled()) {
+        if (__atomic_load_n(&_acquired, __ATOMIC_RELAXED) == 0) {
+            RETURN_IMS_ERROR(ims_invalid_configuration,
+                             "The output buffer of message " << get_name() << " has not been acquired!");
+        }
+
+        _lock.write_begin();
+        memcpy(_data, &_staging[0], message_size);
+        _data_size = message_size;
+        _lock.write_end();
+
+        __atomic_store_n(&_acquired, 0, __ATOMIC_RELEASE);
+    } else {
+        _data_size = message_size;
+    }
+
+    _context->get_output_queue()->push(_port);
+    return result;
+}
+
 //
 // Read data
 //
@@ -99,7 +195,18 @@ throw(ims::exception)
                         "Cannot read from a QUEUING message ! Use pop() method instead.");
     }
 
-    if (_data_size == 0) {
+    uint32_t data_size;
+    uint32_t sequence;
+    do {
+        sequence = _lock.read_begin();
+        data_size = _data_size;
+        if (data_size != 0) {
+            memcpy(message_addr, _data, data_size);
+            *message_validity = get_validity();
+        }
+    } while (_lock.read_retry(sequence));
+
+    if (data_size == 0) {
         *message_size = _init_size;
         if (_init_data != NULL)
         {
@@ -113,20 +220,48 @@ throw(ims::exception)
         return ims_no_error;
     }
 
-    memcpy(message_addr, _data, _data_size);
-    *message_size = _data_size;
+    *message_size = data_size;
 
-    if (_validity_duration_us == 0 ||
-            (_data_time_us != INVALID_DATE &&
-             _context->get_time_us() - _data_time_us < _validity_duration_us)) {
-        *message_validity = ims_valid;
+    LOG_DEBUG("Message size: " << data_size << " validity: " << (*message_validity == ims_valid));
+
+    if (data_size != _max_size) {
+        return ims_message_invalid_size;
     } else {
-        *message_validity = ims_invalid;
+        return ims_no_error;
     }
+}
 
-    LOG_DEBUG("Message size: " << _data_size << " validity: " << (*message_validity == ims_valid));
+//
+// Read data without copy: the view points to the internal buffer
+//
+ims_return_code_t message_sampling::read_sampling_view(ims_message_view_t* view)
+throw(ims::exception)
+{
+    if (get_direction() == ims_output) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot read from an OUTPUT message !");
+    }
+
+    uint32_t data_size;
+    uint32_t sequence;
+    do {
+        sequence = _lock.read_begin();
+        data_size = _data_size;
+        view->generation = _generation;
+        view->validity = get_validity();
+    } while (_lock.read_retry(sequence));
+
+    if (data_size == 0) {
+        view->data = _init_data;
+        view->size = _init_size;
+        view->validity = (_init_data != NULL)? ims_never_received_but_initialized : ims_never_received;
+        return ims_no_error;
+    }
 
-    if (_data_size != _max_size) {
+    view->data = _data;
+    view->size = data_size;
+
+    if (data_size != _max_size) {
         return ims_message_invalid_size;
     } else {
         return ims_no_error;
@@ -136,6 +271,17 @@ throw(ims::exception)
 //
 // Time/validity handling
 //
+ims_validity_t message_sampling::get_validity()
+{
+    if (_validity_duration_us == 0 ||
+            (_data_time_us != INVALID_DATE &&
+             _context->get_time_us() - _data_time_us < _validity_duration_us)) {
+        return ims_valid;
+    } else {
+        return ims_invalid;
+    }
+}
+
 ims_return_code_t message_sampling::set_validity_duration(uint32_t validity_duration_us)
 throw(ims::exception)
 {
@@ -156,9 +302,11 @@ throw(ims::exception)
 ims_return_code_t message_sampling::reset()
 throw(ims::exception)
 {
+    _lock.write_begin();
     memset(_data, 0, _max_size);
     _data_size = 0;
     _data_time_us = INVALID_DATE;
+    _lock.write_end();
     return ims_no_error;
 }
 
@@ -168,7 +316,9 @@ throw(ims::exception)
 ims_return_code_t message_sampling::invalidate()
 throw(ims::exception)
 {
+    _lock.write_begin();
     _data_time_us = INVALID_DATE;
+    _lock.write_end();
     return ims_no_error;
 }
 
@@ -220,11 +370,15 @@ bool message_sampling::check(ims_protocol_t   protocol,
 void message_sampling::port_set_received()
 {
     _data_time_us = _context->get_time_us();
+    _generation++;
 }
 
 void message_sampling::port_set_sent()
 {
-    _data_size = 0;
+    // In thread-safe mode, the application may already have written new data
+    if (!_lock.is_enabled()) {
+        _data_size = 0;
+    }
 }
 
 }
@@ -16,6 +16,7 @@
 #ifndef _VISTAS_MESSAGE_SAMPLING_HH_
 #define _VISTAS_MESSAGE_SAMPLING_HH_
 #include "vistas_message_buffered.hh"
+#include <vector>
 
 namespace vistas
 {
@@ -49,6 +50,16 @@ public:
                                             ims_validity_t* message_validity)
     throw(ims::exception);
 
+    virtual ims_return_code_t read_sampling_view(ims_message_view_t* view)
+    throw(ims::exception);
+
+    virtual ims_return_code_t acquire_output_buffer(char**    buffer,
+                                                    uint32_t* capacity)
+    throw(ims::exception);
+
+    virtual ims_return_code_t commit_output_buffer(uint32_t message_size)
+    throw(ims::exception);
+
     virtual ims_return_code_t set_validity_duration(uint32_t validity_duration_us)
     throw(ims::exception);
 
@@ -71,9 +82,15 @@ public:
     void port_set_sent();
 
 private:
-    uint32_t        _validity_duration_us; // Data validity duration
-    uint64_t        _data_time_us;         // Last data receive date (valid only if _data_size > 0)
-    uint32_t        _expected_size;        // Size expected from "ims_get_message" / "check"
+    // Validity of the received data (_data_size > 0)
+    ims_validity_t get_validity();
+
+    uint32_t          _validity_duration_us; // Data validity duration
+    uint64_t          _data_time_us;         // Last data receive date (valid only if _data_size > 0)
+    uint32_t          _expected_size;        // Size expected from "ims_get_message" / "check"
+    uint32_t          _generation;           // Number of data received, for views
+    uint32_t          _acquired;             // Output buffer acquired and not committed yet
+    std::vector<char> _staging;              // Output buffer given to the application in thread-safe mode
 };
 
 }
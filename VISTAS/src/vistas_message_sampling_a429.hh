@@ -68,7 +68,12 @@ namespace vistas
 
   uint32_t message_sampling_a429::port_read_data(char* data, __attribute__((__unused__)) uint32_t max_size)
   {
-    memcpy(data, _data, 4);
+    uint32_t sequence;
+    do {
+      sequence = _lock.read_begin();
+      memcpy(data, _data, 4);
+    } while (_lock.read_retry(sequence));
+    _sent_sequence = sequence;
     update_label((uint8_t*)data, number, sdi);      
     port_set_sent();
     return 4;
@@ -62,6 +62,12 @@ namespace vistas
     return _original->read_sampling(message_addr, message_size, message_validity);
   }
 
+  ims_return_code_t message_wrapper::read_sampling_view(ims_message_view_t* view)
+    throw(ims::exception)
+  {
+    return _original->read_sampling_view(view);
+  }
+
   ims_return_code_t message_wrapper::push_queuing(const char* message_addr, 
                                          uint32_t    message_size)
     throw(ims::exception)
@@ -92,6 +98,31 @@ namespace vistas
     return _original->read_nad(message_addr, message_size, message_validity);
   }
 
+  ims_return_code_t message_wrapper::read_nad_view(ims_message_view_t* view)
+    throw(ims::exception)
+  {
+    return _original->read_nad_view(view);
+  }
+
+  ims_return_code_t message_wrapper::release_view(ims_message_view_t* view)
+    throw(ims::exception)
+  {
+    return _original->release_view(view);
+  }
+
+  ims_return_code_t message_wrapper::acquire_output_buffer(char**    buffer,
+                                                           uint32_t* capacity)
+    throw(ims::exception)
+  {
+    return _original->acquire_output_buffer(buffer, capacity);
+  }
+
+  ims_return_code_t message_wrapper::commit_output_buffer(uint32_t message_size)
+    throw(ims::exception)
+  {
+    return _original->commit_output_buffer(message_size);
+  }
+
 
   ims_return_code_t message_wrapper::get_max_size(uint32_t* max_size)
     throw(ims::exception)
@@ -139,4 +170,10 @@ namespace vistas
     return _original->get_depth(depth);
   }
 
+  ims_return_code_t message_wrapper::send_counters(uint32_t* retried_count, uint32_t* dropped_count)
+    throw(ims::exception)
+  {
+    return _original->send_counters(retried_count, dropped_count);
+  }
+
 }
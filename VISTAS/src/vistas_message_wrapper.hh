@@ -56,6 +56,9 @@ namespace vistas
                                             ims_validity_t* message_validity)
       throw(ims::exception);
 
+    virtual ims_return_code_t read_sampling_view(ims_message_view_t* view)
+      throw(ims::exception);
+
     virtual ims_return_code_t push_queuing(const char* message_addr, 
                                            uint32_t    message_size)
       throw(ims::exception);
@@ -74,6 +77,19 @@ namespace vistas
                                        ims_validity_t* message_validity)
       throw(ims::exception);
 
+    virtual ims_return_code_t read_nad_view(ims_message_view_t* view)
+      throw(ims::exception);
+
+    virtual ims_return_code_t release_view(ims_message_view_t* view)
+      throw(ims::exception);
+
+    virtual ims_return_code_t acquire_output_buffer(char**    buffer,
+                                                    uint32_t* capacity)
+      throw(ims::exception);
+
+    virtual ims_return_code_t commit_output_buffer(uint32_t message_size)
+      throw(ims::exception);
+
 
     virtual ims_return_code_t get_max_size(uint32_t* max_size)
       throw(ims::exception);
@@ -100,6 +116,9 @@ namespace vistas
     virtual ims_return_code_t get_depth(uint32_t* depth)
       throw(ims::exception);
 
+    virtual ims_return_code_t send_counters(uint32_t* retried_count, uint32_t* dropped_count)
+      throw(ims::exception);
+
   protected:
     ims::message_ptr _original;
 
@@ -15,52 +15,180 @@
  */
 #include "vistas_output_queue.hh"
 #include "vistas_port.hh"
+#include <algorithm>
 
 
 namespace vistas
 {
 
+output_queue::output_queue() :
+    _concurrent(false)
+{
+    for (uint32_t lane = 0; lane < VISTAS_PRIORITY_COUNT; lane++) {
+        _first_port[lane] = NULL;
+        _last_port[lane] = NULL;
+    }
+}
+
 // Add a port to the queue
 // (We use a weak ptr to prevent shared ptr cycles)
 void output_queue::push(port_weak_ptr port)
 {
-    
-    if (port->_next_queued_port || _last_port == port) {
+    if (_concurrent) {
+        push_concurrent(port);
+        return;
+    }
+
+    uint32_t lane = port->_priority;
+
+    if (port->_next_queued_port || _last_port[lane] == port) {
         // Port already in the queue
         return;
     }
 
-    if (_first_port != NULL) {
-        if (_last_port == NULL) {
+    if (_first_port[lane] != NULL) {
+        if (_last_port[lane] == NULL) {
             THROW_IMS_ERROR(ims_implementation_specific_error,
                             "Cannot prepare this port ! (internal error).");
         }
-        _last_port->_next_queued_port = port;
+        _last_port[lane]->_next_queued_port = port;
     } else {
-        _first_port = port;
+        _first_port[lane] = port;
     }
 
     port->_next_queued_port = NULL;
-    _last_port = port;
+    _last_port[lane] = port;
 }
 
 //
-// Call send() on all queued ports.
+// Call send() on all queued ports, highest priority first.
 // Remove all ports from the queue.
+// A failing port doesn't prevent the next ones from being sent: the first
+// error is thrown once the queue is empty (it is already logged).
 //
 ims_return_code_t output_queue::send_all()
 {
-    port_weak_ptr current_port;
-    while (_first_port) {
-        current_port = _first_port;
-        _first_port = _first_port->_next_queued_port;
+    if (_concurrent) {
+        send_all_concurrent();
+        return ims_no_error;
+    }
+
+    ims_return_code_t error = ims_no_error;
 
-        current_port->send();
-        current_port->_next_queued_port = NULL;
+    for (int32_t lane = VISTAS_PRIORITY_COUNT - 1; lane >= 0; lane--) {
+        port_weak_ptr current_port;
+        while (_first_port[lane]) {
+            current_port = _first_port[lane];
+            _first_port[lane] = _first_port[lane]->_next_queued_port;
+            current_port->_next_queued_port = NULL;
+
+            try {
+                current_port->send();
+            } catch (ims::exception& e) {
+                if (error == ims_no_error) error = e.get_ims_return_code();
+            }
+        }
+        _last_port[lane] = NULL;
     }
-    _last_port = NULL;
 
+    if (error != ims_no_error) {
+        throw ims::exception(error);
+    }
     return ims_no_error;
 }
 
+//
+// Move all queued ports in the vector, highest priority first, then in push order
+//
+void output_queue::take_all(std::vector<port_weak_ptr>& ports)
+{
+    for (int32_t lane = VISTAS_PRIORITY_COUNT - 1; lane >= 0; lane--) {
+        port_weak_ptr current_port;
+        if (_concurrent) {
+            current_port = take_lane_concurrent(lane);
+        } else {
+            current_port = _first_port[lane];
+            _first_port[lane] = NULL;
+            _last_port[lane] = NULL;
+        }
+
+        while (current_port) {
+            port_weak_ptr next_port = current_port->_next_queued_port;
+            current_port->_next_queued_port = NULL;
+            __atomic_store_n(&current_port->_queued, 0, __ATOMIC_RELEASE);
+            ports.push_back(current_port);
+            current_port = next_port;
+        }
+    }
+}
+
+//
+// Lock-free push (multiple producers).
+// The queued flag makes sure a port is only once in the stack.
+//
+void output_queue::push_concurrent(port_weak_ptr port)
+{
+    if (__atomic_exchange_n(&port->_queued, 1, __ATOMIC_ACQ_REL) != 0) {
+        // Port already in the queue
+        return;
+    }
+
+    port_weak_ptr* first_port = &_first_port[port->_priority];
+    port_weak_ptr head = __atomic_load_n(first_port, __ATOMIC_RELAXED);
+    do {
+        port->_next_queued_port = head;
+    } while (!__atomic_compare_exchange_n(first_port, &head, port, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+//
+// Take the whole stack of a lane (single consumer), and reverse it to get
+// the push order. The ports stay flagged as queued until they are unlinked.
+//
+port_weak_ptr output_queue::take_lane_concurrent(uint32_t lane)
+{
+    port_weak_ptr stack = __atomic_exchange_n(&_first_port[lane], (port_weak_ptr)NULL, __ATOMIC_ACQUIRE);
+
+    port_weak_ptr ordered = NULL;
+    while (stack) {
+        port_weak_ptr next = stack->_next_queued_port;
+        stack->_next_queued_port = ordered;
+        ordered = stack;
+        stack = next;
+    }
+    return ordered;
+}
+
+//
+// Send the lanes in turn, highest priority first.
+// The queued flag is cleared before the port is sent: data written during
+// the send queues the port again for the next send_all().
+// Like send_all(), the first error is thrown once all ports are sent.
+//
+void output_queue::send_all_concurrent()
+{
+    ims_return_code_t error = ims_no_error;
+
+    for (int32_t lane = VISTAS_PRIORITY_COUNT - 1; lane >= 0; lane--) {
+        port_weak_ptr ordered = take_lane_concurrent(lane);
+
+        while (ordered) {
+            port_weak_ptr current_port = ordered;
+            ordered = ordered->_next_queued_port;
+            current_port->_next_queued_port = NULL;
+            __atomic_store_n(&current_port->_queued, 0, __ATOMIC_RELEASE);
+
+            try {
+                current_port->send();
+            } catch (ims::exception& e) {
+                if (error == ims_no_error) error = e.get_ims_return_code();
+            }
+        }
+    }
+
+    if (error != ims_no_error) {
+        throw ims::exception(error);
+    }
+}
+
 }
@@ -14,11 +14,15 @@
  * Manage the queue of ports to send.
  * This queue is intrusive: it need a variable in ports class.
  * It is intrusive for better efficency and to prevent malloc on each push.
+ * There is one lane per port priority: the highest one is sent first, then
+ * each lane in push order.
  */
 #ifndef _VISTAS_OUTPUT_QUEUE_HH_
 #define _VISTAS_OUTPUT_QUEUE_HH_
 #include "ims.h"
 #include "shared_ptr.hh"
+#include "vistas_socket_address.hh"
+#include <vector>
 
 namespace vistas
 {
@@ -33,18 +37,37 @@ typedef shared_ptr<output_queue> output_queue_ptr;
 class output_queue
 {
 public:
+    output_queue();
+
+    // Allow push() from several threads, while send_all() is called by one thread.
+    // Must be set before the first push.
+    inline void set_concurrent(bool concurrent) { _concurrent = concurrent; }
 
     // Add a port to the queue
     // (We use a weak ptr to prevent shared ptr cycles)
     void push(port_weak_ptr port);
 
-    // Call send() on all queued ports.
+    // Call send() on all queued ports, by decreasing priority.
     // Remove all ports from the queue.
+    // The first error is thrown once all ports are sent.
     ims_return_code_t send_all();
 
+    // Move all queued ports at the end of the vector, in send order, without sending them.
+    // Remove all ports from the queue.
+    void take_all(std::vector<port_weak_ptr>& ports);
+
 private:
-    port_weak_ptr _first_port;
-    port_weak_ptr _last_port;
+    // Concurrent versions: ports are pushed on a lock-free stack per lane,
+    // which send_all() takes at once and reverses to keep the push order.
+    void push_concurrent(port_weak_ptr port);
+    void send_all_concurrent();
+
+    // Take the stack of a lane, in push order
+    port_weak_ptr take_lane_concurrent(uint32_t lane);
+
+    port_weak_ptr _first_port[VISTAS_PRIORITY_COUNT];   // Head of the stack in concurrent mode
+    port_weak_ptr _last_port[VISTAS_PRIORITY_COUNT];
+    bool          _concurrent;
 };
 }
 
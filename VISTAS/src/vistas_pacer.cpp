@@ -0,0 +1,253 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// AFDX-like traffic shaping of the outputs (Linux only).
+//
+#include "vistas_pacer.hh"
+
+#ifdef VISTAS_HAVE_PACER
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <time.h>
+
+// Delay before sending again to a full socket buffer, in us
+#define PACER_RETRY_US 100
+
+namespace vistas
+{
+
+pacer::pacer(uint32_t max_frame_rate)
+throw(ims::exception) :
+    _max_frame_rate(max_frame_rate),
+    _frame_gap_us((max_frame_rate != 0)? 1000000 / max_frame_rate : 0),
+    _next_frame_us(0),
+    _stop_requested(false)
+{
+    // Deadlines are monotonic: the wall clock may be stepped
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+    pthread_mutex_init(&_mutex, NULL);
+
+    int res = pthread_create(&_thread, NULL, thread_main, this);
+    if (res != 0) {
+        pthread_cond_destroy(&_cond);
+        pthread_mutex_destroy(&_mutex);
+        THROW_IMS_ERROR(ims_implementation_specific_error, "Cannot create the pacing thread! error: " << strerror(res));
+    }
+}
+
+pacer::~pacer()
+{
+    pthread_mutex_lock(&_mutex);
+    _stop_requested = true;
+    pthread_cond_signal(&_cond);
+    pthread_mutex_unlock(&_mutex);
+    pthread_join(_thread, NULL);
+
+    // The datagrams still waiting are sent at once rather than lost
+    for (uint32_t ilink = 0; ilink < _links.size(); ilink++) {
+        link_t* link = _links[ilink];
+        if (link->source != NULL) {
+            while (link->count > 0) {
+                if (send(*link, 0) == false) {
+                    __atomic_add_fetch(&link->source->_dropped_count, link->count, __ATOMIC_RELAXED);
+                    break;
+                }
+            }
+            link->source->set_pacer(NULL, 0);
+        }
+        delete link;
+    }
+
+    pthread_cond_destroy(&_cond);
+    pthread_mutex_destroy(&_mutex);
+}
+
+//
+// Give the socket its own link, reusing the one of a removed socket if any
+//
+void pacer::add(socket* socket, uint32_t bag_us)
+{
+    pthread_mutex_lock(&_mutex);
+    uint32_t id;
+    if (_free_ids.empty() == false) {
+        id = _free_ids.back();
+        _free_ids.pop_back();
+    } else {
+        id = _links.size();
+        _links.push_back(new link_t());
+        _links[id]->datagrams.resize(PACER_DEPTH);
+    }
+
+    link_t* link = _links[id];
+    link->source = socket;
+    link->bag_us = bag_us;
+    link->next_us = 0;
+    link->first = 0;
+    link->count = 0;
+    socket->set_pacer(this, id);
+    pthread_mutex_unlock(&_mutex);
+}
+
+//
+// The link stays, empty, until a new socket takes it: ids don't change
+//
+void pacer::remove(socket* socket)
+{
+    pthread_mutex_lock(&_mutex);
+    link_t* link = _links[socket->_pacer_id];
+    link->source = NULL;
+    link->count = 0;
+    _free_ids.push_back(socket->_pacer_id);
+    pthread_mutex_unlock(&_mutex);
+
+    socket->set_pacer(NULL, 0);
+}
+
+//
+// Queue a datagram, dropping the oldest one if needed
+//
+void pacer::push(socket* socket, IMS_SOCKET fd, const struct sockaddr_in& saddr,
+                 const char* header, uint32_t header_size,
+                 const char* payload, uint32_t payload_size)
+{
+    pthread_mutex_lock(&_mutex);
+    link_t& link = *_links[socket->_pacer_id];
+
+    if (link.count == PACER_DEPTH) {
+        link.first = (link.first + 1) % PACER_DEPTH;
+        link.count--;
+        __atomic_add_fetch(&socket->_dropped_count, 1, __ATOMIC_RELAXED);
+    }
+
+    datagram_t& datagram = link.datagrams[(link.first + link.count) % PACER_DEPTH];
+    datagram.fd = fd;
+    datagram.saddr = saddr;
+    datagram.data.assign(header, header + header_size);
+    if (payload != NULL) {
+        datagram.data.insert(datagram.data.end(), payload, payload + payload_size);
+    }
+
+    // The thread only waits for the links which have datagrams
+    if (link.count++ == 0) {
+        pthread_cond_signal(&_cond);
+    }
+    pthread_mutex_unlock(&_mutex);
+}
+
+void* pacer::thread_main(void* self)
+{
+    // Wake up on time rather than with the default 50us slack
+    prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+
+    ((pacer*)self)->run();
+    return NULL;
+}
+
+//
+// Send the datagram due first, or wait for it. Overdue links are served in
+// turn, starting after the last one served.
+//
+void pacer::run()
+{
+    uint32_t next_link = 0;
+
+    pthread_mutex_lock(&_mutex);
+    while (_stop_requested == false) {
+        uint64_t now = now_us();
+
+        link_t*  due = NULL;
+        uint64_t due_us = 0;
+        for (uint32_t iscan = 0; iscan < _links.size(); iscan++) {
+            uint32_t ilink = (next_link + iscan) % _links.size();
+            link_t* link = _links[ilink];
+            if (link->count == 0) continue;
+
+            uint64_t link_us = std::max(link->next_us, now);
+            if (due == NULL || link_us < due_us) {
+                due = link;
+                due_us = link_us;
+                if (link_us == now) {
+                    next_link = ilink + 1;
+                    break;
+                }
+            }
+        }
+
+        if (due == NULL) {
+            pthread_cond_wait(&_cond, &_mutex);
+            continue;
+        }
+
+        due_us = std::max(due_us, _next_frame_us);
+        if (due_us > now) {
+            struct timespec deadline;
+            deadline.tv_sec = due_us / 1000000;
+            deadline.tv_nsec = (due_us % 1000000) * 1000;
+            pthread_cond_timedwait(&_cond, &_mutex, &deadline);
+            continue;
+        }
+
+        send(*due, now);
+    }
+    pthread_mutex_unlock(&_mutex);
+}
+
+//
+// Send the first datagram of the link. Its socket doesn't block: when the
+// buffer is full, it is sent again a bit later.
+//
+bool pacer::send(link_t& link, uint64_t now)
+{
+    datagram_t& datagram = link.datagrams[link.first];
+
+    int32_t sent_size = sendto(datagram.fd,
+                               datagram.data.empty()? NULL : &datagram.data[0], datagram.data.size(), 0,
+                               (const struct sockaddr*)&datagram.saddr, sizeof(struct sockaddr_in));
+    if (sent_size < 0 && errno == EINTR) return true;
+
+    if (sent_size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)) {
+        link.next_us = now + PACER_RETRY_US;
+        __atomic_add_fetch(&link.source->_retried_count, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    if (sent_size < 0 || (uint32_t)sent_size != datagram.data.size()) {
+        LOG_ERROR_RATE_LIMITED(link.source->to_string() << ": Failed to write to socket! errno:" << socket::getlasterror());
+    }
+
+    link.first = (link.first + 1) % PACER_DEPTH;
+    link.count--;
+
+    // The gaps start once the datagram is out: a late send doesn't shorten the next gap
+    uint64_t sent_us = now_us();
+    link.next_us = sent_us + link.bag_us;
+    _next_frame_us = sent_us + _frame_gap_us;
+    return true;
+}
+
+uint64_t pacer::now_us()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+}
+#endif
@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// AFDX-like traffic shaping of the outputs (Linux only).
+// Each paced output socket is a virtual link: its datagrams are copied in
+// its queue by send_all, and a timer-driven thread sends them, in order, at
+// most one per bandwidth allocation gap (BAG). A max frame rate may also
+// bound the datagrams of all the virtual links together.
+// Bursts are thus spread over the cycle instead of hitting the switch and
+// the consumers socket buffers at once. send_all returns before they are
+// all sent; the ones still waiting when the context is freed are sent at once.
+//
+#ifndef _VISTAS_PACER_HH_
+#define _VISTAS_PACER_HH_
+#include "vistas_socket.hh"
+#include <vector>
+
+#ifdef __linux
+#include <pthread.h>
+#define VISTAS_HAVE_PACER
+#endif
+
+// Datagrams waiting per virtual link. The oldest one is dropped when full.
+#define PACER_DEPTH 256
+
+namespace vistas
+{
+#ifdef VISTAS_HAVE_PACER
+class pacer;
+typedef shared_ptr<pacer> pacer_ptr;
+
+class pacer
+{
+public:
+    // max_frame_rate: datagrams per second of all the virtual links, 0 for no limit
+    pacer(uint32_t max_frame_rate)
+    throw(ims::exception);
+
+    // Stop the thread. The datagrams still waiting are sent at once, or
+    // dropped if the socket buffer is full.
+    ~pacer();
+
+    inline uint32_t get_max_frame_rate() { return _max_frame_rate; }
+
+    // Pace the datagrams of the output socket: at most one every bag_us
+    // (0: only the max frame rate applies). Only before the first push.
+    void add(socket* socket, uint32_t bag_us);
+
+    // Forget a socket being destroyed, and its waiting datagrams
+    void remove(socket* socket);
+
+    // Copy a datagram of a paced socket at the end of its queue.
+    // The socket fd is the one it is sent through.
+    void push(socket* socket, IMS_SOCKET fd, const struct sockaddr_in& saddr,
+              const char* header, uint32_t header_size,
+              const char* payload, uint32_t payload_size);
+
+private:
+    struct datagram_t
+    {
+        IMS_SOCKET         fd;
+        struct sockaddr_in saddr;
+        std::vector<char>  data;        // Only grows, so no allocation in steady state
+    };
+
+    struct link_t
+    {
+        inline link_t() : source(NULL), bag_us(0), next_us(0), first(0), count(0) {}
+        socket*                 source;    // NULL once removed, until reused
+        uint32_t                bag_us;
+        uint64_t                next_us;   // Earliest time of the next datagram
+        std::vector<datagram_t> datagrams; // Ring of PACER_DEPTH datagrams
+        uint32_t                first;
+        uint32_t                count;
+    };
+
+    static void* thread_main(void* self);
+    void run();
+
+    // Send the first datagram of the link. Called with the lock held.
+    // @return false if the socket buffer is full: it is retried later
+    bool send(link_t& link, uint64_t now);
+
+    // Monotonic time, in us
+    static uint64_t now_us();
+
+    std::vector<link_t*> _links;        // By socket pacer id
+    std::vector<uint32_t> _free_ids;    // Links of removed sockets, taken again by add()
+    uint32_t             _max_frame_rate;
+    uint32_t             _frame_gap_us; // 0 without max frame rate
+    uint64_t             _next_frame_us;
+    pthread_mutex_t      _mutex;
+    pthread_cond_t       _cond;         // Signaled when a link gets its first datagram
+    pthread_t            _thread;
+    bool                 _stop_requested;
+};
+#endif
+}
+#endif
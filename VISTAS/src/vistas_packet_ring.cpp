@@ -0,0 +1,271 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// AF_PACKET receive ring (TPACKET_V3, Linux only).
+//
+#include "vistas_packet_ring.hh"
+
+#ifdef VISTAS_HAVE_PACKET_RING
+#include <algorithm>
+#include <errno.h>
+#include <ifaddrs.h>
+#include <linux/filter.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Ring geometry
+#define PACKET_RING_BLOCK_SIZE   (256 * 1024)
+#define PACKET_RING_BLOCK_COUNT  16
+#define PACKET_RING_FRAME_SIZE   2048
+
+// Max time a partially filled block waits before being handed to the pool, in ms
+#define PACKET_RING_RETIRE_MS    1
+
+// Max time an import waits for a partially filled block, in ms (the retire
+// timer has the resolution of the kernel tick)
+#define PACKET_RING_SETTLE_MS    20
+#define PACKET_RING_SETTLE_STEP_US 100
+
+namespace vistas
+{
+
+//
+// Return the index of the interface owning the given IP, 0 for all interfaces
+//
+static int interface_index(const std::string& interface_ip)
+throw(ims::exception)
+{
+    if (interface_ip.empty()) return 0;
+
+    in_addr_t ip = inet_addr(interface_ip.c_str());
+    struct ifaddrs* interfaces;
+    if (getifaddrs(&interfaces) != 0) {
+        THROW_IMS_ERROR(ims_init_failure, "Cannot list the network interfaces! errno: " << errno);
+    }
+
+    int index = -1;
+    for (struct ifaddrs* current = interfaces; current != NULL; current = current->ifa_next) {
+        if (current->ifa_addr != NULL && current->ifa_addr->sa_family == AF_INET &&
+            ((struct sockaddr_in*)current->ifa_addr)->sin_addr.s_addr == ip) {
+            index = if_nametoindex(current->ifa_name);
+            break;
+        }
+    }
+    freeifaddrs(interfaces);
+
+    if (index <= 0) {
+        THROW_IMS_ERROR(ims_init_failure, "No network interface has the IP " << interface_ip << "!");
+    }
+    return index;
+}
+
+packet_ring::packet_ring(const std::string& interface_ip)
+throw(ims::exception) :
+    _fd(-1),
+    _ring(NULL),
+    _ring_size(0),
+    _block_size(PACKET_RING_BLOCK_SIZE),
+    _block_count(PACKET_RING_BLOCK_COUNT),
+    _block(0),
+    _loopback_index(if_nametoindex("lo"))
+{
+    int index = interface_index(interface_ip);
+
+    // No protocol yet: nothing is captured before the ring is ready
+    _fd = ::socket(AF_PACKET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (_fd < 0) {
+        THROW_IMS_ERROR(ims_init_failure, "Cannot open a packet socket! errno: " << errno);
+    }
+
+    // Only unfragmented IPv4 UDP frames to a multicast group: the socket
+    // sees all the protocols, since sent frames are only tapped by ETH_P_ALL ones.
+    // Offsets are relative to the IP header (SOCK_DGRAM).
+    struct sock_filter code[] = {
+        BPF_STMT(BPF_LD  | BPF_H   | BPF_ABS, (uint32_t)(SKF_AD_OFF + SKF_AD_PROTOCOL)),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K,   ETH_P_IP, 0, 8),
+        BPF_STMT(BPF_LD  | BPF_B   | BPF_ABS, 9),                 // Protocol
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K,   IPPROTO_UDP, 0, 6),
+        BPF_STMT(BPF_LD  | BPF_H   | BPF_ABS, 6),                 // Flags and fragment offset
+        BPF_JUMP(BPF_JMP | BPF_JSET| BPF_K,   0x3FFF, 4, 0),
+        BPF_STMT(BPF_LD  | BPF_W   | BPF_ABS, 16),                // Destination
+        BPF_STMT(BPF_ALU | BPF_AND | BPF_K,   0xF0000000),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K,   0xE0000000, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K,             0xFFFF),
+        BPF_STMT(BPF_RET | BPF_K,             0),
+    };
+    struct sock_fprog filter;
+    filter.len = sizeof(code) / sizeof(code[0]);
+    filter.filter = code;
+
+    int version = TPACKET_V3;
+    struct tpacket_req3 request;
+    memset(&request, 0, sizeof(request));
+    request.tp_block_size = _block_size;
+    request.tp_block_nr = _block_count;
+    request.tp_frame_size = PACKET_RING_FRAME_SIZE;
+    request.tp_frame_nr = (_block_size * _block_count) / PACKET_RING_FRAME_SIZE;
+    request.tp_retire_blk_tov = PACKET_RING_RETIRE_MS;
+
+    if (setsockopt(_fd, SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) != 0 ||
+        setsockopt(_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0 ||
+        setsockopt(_fd, SOL_PACKET, PACKET_RX_RING, &request, sizeof(request)) != 0) {
+        int error = errno;
+        ::close(_fd);
+        THROW_IMS_ERROR(ims_init_failure, "Cannot set up the packet ring! errno: " << error);
+    }
+
+    _ring_size = (size_t)_block_size * _block_count;
+    void* ring = mmap(NULL, _ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, _fd, 0);
+    if (ring == MAP_FAILED) {
+        ring = mmap(NULL, _ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    }
+    if (ring == MAP_FAILED) {
+        int error = errno;
+        ::close(_fd);
+        THROW_IMS_ERROR(ims_init_failure, "Cannot map the packet ring! errno: " << error);
+    }
+    _ring = (char*)ring;
+
+    struct sockaddr_ll address;
+    memset(&address, 0, sizeof(address));
+    address.sll_family = AF_PACKET;
+    address.sll_protocol = htons(ETH_P_ALL);     // Local multicast sends are only seen this way
+    address.sll_ifindex = index;
+    if (bind(_fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        int error = errno;
+        munmap(_ring, _ring_size);
+        ::close(_fd);
+        THROW_IMS_ERROR(ims_init_failure, "Cannot bind the packet ring! errno: " << error);
+    }
+}
+
+packet_ring::~packet_ring()
+{
+    munmap(_ring, _ring_size);
+    ::close(_fd);
+}
+
+uint64_t packet_ring::make_key(socket_address_ptr address)
+{
+    return make_key(inet_addr(address->get_ip().c_str()), htons(address->get_port()));
+}
+
+void packet_ring::add(socket_multicast_member* member)
+{
+    _members[make_key(member->get_address())] = member;
+}
+
+void packet_ring::remove(socket_multicast_member* member)
+{
+    member_map_t::iterator imember = _members.find(make_key(member->get_address()));
+    if (imember != _members.end() && imember->second == member) {
+        _members.erase(imember);
+    }
+}
+
+//
+// Parse the IPv4 and UDP headers of a frame, and hand its payload to its member
+//
+void packet_ring::dispatch(const char* frame, uint32_t size, std::vector<socket_multicast_member*>& ready)
+{
+    const struct iphdr* ip = (const struct iphdr*)frame;
+    if (size < sizeof(struct iphdr) || ip->version != 4) return;
+
+    uint32_t ip_size = ip->ihl * 4;
+    if (ip_size < sizeof(struct iphdr) || size < ip_size + sizeof(struct udphdr)) return;
+
+    const struct udphdr* udp = (const struct udphdr*)(frame + ip_size);
+    uint32_t udp_size = ntohs(udp->len);
+    if (udp_size < sizeof(struct udphdr) || ip_size + udp_size > size) return;
+
+    // Left to the shared sockets
+    if (udp_size > PACKET_RING_DATAGRAM_MAX) return;
+
+    member_map_t::iterator imember = _members.find(make_key(ip->daddr, udp->dest));
+    if (imember == _members.end()) return;
+
+    struct sockaddr_in from;
+    memset(&from, 0, sizeof(from));
+    from.sin_family = AF_INET;
+    from.sin_addr.s_addr = ip->saddr;
+    from.sin_port = udp->source;
+
+    if (imember->second->deliver((const char*)(udp + 1), udp_size - sizeof(struct udphdr), from)) {
+        ready.push_back(imember->second);
+    }
+}
+
+//
+// Walk the frames of the next retired block
+//
+bool packet_ring::next_block(std::vector<socket_multicast_member*>& ready)
+{
+    struct tpacket_block_desc* block = (struct tpacket_block_desc*)(_ring + (size_t)_block * _block_size);
+    if ((__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0) {
+        return false;
+    }
+
+    struct tpacket3_hdr* frame = (struct tpacket3_hdr*)((char*)block + block->hdr.bh1.offset_to_first_pkt);
+    for (uint32_t iframe = 0; iframe < block->hdr.bh1.num_pkts; iframe++) {
+        const struct sockaddr_ll* link = (const struct sockaddr_ll*)((char*)frame + TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+
+        // On the loopback, a sent frame is also received
+        if (link->sll_pkttype != PACKET_OUTGOING || link->sll_ifindex != _loopback_index) {
+            dispatch((const char*)frame + frame->tp_net, frame->tp_snaplen, ready);
+        }
+
+        frame = (struct tpacket3_hdr*)((char*)frame + frame->tp_next_offset);
+    }
+    return true;
+}
+
+//
+// Blocks are retired in order: only the first one still owned by the kernel
+// may hold frames not readable yet.
+//
+void packet_ring::settle(uint32_t timeout_us)
+{
+    struct tpacket_block_desc* block = NULL;
+    for (uint32_t iblock = 0; iblock < _block_count; iblock++) {
+        block = (struct tpacket_block_desc*)(_ring + (size_t)((_block + iblock) % _block_count) * _block_size);
+        if ((__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0) break;
+        block = NULL;
+    }
+
+    // Ring full, or nothing captured yet (only a hint: frames are read once retired)
+    if (block == NULL || __atomic_load_n(&block->hdr.bh1.num_pkts, __ATOMIC_RELAXED) == 0) return;
+
+    uint32_t waited_us = 0;
+    timeout_us = std::min(timeout_us, (uint32_t)PACKET_RING_SETTLE_MS * 1000);
+    while ((__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0 &&
+           waited_us < timeout_us) {
+        usleep(PACKET_RING_SETTLE_STEP_US);
+        waited_us += PACKET_RING_SETTLE_STEP_US;
+    }
+}
+
+void packet_ring::release_block()
+{
+    struct tpacket_block_desc* block = (struct tpacket_block_desc*)(_ring + (size_t)_block * _block_size);
+    __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+    _block = (_block + 1) % _block_count;
+}
+
+}
+#endif
@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// AF_PACKET receive ring (TPACKET_V3, Linux only, needs CAP_NET_RAW).
+// The kernel copies the IPv4 multicast UDP frames of the interface in a
+// memory-mapped ring. Their headers are parsed here and the payloads handed
+// to the shared multicast members of their (group, port) straight from the
+// ring, without any socket lookup or copy to a socket buffer.
+// Groups are still joined by the shared sockets (@see socket_multicast_shared),
+// which only keep the datagrams too big for the ring.
+// Frames become visible once their block is retired: when it is full, or
+// after PACKET_RING_RETIRE_MS.
+//
+#ifndef _VISTAS_PACKET_RING_HH_
+#define _VISTAS_PACKET_RING_HH_
+#include "vistas_socket_multicast_shared.hh"
+#include <tr1/unordered_map>
+#include <vector>
+
+#ifdef VISTAS_HAVE_SHARED_MULTICAST
+#include <linux/if_packet.h>
+#ifdef TPACKET3_HDRLEN
+#define VISTAS_HAVE_PACKET_RING
+#endif
+#endif
+
+// Biggest datagram read from the ring (UDP header included): bigger ones may
+// be fragmented, the shared sockets get them reassembled.
+#define PACKET_RING_DATAGRAM_MAX 1480
+
+namespace vistas
+{
+#ifdef VISTAS_HAVE_PACKET_RING
+class packet_ring;
+typedef shared_ptr<packet_ring> packet_ring_ptr;
+
+class packet_ring
+{
+public:
+    // Open the ring on the interface of the given IP ("" for all of them)
+    packet_ring(const std::string& interface_ip)
+    throw(ims::exception);
+
+    ~packet_ring();
+
+    // Readable when a block is retired
+    inline int get_fd() { return _fd; }
+
+    // Hand the datagrams of the member (group, port) to it
+    void add(socket_multicast_member* member);
+    void remove(socket_multicast_member* member);
+
+    // Hand the datagrams of the next retired block to their members.
+    // Members which got datagrams are appended to ready.
+    // @return false if no block is retired
+    bool next_block(std::vector<socket_multicast_member*>& ready);
+
+    // Give the block back to the kernel, once its datagrams are read
+    void release_block();
+
+    // Wait up to timeout_us for the block being filled to be retired, if it
+    // holds frames: what was captured before an import is then read by it.
+    // Imports may thus last up to a kernel tick more.
+    void settle(uint32_t timeout_us);
+
+private:
+    // Key of a (group, port), both in network order
+    static inline uint64_t make_key(uint32_t group, uint16_t port) { return ((uint64_t)group << 16) | port; }
+    static uint64_t make_key(socket_address_ptr address);
+
+    // Hand a frame to its member
+    void dispatch(const char* frame, uint32_t size, std::vector<socket_multicast_member*>& ready);
+
+    typedef std::tr1::unordered_map<uint64_t, socket_multicast_member*> member_map_t;
+
+    int          _fd;
+    char*        _ring;
+    size_t       _ring_size;
+    uint32_t     _block_size;
+    uint32_t     _block_count;
+    uint32_t     _block;            // Next block to read
+    int          _loopback_index;   // Frames sent on it are seen twice: skip the outgoing copy
+    member_map_t _members;
+};
+
+#endif
+}
+#endif
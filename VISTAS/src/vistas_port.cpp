@@ -22,6 +22,8 @@ namespace vistas
 port::port(context_weak_ptr context, socket_ptr socket) :
     _context(context),
     _socket(socket),
-    _next_queued_port(NULL)
+    _priority((socket && socket->get_address())? socket->get_address()->get_priority() : 0),
+    _next_queued_port(NULL),
+    _queued(0)
 {}
 }
@@ -17,6 +17,7 @@
 #define _VISTAS_PORT_HH_
 
 #include "vistas_socket.hh"
+#include "vistas_sync.hh"
 
 namespace vistas
 {
@@ -45,17 +46,26 @@ public:
     inline socket_ptr get_socket()            { return _socket;   }
     inline void set_socket(socket_ptr socket) { _socket = socket; }
 
+    // Priority of the socket address the port is created with
+    inline uint32_t get_priority()            { return _priority; }
+
     // Dtor
     virtual ~port() {}
 
 protected:
     context_weak_ptr  _context;
     socket_ptr        _socket;
+    uint32_t          _priority;
 
-    // Intrusive list of queued ports (see output_queue)
+    // Intrusive list of queued ports (see output_queue).
+    // Written by the application threads in thread-safe mode, so it is kept
+    // on its own cache line.
 private:
     friend class output_queue;
+    char          _queue_padding[VISTAS_CACHE_LINE_SIZE];
     port_weak_ptr _next_queued_port;
+    uint32_t      _queued;             // Concurrent mode only: the port is in the queue
+    char          _queue_padding_end[VISTAS_CACHE_LINE_SIZE - sizeof(port_weak_ptr) - sizeof(uint32_t)];
 };
 
 }
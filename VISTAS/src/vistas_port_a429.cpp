@@ -25,7 +25,8 @@ port_a429::port_a429(context_weak_ptr context, socket_ptr socket, std::string bu
     port_application<message_buffered_ptr>(context, socket),
     _bus_name(bus_name),
     _fifo_size(4*fifo_size+VISTAS_HEADER_SIZE),
-    _fifo(new uint8_t[_fifo_size])
+    _fifo(new uint8_t[_fifo_size]),
+    _batch(_fifo_size)
 {
     memset(_fifo, 0, _fifo_size);
 }
@@ -36,13 +37,25 @@ port_a429::~port_a429()
 }
 
 //
-// Receive
+// Receive: drain all pending datagrams
 //
 void port_a429::receive()
 {
-    uint32_t received_size = _socket->receive((char*)_fifo, _fifo_size);
-    
-    for (uint8_t* label = _fifo+VISTAS_HEADER_SIZE; label < _fifo + received_size; label += A429_LABEL_SIZE)
+    uint32_t received;
+    do {
+        received = _batch.receive(_socket);
+        for (uint32_t id = 0; id < received; id++) {
+            receive_datagram((uint8_t*)_batch.data(id), _batch.size(id));
+        }
+    } while (received == _batch.capacity());
+}
+
+//
+// Decode the labels of one datagram
+//
+void port_a429::receive_datagram(uint8_t* datagram, uint32_t size)
+{
+    for (uint8_t* label = datagram+VISTAS_HEADER_SIZE; label < datagram + size; label += A429_LABEL_SIZE)
     {
         message_map_t::iterator isdi_message_map = _message_map.find(a429::label_number_get(label));
         if (isdi_message_map != _message_map.end()) {
@@ -82,7 +95,7 @@ void port_a429::send()
          imessage != _message_list.end();
          imessage++)
     {
-        if ((*imessage)->get_data_size()) {
+        if ((*imessage)->get_pending_size()) {
             uint32_t data_size = (*imessage)->port_read_data((char*)_fifo + send_size, _fifo_size - send_size);
             send_size += data_size;
         }
@@ -19,6 +19,7 @@
 #include "vistas_message_sampling_a429.hh"
 #include "vistas_message_queuing_a429.hh"
 #include "vistas_message_wrapper.hh"
+#include "vistas_datagram_batch.hh"
 
 namespace vistas
 {
@@ -46,6 +47,9 @@ public:
     virtual ims_protocol_t get_protocol() { return ims_a429; }
 
 private:
+    // Decode the labels of one received datagram
+    void receive_datagram(uint8_t* datagram, uint32_t size);
+
     template <ims_mode_t mode>
     inline message_buffered_ptr create_message_a429(std::string          name,
                                                     a429::label_number_t number,
@@ -58,6 +62,7 @@ private:
     std::string _bus_name;
     uint32_t    _fifo_size;
     uint8_t*    _fifo;
+    datagram_batch _batch;
 
     // Map SDI => messages
     typedef std::vector<message_buffered_ptr> sdi_message_map_t;
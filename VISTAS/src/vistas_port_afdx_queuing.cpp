@@ -35,15 +35,17 @@ port_afdx_queuing::port_afdx_queuing(context_weak_ptr context, socket_ptr socket
 {
     _queue = new queued_message_t[_queue_depth];
     for (uint32_t id = 0; id < _queue_depth; id++) {
-        _queue[id].data = new char[_max_size];
-        memset(_queue[id].data, 0, _max_size);
+        _queue[id].datagram = new char[_fifo_size];
+        _queue[id].data = _queue[id].datagram + VISTAS_HEADER_SIZE;
+        _queue[id].size = 0;
+        memset(_queue[id].datagram, 0, _fifo_size);
     }
 }
 
 port_afdx_queuing::~port_afdx_queuing()
 {
     for (uint32_t id = 0; id < _queue_depth; id++) {
-        delete[] _queue[id].data;
+        delete[] _queue[id].datagram;
     }
     delete[] _queue;
     delete[] _fifo;
@@ -73,37 +75,50 @@ port_afdx_queuing::~port_afdx_queuing()
 }
 
 //
-// Receive
+// Receive: drain all pending datagrams directly in the free queue slots
 //
 void port_afdx_queuing::receive()
 {
-    if (_nb_messages >= _queue_depth) {
-        LOG_WARN("Lost data on AFDX !");
-        char trash;
-        _socket->receive(&trash, 1);
-        return;
-    }
-
-    uint32_t id = (_begin + _nb_messages) % _queue_depth;
-    uint32_t data_size = _socket->receive(_fifo, _fifo_size);
-    if (data_size > VISTAS_HEADER_SIZE)
-    {
-        _queue[id].size = data_size-VISTAS_HEADER_SIZE;
-        memcpy(_queue[id].data, _fifo+VISTAS_HEADER_SIZE, _queue[id].size);
-    }
-    
-    _nb_messages++;
+    socket::datagram datagrams[DATAGRAM_BATCH_SIZE];
+    uint32_t count;
+    uint32_t received;
+
+    do {
+        count = std::min(_queue_depth - _nb_messages, (uint32_t)DATAGRAM_BATCH_SIZE);
+
+        if (count == 0) {
+            uint32_t lost_size;
+            uint32_t lost = _socket->receive_latest(_fifo, _fifo_size, lost_size);
+            if (lost > 0) {
+                LOG_WARN("Lost " << lost << " data on AFDX !");
+            }
+            return;
+        }
+
+        for (uint32_t slot = 0; slot < count; slot++) {
+            uint32_t id = (_begin + _nb_messages + slot) % _queue_depth;
+            datagrams[slot].buffer = _queue[id].datagram;
+            datagrams[slot].buffer_size = _fifo_size;
+        }
+
+        received = _socket->receive_many(datagrams, count);
+
+        for (uint32_t slot = 0; slot < received; slot++) {
+            uint32_t id = (_begin + _nb_messages) % _queue_depth;
+            _queue[id].size = (datagrams[slot].size > VISTAS_HEADER_SIZE)? datagrams[slot].size - VISTAS_HEADER_SIZE : 0;
+            _nb_messages++;
+        }
+    } while (received == count);
 }
 
 //
-// Send
+// Send: the header is built in the fifo, the payload is sent from its slot
 //
 void port_afdx_queuing::send()
 {
     while (_nb_messages > 0) {
         prepare_header(_fifo);
-        memcpy(_fifo+VISTAS_HEADER_SIZE, _queue[_begin].data, _queue[_begin].size);
-        _socket->send(_fifo, _queue[_begin].size + VISTAS_HEADER_SIZE);
+        _socket->send_gather(_fifo, VISTAS_HEADER_SIZE, _queue[_begin].data, _queue[_begin].size);
         _begin = (_begin + 1) % _queue_depth;
         _nb_messages--;
     }
@@ -114,15 +129,14 @@ void port_afdx_queuing::send()
 //
 // Add data to cycle buffer
 //
-void port_afdx_queuing::push(const char* message, uint32_t message_size)
-throw(ims::exception)
+ims_return_code_t port_afdx_queuing::push(const char* message, uint32_t message_size)
 {
     if (message_size > _max_size) {
-        THROW_IMS_ERROR(ims_message_invalid_size, "Message size " << message_size << " is too big !");
+        RETURN_IMS_ERROR(ims_message_invalid_size, "Message size " << message_size << " is too big !");
     }
 
     if (_nb_messages >= _message_queue_depth) {
-        THROW_IMS_ERROR(ims_message_queue_full, "Message queue is full!");
+        RETURN_IMS_ERROR(ims_message_queue_full, "Message queue is full!");
     }
 
     uint32_t id = (_begin + _nb_messages) % _queue_depth;
@@ -130,6 +144,7 @@ throw(ims::exception)
     _queue[id].size = message_size;
 
     _nb_messages++;
+    return ims_no_error;
 }
 
 //
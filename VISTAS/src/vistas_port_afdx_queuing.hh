@@ -17,6 +17,7 @@
 #define _VISTAS_PORT_AFDX_QUEUING_HH_
 #include "vistas_port_application.hh"
 #include "vistas_message_queuing_afdx.hh"
+#include "vistas_datagram_batch.hh"
 
 namespace vistas
 {
@@ -40,9 +41,9 @@ public:
     // Return port protocol
     virtual ims_protocol_t get_protocol() { return ims_afdx; }
 
-    // Add / Remove message. May throw.
-    void push(const char* message, uint32_t message_size)
-    throw(ims::exception);
+    // Add / Remove message.
+    // Push returns ims_message_invalid_size or ims_message_queue_full without throwing.
+    ims_return_code_t push(const char* message, uint32_t message_size);
     uint32_t pop(char* message, uint32_t message_max_size);
 
     uint32_t get_queue_data(char      *data,
@@ -57,6 +58,7 @@ public:
 
 private:
     struct queued_message_t {
+        char*    datagram;  // VISTAS header followed by data, so datagrams are received in place
         char*    data;
         uint32_t size;
     };
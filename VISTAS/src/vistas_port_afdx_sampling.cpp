@@ -53,7 +53,13 @@ ims::message_ptr port_afdx_sampling::get_message(std::string name, uint32_t size
                                                                         period_us,
                                                                         this));
       _message_list.push_back(original_msg);
-      _fifo_size = size + VISTAS_HEADER_SIZE;
+      // Only the header: the payload is read/written in place in the message.
+      // In thread-safe mode the application may write the payload during the
+      // send, so it is copied in the fifo.
+      _fifo_size = VISTAS_HEADER_SIZE;
+      if (_context->is_thread_safe()) {
+          _fifo_size += size;
+      }
       _fifo = new char[_fifo_size];
       return original_msg;
     }
@@ -67,35 +73,45 @@ ims::message_ptr port_afdx_sampling::get_message(std::string name, uint32_t size
 }
 
 //
-// Receive: afdx port is just a forwarder
+// Receive: afdx port is just a forwarder. Only the latest pending datagram is kept.
+// The header is read in the fifo, the payload directly in the message.
 //
 void port_afdx_sampling::receive()
 {
     if (_message_list.empty() == false)
     {
-        uint32_t data_size = _socket->receive(_fifo, _fifo_size);
+        message_sampling_ptr& message = _message_list.front();
+        uint32_t data_size = 0;
+        message->get_lock().write_begin();
+        _socket->receive_latest(_fifo, VISTAS_HEADER_SIZE, message->get_data(), message->get_max_size(), data_size);
 
         if (data_size > VISTAS_HEADER_SIZE)
         {
-            _message_list.front()->port_set_data(_fifo + VISTAS_HEADER_SIZE, data_size - VISTAS_HEADER_SIZE);
+            message->port_set_data_size(data_size - VISTAS_HEADER_SIZE);
         }
+        message->get_lock().write_end();
 
         LOG_DEBUG(_message_list.front()->get_data_size() << " bytes received for AFDX message " << _message_list.front()->get_name());
     }
 }
 
 //
-// Send: afdx port is just a forwarder
+// Send: afdx port is just a forwarder. The payload is sent from the message.
 //
 void port_afdx_sampling::send()
 {
-    if (_message_list.empty() == false && _message_list.front()->get_data_size() > 0) {
-        LOG_DEBUG("Send " << _message_list.front()->get_data_size() << " bytes for AFDX message " << _message_list.front()->get_name());
+    if (_message_list.empty() == false && _message_list.front()->get_pending_size() > 0) {
+        message_sampling_ptr& message = _message_list.front();
+        LOG_DEBUG("Send " << message->get_data_size() << " bytes for AFDX message " << message->get_name());
 
         prepare_header(_fifo);
-        uint32_t data_read = _message_list.front()->port_read_data(_fifo + VISTAS_HEADER_SIZE, _fifo_size - VISTAS_HEADER_SIZE);
-
-        _socket->send(_fifo, data_read + VISTAS_HEADER_SIZE);
+        if (message->get_lock().is_enabled()) {
+            uint32_t data_size = message->port_read_data(_fifo + VISTAS_HEADER_SIZE, _fifo_size - VISTAS_HEADER_SIZE);
+            _socket->send(_fifo, VISTAS_HEADER_SIZE + data_size);
+        } else {
+            _socket->send_gather(_fifo, VISTAS_HEADER_SIZE, message->get_data(), message->get_data_size());
+            message->port_set_sent();
+        }
     }
 }
 }
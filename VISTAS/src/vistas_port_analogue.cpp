@@ -24,11 +24,9 @@ namespace vistas
 // Ctor / Dtor
 //
 port_analogue::port_analogue(context_weak_ptr context, socket_ptr socket, uint32_t fifo_size, uint32_t send_period_us) :
-    port_application<message_analogue_ptr>(context, socket),
+    port_application<message_analogue_ptr>(context, socket, send_period_us),
     _fifo_size(fifo_size+VISTAS_HEADER_SIZE),
-    _fifo(new uint8_t[_fifo_size]),
-    _send_period_us(send_period_us),
-    _send_next_date_us(0)
+    _fifo(new uint8_t[_fifo_size])
 {
     memset(_fifo, 0, _fifo_size);
 }
@@ -89,11 +87,12 @@ ims::message_ptr port_analogue::get_analogue_signal(std::string name,
 }
 
 //
-// Receive
+// Receive: only the latest pending datagram is kept
 //
 void port_analogue::receive()
 {
-    _socket->receive((char*)_fifo, _fifo_size);
+    uint32_t data_size;
+    if (_socket->receive_latest((char*)_fifo, _fifo_size, data_size) == 0) return;
     
     message_map_t::iterator imessage = _message_map.begin();
     while ( imessage != _message_map.end() )
@@ -109,21 +108,24 @@ void port_analogue::receive()
 //
 void port_analogue::send()
 {
-    if (_send_period_us == 0 || _send_next_date_us <= _context->get_time_us()) {
-        prepare_header(_fifo);
-        
-        message_map_t::iterator imessage = _message_map.begin();
-        while ( imessage != _message_map.end() )
-        {
-          imessage->second->port_read_data(&_fifo[VISTAS_HEADER_SIZE + imessage->first]);
-          
-          imessage++;
-        }
-        
-        _socket->send((const char*)_fifo, _fifo_size);
-        if (_send_period_us > 0) {
-            _send_next_date_us = (_context->get_time_us() / (uint64_t)_send_period_us + 1) * (uint64_t)_send_period_us;
-        }
+    send_when_due();
+}
+
+//
+// Build and send the datagram
+//
+void port_analogue::send_now()
+{
+    prepare_header(_fifo);
+    
+    message_map_t::iterator imessage = _message_map.begin();
+    while ( imessage != _message_map.end() )
+    {
+      imessage->second->port_read_data(&_fifo[VISTAS_HEADER_SIZE + imessage->first]);
+      
+      imessage++;
     }
+    
+    _socket->send((const char*)_fifo, _fifo_size);
 }
 }
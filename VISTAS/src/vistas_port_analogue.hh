@@ -43,6 +43,9 @@ public:
     // The port discret will effectivelly send only if time has reach its period.
     void send();
 
+    // Send data to socket, whatever the date
+    virtual void send_now();
+
     // Read data from socket
     void receive();
 
@@ -55,7 +58,7 @@ public:
     // "ims_reset_all" also resets the simulation time, so we must reset our date of next send
     virtual ims_return_code_t reset_messages() throw(ims::exception)
     {
-        _send_next_date_us = 0;
+        clear_send_next_date();
 
         return port_application<message_analogue_ptr>::reset_messages();
     }
@@ -63,8 +66,6 @@ public:
 private:
     uint32_t    _fifo_size;
     uint8_t*    _fifo;
-    uint32_t    _send_period_us;
-    uint64_t    _send_next_date_us;
 
     // Message lookup from offset (same content as _message_list in port_application base class)
     typedef std::tr1::unordered_map<uint32_t, message_analogue_ptr> message_map_t;
@@ -28,8 +28,11 @@ namespace vistas
 {
 const uint32_t port_application_base::VISTAS_HEADER_SIZE = 20;
 
-port_application_base::port_application_base(context_weak_ptr context, socket_ptr socket) :
+port_application_base::port_application_base(context_weak_ptr context, socket_ptr socket, uint32_t send_period_us) :
     port(context, socket),
+    _send_period_us(send_period_us),
+    _send_next_date_us(0),
+    _wheel_entry(this),
     _prod_id(0),
     _seq_num(0),
     _seq_num_enabled(false),
@@ -38,6 +41,29 @@ port_application_base::port_application_base(context_weak_ptr context, socket_pt
 {
 }
 
+//
+// Periodic outputs are sent at most once per period of the context time
+//
+void port_application_base::send_when_due()
+{
+    if (_context->is_time_triggered()) {
+        send_now();
+        return;
+    }
+
+    // A reset or a modification by the application meanwhile clears the date: it is kept
+    uint64_t time_us = _context->get_send_time_us();
+    uint64_t next_date_us = __atomic_load_n(&_send_next_date_us, __ATOMIC_RELAXED);
+    if (_send_period_us == 0 || next_date_us <= time_us) {
+        send_now();
+        if (_send_period_us > 0) {
+            __atomic_compare_exchange_n(&_send_next_date_us, &next_date_us,
+                                        (time_us / (uint64_t)_send_period_us + 1) * (uint64_t)_send_period_us,
+                                        false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        }
+    }
+}
+
 void port_application_base::init_header_flags(uint16_t prod_id, bool seq_num_enabled, bool qos_timestamp_enabled, bool data_timestamp_enabled)
 {
     _prod_id = prod_id;
@@ -88,7 +114,7 @@ void port_application_base::prepare_header(void* buffer)
     
     if (_data_timestamp_enabled)
     {
-        header->data_timestamp = bswap_64(_context->get_time_us());
+        header->data_timestamp = bswap_64(_context->get_send_time_us());
     }
     else
     {
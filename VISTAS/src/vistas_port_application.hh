@@ -16,6 +16,7 @@
 #ifndef _VISTAS_PORT_APPLICATION_HH_
 #define _VISTAS_PORT_APPLICATION_HH_
 #include "vistas_port.hh"
+#include "vistas_timing_wheel.hh"
 #include <vector>
 
 namespace vistas
@@ -27,7 +28,8 @@ typedef shared_ptr<port_application_base> port_application_ptr;
 class port_application_base : public port
 {
 public:
-    port_application_base(context_weak_ptr context, socket_ptr socket);
+    // send_period_us: period of a periodic output, 0 to send it at each send_all
+    port_application_base(context_weak_ptr context, socket_ptr socket, uint32_t send_period_us = 0);
 
     // Reset all messages of this port
     virtual ims_return_code_t reset_messages()
@@ -42,6 +44,14 @@ public:
     
     // Return true if this port is a periodic output one
     virtual bool is_periodic_output() { return false; }
+
+    // Periodic outputs: build and send the datagram, whatever the date
+    virtual void send_now() {}
+    inline uint32_t get_send_period_us() { return _send_period_us; }
+    inline uint64_t get_send_next_date_us() { return __atomic_load_n(&_send_next_date_us, __ATOMIC_RELAXED); }
+
+    // Entry of the port in the timing wheel of its scheduler
+    inline timing_wheel::entry* get_wheel_entry() { return &_wheel_entry; }
     
     // Init header flags, call after constructor
     void init_header_flags(uint16_t prod_id, bool seq_num_enabled, bool qos_timestamp_enabled, bool data_timestamp_enabled);
@@ -58,6 +68,18 @@ protected:
     // call before sending to fill the header
     void prepare_header(void* buffer);
 
+    // Periodic outputs: send when the context time has reached the next date.
+    // In time-triggered mode, the scheduler sends on the period boundaries and
+    // send_all only sends the ports it is given.
+    void send_when_due();
+
+    // Send at the next send_all. Called by the application thread.
+    inline void clear_send_next_date() { __atomic_store_n(&_send_next_date_us, 0, __ATOMIC_RELAXED); }
+
+    uint32_t _send_period_us;
+    uint64_t _send_next_date_us; // Atomic: also written by the application thread
+    timing_wheel::entry _wheel_entry;
+
     uint16_t _prod_id;
     uint16_t _seq_num;
     bool _seq_num_enabled;
@@ -71,7 +93,7 @@ class port_application : public port_application_base
 public:
 
     //Ctor
-    inline port_application(context_weak_ptr context, socket_ptr socket);
+    inline port_application(context_weak_ptr context, socket_ptr socket, uint32_t send_period_us = 0);
 
     // Reset all messages of this port
     virtual ims_return_code_t reset_messages()
@@ -92,8 +114,8 @@ protected:
 // Templates/inlines
 //***************************************************************************
 template <typename message_t>
-port_application<message_t>::port_application(context_weak_ptr context, socket_ptr socket) :
-    port_application_base(context, socket)
+port_application<message_t>::port_application(context_weak_ptr context, socket_ptr socket, uint32_t send_period_us) :
+    port_application_base(context, socket, send_period_us)
 {
 }
 
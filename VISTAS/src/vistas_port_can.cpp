@@ -33,6 +33,7 @@ port_can::port_can(context_weak_ptr context, socket_ptr socket, std::string bus_
     _bus_name(bus_name),
     _fifo_size(fifo_size+VISTAS_HEADER_SIZE),
     _fifo(new char[_fifo_size]),
+    _batch(_fifo_size),
     _total_messages_size(0)
 {
     memset(_fifo, 0, _fifo_size);
@@ -90,21 +91,32 @@ ims::message_ptr port_can::get_message(uint32_t message_id,
 }
 
 //
-// Receive
+// Receive: drain all pending datagrams
+//
+void port_can::receive()
+{
+    uint32_t received;
+    do {
+        received = _batch.receive(_socket);
+        for (uint32_t id = 0; id < received; id++) {
+            receive_datagram(_batch.data(id), _batch.size(id));
+        }
+    } while (received == _batch.capacity());
+}
+
+//
+// Decode the frames of one datagram
 //
 // CAN frame :
 //   - 8 byes for data
 //   - 2 byte for length
 //   - 4 bytes for ID
 //
-void port_can::receive()
+void port_can::receive_datagram(char* datagram, uint32_t size)
 {
-    uint32_t received_size = _socket->receive((char*)_fifo, _fifo_size);
-    
-    
-    char* end = _fifo + received_size;
+    char* end = datagram + size;
 
-    for (char* first = _fifo+VISTAS_HEADER_SIZE; first < end; first += CAN_FRAME_SIZE)
+    for (char* first = datagram+VISTAS_HEADER_SIZE; first < end; first += CAN_FRAME_SIZE)
     {
         if (first + CAN_FRAME_SIZE > end) {
             LOG_ERROR(_bus_name << ": Received payload too small!");
@@ -147,7 +159,7 @@ void port_can::send()
          imessage != _message_list.end();
          imessage++)
     {
-        uint32_t data_size = (*imessage)->get_data_size();
+        uint32_t data_size = (*imessage)->get_pending_size();
         // if CAN is less than 8 bytes, data must be padded with 0
         memset(frame, 0, 8);
         (*imessage)->port_read_data(frame + 8 - data_size, data_size);
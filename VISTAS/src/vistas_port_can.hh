@@ -17,6 +17,7 @@
 #define _VISTAS_PORT_CAN_HH_
 #include "vistas_port_application.hh"
 #include "vistas_message_sampling_can.hh"
+#include "vistas_datagram_batch.hh"
 
 namespace vistas
 {
@@ -43,9 +44,13 @@ public:
     virtual ims_protocol_t get_protocol() { return ims_can; }
 
 private:
+    // Decode the frames of one received datagram
+    void receive_datagram(char* datagram, uint32_t size);
+
     std::string _bus_name;
     uint32_t    _fifo_size;
     char*       _fifo;
+    datagram_batch _batch;
     uint32_t    _total_messages_size;
 
     // Map message id => message (same content as _message_list in port_application base class)
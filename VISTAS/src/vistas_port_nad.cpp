@@ -22,11 +22,9 @@ namespace vistas
 // Ctor / Dtor
 //
 port_nad::port_nad(context_weak_ptr context, socket_ptr socket, uint32_t fifo_size, uint32_t send_period_us) :
-    port_application<message_nad_ptr>(context, socket),
+    port_application<message_nad_ptr>(context, socket, send_period_us),
     _fifo_size(fifo_size+VISTAS_HEADER_SIZE),
-    _fifo(new uint8_t[_fifo_size]),
-    _send_period_us(send_period_us),
-    _send_next_date_us(0)
+    _fifo(new uint8_t[_fifo_size])
 {
     memset(_fifo, 0, _fifo_size);
 }
@@ -86,17 +84,19 @@ ims::message_ptr port_nad::get_nad_message(std::string name,
 }
 
 //
-// Receive
+// Receive: only the latest pending datagram is kept
 //
 void port_nad::receive()
 {
-    _socket->receive((char*)_fifo, _fifo_size);
+    uint32_t data_size;
+    if (_socket->receive_latest((char*)_fifo, _fifo_size, data_size) == 0) return;
 
     for (message_list_t::iterator imessage = _message_list.begin();
          imessage != _message_list.end();
          imessage++)
     {
         (*imessage)->_validity = ims_valid;
+        (*imessage)->_generation++;
     }
 }
 
@@ -105,12 +105,15 @@ void port_nad::receive()
 //
 void port_nad::send()
 {
-    if (_send_period_us == 0 || _send_next_date_us <= _context->get_time_us()) {
-        prepare_header(_fifo);
-        _socket->send((const char*)_fifo, _fifo_size);
-        if (_send_period_us > 0) {
-            _send_next_date_us = (_context->get_time_us() / (uint64_t)_send_period_us + 1) * (uint64_t)_send_period_us;
-        }
-    }
+    send_when_due();
+}
+
+//
+// Build and send the datagram
+//
+void port_nad::send_now()
+{
+    prepare_header(_fifo);
+    _socket->send((const char*)_fifo, _fifo_size);
 }
 }
@@ -0,0 +1,183 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Import of several contexts of the process together.
+//
+#include "vistas_reactor.hh"
+#include "ims_time.hh"
+
+#ifdef __linux
+#include <errno.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+// Max contexts reported by one epoll_wait call. Remaining ones are reported by the next call.
+#define REACTOR_EVENTS_MAX 64
+#endif
+
+namespace vistas
+{
+
+reactor::reactor()
+throw(ims::exception)
+{
+#ifdef __linux
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd < 0) {
+        THROW_IMS_ERROR(ims_init_failure, "Cannot create epoll instance! errno: " << errno);
+    }
+#endif
+}
+
+reactor::~reactor()
+{
+    for (uint32_t imember = 0; imember < _members.size(); imember++) {
+        _members[imember].context->set_reactor(NULL);
+    }
+#ifdef __linux
+    ::close(_epoll_fd);
+#endif
+}
+
+void reactor::attach(backend::context_ptr backend_context)
+throw(ims::exception)
+{
+    context_weak_ptr attached = dynamic_cast<context*>(backend_context.get());
+    if (attached == NULL || !attached->get_socket_pool()) {
+        THROW_IMS_ERROR(ims_invalid_configuration, "Only complete VISTAS contexts can be attached to a reactor!");
+    }
+    if (attached->get_reactor() == this) return;
+    if (attached->get_reactor() != NULL) {
+        THROW_IMS_ERROR(ims_invalid_configuration, "Context " << attached->get_vc_name() <<
+                        " is already attached to another reactor!");
+    }
+
+#ifdef __linux
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u32 = _members.size();
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, attached->get_socket_pool()->get_poll_fd(), &event) != 0) {
+        THROW_IMS_ERROR(ims_implementation_specific_error, "Cannot poll context " << attached->get_vc_name() <<
+                        "! errno: " << errno);
+    }
+#endif
+
+    member added;
+    added.context = attached;
+    added.ready = false;
+    _members.push_back(added);
+    attached->set_reactor(this);
+}
+
+void reactor::detach(backend::context_ptr backend_context)
+throw(ims::exception)
+{
+    context_weak_ptr attached = dynamic_cast<context*>(backend_context.get());
+    if (attached == NULL || attached->get_reactor() != this) {
+        THROW_IMS_ERROR(ims_invalid_configuration, "The context is not attached to this reactor!");
+    }
+    remove(attached);
+}
+
+//
+// The last member takes the place of the removed one
+//
+void reactor::remove(context_weak_ptr removed)
+{
+    for (uint32_t imember = 0; imember < _members.size(); imember++) {
+        if (_members[imember].context != removed) continue;
+
+#ifdef __linux
+        struct epoll_event event;
+        epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, removed->get_socket_pool()->get_poll_fd(), &event);
+
+        if (imember != _members.size() - 1) {
+            event.events = EPOLLIN;
+            event.data.u32 = imember;
+            epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, _members.back().context->get_socket_pool()->get_poll_fd(), &event);
+        }
+#endif
+        _members[imember] = _members.back();
+        _members.pop_back();
+        removed->set_reactor(NULL);
+        return;
+    }
+}
+
+//
+// Same loop as socket_pool::import, over all the pools: each round, the
+// contexts whose poller is ready, or which have unpolled inputs, read once.
+//
+ims_return_code_t reactor::import(uint32_t timeout_us)
+{
+    uint64_t begin = ims_get_real_time();
+
+    for (uint32_t imember = 0; imember < _members.size(); imember++) {
+        _members[imember].context->get_socket_pool()->import_begin(begin, timeout_us);
+    }
+
+    uint32_t nb_events;
+    do
+    {
+        nb_events = 0;
+
+#ifdef __linux
+        // 0 timeout for polling
+        struct epoll_event events[REACTOR_EVENTS_MAX];
+        int nb_ready;
+        do {
+            nb_ready = epoll_wait(_epoll_fd, events, REACTOR_EVENTS_MAX, 0);
+        } while (nb_ready < 0 && errno == EINTR);
+
+        if (nb_ready < 0) {
+            THROW_IMS_ERROR(ims_implementation_specific_error,
+                            "epoll_wait fail! errno: " << errno);
+        }
+
+        for (int ievent = 0; ievent < nb_ready; ievent++) {
+            _members[events[ievent].data.u32].ready = true;
+        }
+#endif
+
+        for (uint32_t imember = 0; imember < _members.size(); imember++) {
+            member& current = _members[imember];
+            socket_pool_ptr pool = current.context->get_socket_pool();
+#ifdef __linux
+            if (current.ready == false && pool->has_unpolled_inputs() == false) continue;
+#endif
+            current.ready = false;
+            nb_events += pool->import_once();
+        }
+
+    } while ((nb_events != 0) &&
+             (ims_get_real_time() - begin < timeout_us));
+
+    for (uint32_t imember = 0; imember < _members.size(); imember++) {
+        _members[imember].context->get_socket_pool()->import_end();
+    }
+
+    return ims_no_error;
+}
+
+}
+
+//
+// backend implementation
+//
+namespace backend
+{
+reactor* create_reactor()
+{
+    return new vistas::reactor();
+}
+}
@@ -0,0 +1,62 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Import of several contexts of the process together.
+// On Linux, the pollers of the socket pools are themselves polled by the
+// reactor: one epoll_wait tells which contexts received something, and only
+// those read their sockets. Elsewhere, every context is imported in turn.
+//
+#ifndef _VISTAS_REACTOR_HH_
+#define _VISTAS_REACTOR_HH_
+#include "vistas_context.hh"
+#include <vector>
+
+namespace vistas
+{
+
+class reactor : public backend::reactor
+{
+public:
+    reactor()
+    throw(ims::exception);
+
+    // Detach the remaining contexts
+    ~reactor();
+
+    // Add/remove a context. A context belongs to one reactor at most.
+    void attach(backend::context_ptr context)
+    throw(ims::exception);
+    void detach(backend::context_ptr context)
+    throw(ims::exception);
+
+    // Remove a context, if attached. Called by the context when it is freed.
+    void remove(context_weak_ptr context);
+
+    // Import incoming data of all the contexts
+    ims_return_code_t import(uint32_t timeout_us);
+
+private:
+    struct member
+    {
+        context_weak_ptr context;
+        bool             ready;        // Its poller reported incoming data
+    };
+
+    std::vector<member> _members;
+#ifdef __linux
+    int                 _epoll_fd;     // Polls the pollers of the socket pools
+#endif
+};
+
+}
+#endif
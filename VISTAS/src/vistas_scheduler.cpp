@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Time-triggered emission of the periodic output ports (Linux only).
+//
+#include "vistas_scheduler.hh"
+
+#ifdef VISTAS_HAVE_SCHEDULER
+#include <errno.h>
+#include <string.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace vistas
+{
+
+scheduler::scheduler(send_batch_ptr batch)
+throw(ims::exception) :
+    _wheel(SCHEDULER_TICK_US),
+    _batch(batch)
+{
+    _timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (_timer_fd < 0) {
+        THROW_IMS_ERROR(ims_implementation_specific_error, "Cannot create the scheduler timer! error: " << strerror(errno));
+    }
+    _wheel.reset(now_us());
+}
+
+scheduler::~scheduler()
+{
+    close(_timer_fd);
+}
+
+void scheduler::add(port_application_base* port)
+{
+    uint64_t period_us = port->get_send_period_us();
+    _wheel.schedule(port->get_wheel_entry(), (now_us() / period_us + 1) * period_us);
+}
+
+void scheduler::start()
+throw(ims::exception)
+{
+    arm();
+}
+
+//
+// A failing port doesn't prevent the next ones from being sent, nor the
+// timer from being armed again: the error is logged where it is thrown.
+//
+void scheduler::run()
+{
+    uint64_t expirations;
+    while (read(_timer_fd, &expirations, sizeof(expirations)) < 0 && errno == EINTR);
+
+    uint64_t now = now_us();
+    _due.clear();
+    _wheel.advance(now, _due);
+
+    if (_due.empty() == false) {
+        _batch->open();
+        for (uint32_t idue = 0; idue < _due.size(); idue++) {
+            port_application_base* port = _due[idue]->port;
+            try {
+                port->send_now();
+            } catch (ims::exception&) {}
+
+            uint64_t period_us = port->get_send_period_us();
+            _wheel.schedule(_due[idue], (now / period_us + 1) * period_us);
+        }
+        try {
+            _batch->flush();
+        } catch (ims::exception&) {}
+    }
+
+    arm();
+}
+
+//
+// Wake up at the earliest due date. A date already passed expires at once.
+//
+void scheduler::arm()
+throw(ims::exception)
+{
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+
+    uint64_t wakeup_us = _wheel.next_wakeup_us();
+    if (wakeup_us != UINT64_MAX) {
+        spec.it_value.tv_sec = wakeup_us / 1000000;
+        spec.it_value.tv_nsec = (wakeup_us % 1000000) * 1000;
+    }
+
+    if (timerfd_settime(_timer_fd, TFD_TIMER_ABSTIME, &spec, NULL) != 0) {
+        THROW_IMS_ERROR(ims_implementation_specific_error, "Cannot arm the scheduler timer! error: " << strerror(errno));
+    }
+}
+
+uint64_t scheduler::now_us()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+}
+#endif
@@ -0,0 +1,75 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Time-triggered emission of the periodic output ports (Linux only).
+// Each port is sent on the boundaries of its period, in monotonic time, by
+// the I/O thread when the timer expires: the bus timing doesn't depend on
+// the application cycle anymore, and send_all doesn't scan these ports.
+// Boundaries missed (thread paused, late wake up) are skipped, not caught up.
+//
+#ifndef _VISTAS_SCHEDULER_HH_
+#define _VISTAS_SCHEDULER_HH_
+#include "vistas_io_thread.hh"
+#include "vistas_port_application.hh"
+#include "vistas_send_batch.hh"
+#include <vector>
+
+#ifdef __linux
+#define VISTAS_HAVE_SCHEDULER
+#endif
+
+// Duration of a slot of the timing wheel, in us
+#define SCHEDULER_TICK_US 100
+
+namespace vistas
+{
+#ifdef VISTAS_HAVE_SCHEDULER
+class scheduler;
+typedef shared_ptr<scheduler> scheduler_ptr;
+
+class scheduler : public io_task
+{
+public:
+    // batch: send batch of the output sockets of the ports
+    scheduler(send_batch_ptr batch)
+    throw(ims::exception);
+    ~scheduler();
+
+    // Send the port on each boundary of its period (> 0), from the next one on
+    void add(port_application_base* port);
+
+    inline uint32_t size() { return _wheel.size(); }
+
+    // Timer to watch (@see io_thread::set_timer)
+    inline int get_timer_fd() { return _timer_fd; }
+
+    // Arm the timer for the first due port
+    void start() throw(ims::exception);
+
+    // Send the due ports and arm the timer again. Run by the I/O thread.
+    void run();
+
+private:
+    void arm() throw(ims::exception);
+
+    // Monotonic time, in us
+    static uint64_t now_us();
+
+    timing_wheel                      _wheel;
+    send_batch_ptr                    _batch;
+    int                               _timer_fd;
+    std::vector<timing_wheel::entry*> _due;    // Kept to avoid allocations
+};
+#endif
+}
+#endif
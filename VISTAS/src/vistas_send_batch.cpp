@@ -0,0 +1,606 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Staging area of the datagrams emitted during one send_all.
+//
+#include "vistas_send_batch.hh"
+#include "vistas_socket_multicast_output.hh"
+#include "ims_time.hh"
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+#include <sstream>
+#ifdef __linux
+#include <sys/socket.h>
+#endif
+
+// Max datagrams submitted by one sendmmsg call
+#define SEND_BATCH_MAX 256
+
+// Time given to the waiting datagrams when the batch is destroyed, in us
+#define SEND_DRAIN_WAIT_US 1000000
+
+// GSO limits: segments of a datagram (UDP_MAX_SEGMENTS of the first kernels
+// supporting it), segment size (bigger ones may need fragmentation, which GSO
+// refuses), and whole UDP payload.
+#define GSO_SEGMENT_COUNT_MAX 64
+#define GSO_SEGMENT_SIZE_MAX  1472
+#define GSO_SIZE_MAX          65507
+
+namespace vistas
+{
+
+// Lane of the calling thread
+static __thread uint32_t current_lane = 0;
+
+//
+// Send the datagrams still waiting, as the last send_all is not lost when the
+// context is freed. Then detach the sockets: they may outlive the batch.
+//
+send_batch::~send_batch()
+{
+    drain_retries(SEND_DRAIN_WAIT_US);
+
+    for (std::set<socket*>::iterator isocket = _attached.begin(); isocket != _attached.end(); isocket++) {
+        (*isocket)->set_send_batch(NULL, INVALID_SOCKET);
+    }
+}
+
+//
+// Set the number of lanes
+//
+void send_batch::set_lane_count(uint32_t count)
+{
+    _lanes.resize(std::max(count, (uint32_t)1));
+}
+
+//
+// Select the lane of the calling thread
+//
+void send_batch::select_lane(uint32_t lane)
+{
+    current_lane = lane;
+}
+
+//
+// Make the given output socket stage its datagrams in this batch.
+//
+void send_batch::attach(socket_ptr socket)
+throw(ims::exception)
+{
+    // Outputs without fd are sent by a carrier (@see socket_multicast_output::create_shared)
+    socket_address_ptr address = socket->get_address();
+    if (!address) return;
+    if (socket->get_fd() == INVALID_SOCKET &&
+        dynamic_cast<socket_multicast_output*>(socket.get()) == NULL) return;
+
+    // The source port matters: keep its own socket
+    if (address->get_outgoing_port() != 0) {
+        set_send_buffer(socket);
+        socket->set_send_batch(this, socket->get_fd());
+        _attached.insert(socket.get());
+        return;
+    }
+
+    std::stringstream key;
+    key << address->get_interface_ip() << '/' << address->get_TTL();
+
+    carrier_map_t::iterator icarrier = _carriers.find(key.str());
+    if (icarrier == _carriers.end()) {
+        socket_address_ptr carrier_address(new socket_address_t(ims_output,
+                                                                "0.0.0.0",
+                                                                0,
+                                                                address->get_interface_ip(),
+                                                                address->get_TTL()));
+        socket_ptr carrier(new socket_multicast_output(carrier_address));
+        set_send_buffer(carrier);
+        icarrier = _carriers.insert(carrier_map_t::value_type(key.str(), carrier)).first;
+    }
+
+    socket->set_send_batch(this, icarrier->second->get_fd());
+    _attached.insert(socket.get());
+}
+
+//
+// Apply the configured send buffer size to a socket sending for the batch
+//
+void send_batch::set_send_buffer(socket_ptr socket)
+{
+    if (_send_buffer_size == 0) return;
+
+    if (socket->set_send_buffer_size(_send_buffer_size) == false) {
+        LOG_WARN(socket->to_string() << ": Cannot set the send buffer size to " << _send_buffer_size
+                 << " bytes! error: " << socket::getlasterror());
+    }
+}
+
+//
+// Copy a datagram in the staging area
+//
+void send_batch::stage(socket* socket, IMS_SOCKET fd, const struct sockaddr_in& saddr,
+                       const char* buffer, uint32_t size,
+                       const char* payload, uint32_t payload_size)
+{
+    lane_t& lane = _lanes[current_lane];
+
+    if (lane.staging.size() < lane.staging_size + size) {
+        lane.staging.resize(std::max((size_t)(lane.staging_size + size), lane.staging.size() * 2));
+    }
+    memcpy(&lane.staging[lane.staging_size], buffer, size);
+
+    entry new_entry;
+    new_entry.source = socket;
+    new_entry.fd = fd;
+    new_entry.saddr = saddr;
+    new_entry.lane = current_lane;
+    new_entry.offset = lane.staging_size;
+    new_entry.size = size;
+    new_entry.payload = payload;
+    new_entry.payload_size = payload_size;
+    lane.entries.push_back(new_entry);
+
+    lane.staging_size += size;
+}
+
+//
+// Queue a datagram in its socket, dropping the oldest one if needed
+//
+void send_batch::retry(socket* socket, IMS_SOCKET fd, const struct sockaddr_in& saddr,
+                       const char* buffer, uint32_t size,
+                       const char* payload, uint32_t payload_size)
+{
+    if (socket->_send_retry == NULL) {
+        socket->_send_retry = new send_retry();
+    }
+    send_retry& queue = *socket->_send_retry;
+
+    if (queue.count == 0) {
+        _retrying.push_back(socket);
+    } else if (queue.count == SEND_RETRY_DEPTH) {
+        queue.first = (queue.first + 1) % SEND_RETRY_DEPTH;
+        queue.count--;
+        __atomic_add_fetch(&socket->_dropped_count, 1, __ATOMIC_RELAXED);
+    }
+
+    send_retry::datagram_t& datagram = queue.at(queue.count++);
+    datagram.fd = fd;
+    datagram.saddr = saddr;
+    datagram.data.assign(buffer, buffer + size);
+    if (payload != NULL) {
+        datagram.data.insert(datagram.data.end(), payload, payload + payload_size);
+    }
+    __atomic_add_fetch(&socket->_retried_count, 1, __ATOMIC_RELAXED);
+}
+
+//
+// Forget a socket being destroyed
+//
+void send_batch::forget(socket* socket)
+{
+    _attached.erase(socket);
+
+    std::vector<vistas::socket*>::iterator isocket = std::find(_retrying.begin(), _retrying.end(), socket);
+    if (isocket != _retrying.end()) _retrying.erase(isocket);
+}
+
+//
+// Submit the waiting datagrams of each socket, oldest first
+//
+uint32_t send_batch::submit_retries()
+{
+    uint32_t failures = 0;
+    uint32_t kept = 0;
+
+    for (uint32_t isocket = 0; isocket < _retrying.size(); isocket++) {
+        socket* current = _retrying[isocket];
+        send_retry& queue = *current->_send_retry;
+
+        while (queue.count > 0) {
+            send_retry::datagram_t& datagram = queue.at(0);
+            int32_t sent_size = sendto(datagram.fd,
+                                       datagram.data.empty()? NULL : &datagram.data[0], datagram.data.size(), 0,
+                                       (const struct sockaddr*)&datagram.saddr, sizeof(struct sockaddr_in));
+            if (sent_size < 0 && errno == EINTR) continue;
+            if (sent_size < 0 && is_full(errno)) break;
+
+            if (sent_size < 0 || (uint32_t)sent_size != datagram.data.size()) {
+                LOG_ERROR(current->to_string() << ": Failed to write to socket! errno:" << socket::getlasterror());
+                failures++;
+            }
+            queue.first = (queue.first + 1) % SEND_RETRY_DEPTH;
+            queue.count--;
+        }
+
+        if (queue.count > 0) {
+            _retrying[kept++] = current;
+        } else {
+            // Most sockets never wait again: don't keep the queue
+            delete current->_send_retry;
+            current->_send_retry = NULL;
+        }
+    }
+    _retrying.resize(kept);
+
+    return failures;
+}
+
+//
+// Submit the waiting datagrams, waiting for room in their socket buffers
+//
+void send_batch::drain_retries(__attribute__((__unused__)) uint32_t timeout_us)
+{
+    // Failures are logged by submit_retries()
+    submit_retries();
+
+#ifdef __linux
+    uint64_t begin = ims_get_real_time();
+    std::vector<struct pollfd> poll_fds;
+    while (_retrying.empty() == false) {
+        uint64_t elapsed = ims_get_real_time() - begin;
+        if (elapsed >= timeout_us) break;
+
+        poll_fds.resize(_retrying.size());
+        for (uint32_t isocket = 0; isocket < _retrying.size(); isocket++) {
+            poll_fds[isocket].fd = _retrying[isocket]->_send_retry->at(0).fd;
+            poll_fds[isocket].events = POLLOUT;
+            poll_fds[isocket].revents = 0;
+        }
+
+        int res = poll(&poll_fds[0], poll_fds.size(), (timeout_us - elapsed + 999) / 1000);
+        if (res < 0 && errno == EINTR) continue;
+        if (res <= 0) break;
+
+        submit_retries();
+    }
+#endif
+
+    for (uint32_t isocket = 0; isocket < _retrying.size(); isocket++) {
+        socket* current = _retrying[isocket];
+        __atomic_add_fetch(&current->_dropped_count, current->_send_retry->count, __ATOMIC_RELAXED);
+        current->_send_retry->count = 0;
+    }
+    _retrying.clear();
+}
+
+//
+// Submit all staged datagrams and close the batch.
+//
+void send_batch::flush()
+throw(ims::exception)
+{
+    _open = false;
+
+    // The datagrams of the previous flushes go first
+    uint32_t failures = 0;
+    if (_retrying.empty() == false) {
+        failures = submit_retries();
+    }
+
+    // Lanes hold consecutive ports: their order is the sending order.
+    // Sockets still waiting queue their new datagrams behind the old ones.
+    for (uint32_t ilane = 0; ilane < _lanes.size(); ilane++) {
+        entry_vector_t& entries = _lanes[ilane].entries;
+        for (entry_vector_t::iterator ientry = entries.begin(); ientry != entries.end(); ientry++) {
+            if (ientry->source->_send_retry != NULL && ientry->source->_send_retry->count > 0) {
+                retry(*ientry);
+            } else {
+                _entries.push_back(*ientry);
+            }
+        }
+        entries.clear();
+    }
+
+    // Group entries by fd. The sort is stable, so each socket keeps its datagrams order.
+    std::stable_sort(_entries.begin(), _entries.end(), entry::fd_less);
+
+#ifdef VISTAS_HAVE_URING
+    if (_uring) {
+        failures += submit_uring();
+    } else
+#endif
+    {
+        uint32_t first = 0;
+        for (uint32_t id = 1; id <= _entries.size(); id++) {
+            if (id == _entries.size() || _entries[id].fd != _entries[first].fd) {
+                failures += submit(first, id);
+                first = id;
+            }
+        }
+    }
+
+    _entries.clear();
+    for (uint32_t ilane = 0; ilane < _lanes.size(); ilane++) {
+        _lanes[ilane].staging_size = 0;
+    }
+
+    if (failures != 0) {
+        THROW_IMS_ERROR(ims_implementation_specific_error, failures << " datagram(s) could not be sent!");
+    }
+}
+
+#ifdef __linux
+//
+// Describe an entry for sendmsg: staged part, then its payload if any
+//
+void send_batch::fill_message(entry& current, struct msghdr& message, struct iovec* iovecs)
+{
+    iovecs[0].iov_base = &_lanes[current.lane].staging[current.offset];
+    iovecs[0].iov_len = current.size;
+    iovecs[1].iov_base = (void*)current.payload;
+    iovecs[1].iov_len = current.payload_size;
+    message.msg_name = &current.saddr;
+    message.msg_namelen = sizeof(struct sockaddr_in);
+    message.msg_iov = iovecs;
+    message.msg_iovlen = (current.payload != NULL)? 2 : 1;
+}
+#endif
+
+#ifdef VISTAS_HAVE_UDP_GSO
+//
+// Older kernels ignore the UDP_SEGMENT cmsg and would send the segments as
+// one datagram: only use it when the option is known.
+//
+bool send_batch::probe_gso()
+{
+    IMS_SOCKET probe = ::socket(PF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (probe == INVALID_SOCKET) return false;
+
+    int segment_size = 0;
+    socklen_t option_size = sizeof(segment_size);
+    bool supported = (getsockopt(probe, SOL_UDP, UDP_SEGMENT, &segment_size, &option_size) == 0);
+    ::close(probe);
+
+    if (supported == false) {
+        LOG_INFO("UDP GSO is not supported by the kernel, datagrams are sent one by one.");
+    }
+    return supported;
+}
+
+//
+// A GSO datagram is made of segments of the same size, but the last one
+// which may be smaller, to the same destination.
+//
+uint32_t send_batch::gso_segments(uint32_t first, uint32_t last, uint32_t max_count)
+{
+    if (_gso == false) return 1;
+
+    const entry& head = _entries[first];
+    uint32_t segment_size = head.size + head.payload_size;
+    if (segment_size == 0 || segment_size > GSO_SEGMENT_SIZE_MAX) return 1;
+
+    uint32_t count = 1;
+    uint32_t total_size = segment_size;
+    max_count = std::min(max_count, (uint32_t)GSO_SEGMENT_COUNT_MAX);
+    while (first + count < last && count < max_count) {
+        const entry& current = _entries[first + count];
+        uint32_t size = current.size + current.payload_size;
+        if (current.saddr.sin_addr.s_addr != head.saddr.sin_addr.s_addr ||
+            current.saddr.sin_port != head.saddr.sin_port ||
+            size == 0 || size > segment_size || total_size + size > GSO_SIZE_MAX) {
+            break;
+        }
+
+        count++;
+        total_size += size;
+        if (size < segment_size) break;
+    }
+    return count;
+}
+#endif
+
+//
+// Submit entries sharing the same fd
+//
+uint32_t send_batch::submit(uint32_t first, uint32_t last)
+{
+    uint32_t failures = 0;
+
+#ifdef __linux
+    struct mmsghdr messages[SEND_BATCH_MAX];
+    struct iovec   iovecs[SEND_BATCH_MAX][2];
+    uint32_t       segments[SEND_BATCH_MAX];    // Entries sent by each message
+#ifdef VISTAS_HAVE_UDP_GSO
+    char           controls[SEND_BATCH_MAX][CMSG_SPACE(sizeof(uint16_t))];
+#endif
+
+    while (first < last) {
+        // Entries are described by iovecs pairs: a GSO message uses the pairs of all its segments
+        uint32_t count = 0;
+        uint32_t next = first;
+        uint32_t pair = 0;
+
+        memset(messages, 0, std::min(last - first, (uint32_t)SEND_BATCH_MAX) * sizeof(struct mmsghdr));
+        while (next < last && pair < SEND_BATCH_MAX) {
+            uint32_t segment_count = 1;
+#ifdef VISTAS_HAVE_UDP_GSO
+            segment_count = gso_segments(next, last, SEND_BATCH_MAX - pair);
+#endif
+            struct msghdr& message = messages[count].msg_hdr;
+            fill_message(_entries[next], message, iovecs[pair]);
+
+            if (segment_count > 1) {
+#ifdef VISTAS_HAVE_UDP_GSO
+                // Segments are contiguous pairs, empty payloads make empty iovecs
+                for (uint32_t segment = 1; segment < segment_count; segment++) {
+                    struct msghdr segment_message;
+                    fill_message(_entries[next + segment], segment_message, iovecs[pair + segment]);
+                }
+                message.msg_iovlen = segment_count * 2;
+
+                message.msg_control = controls[count];
+                message.msg_controllen = sizeof(controls[count]);
+                struct cmsghdr* control = CMSG_FIRSTHDR(&message);
+                control->cmsg_level = SOL_UDP;
+                control->cmsg_type = UDP_SEGMENT;
+                control->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                uint16_t segment_size = _entries[next].size + _entries[next].payload_size;
+                memcpy(CMSG_DATA(control), &segment_size, sizeof(uint16_t));
+#endif
+            }
+
+            segments[count++] = segment_count;
+            next += segment_count;
+            pair += segment_count;
+        }
+
+        int res = sendmmsg(_entries[first].fd, messages, count, 0);
+        if (res < 0 && errno == EINTR) continue;
+
+        if (res <= 0) {
+            // Socket buffer full: the rest waits for the next flush
+            if (res < 0 && is_full(errno)) {
+                for (; first < last; first++) {
+                    retry(_entries[first]);
+                }
+                break;
+            }
+
+#ifdef VISTAS_HAVE_UDP_GSO
+            // The kernel knows GSO but the route doesn't (no checksum offload, IPsec...)
+            if (segments[0] > 1 && (errno == EIO || errno == EINVAL)) {
+                int error = errno;
+                LOG_WARN(_entries[first].source->to_string() << ": UDP GSO failed (errno: " << error
+                         << "), datagrams are now sent one by one.");
+                _gso = false;
+                continue;
+            }
+#endif
+            // The first message failed: report it and go on with the next ones
+            LOG_ERROR(_entries[first].source->to_string() << ": Failed to write to socket! errno:" << socket::getlasterror());
+            failures += segments[0];
+            first += segments[0];
+            continue;
+        }
+
+        for (int id = 0; id < res; id++) {
+            uint32_t size = 0;
+            for (uint32_t segment = 0; segment < segments[id]; segment++) {
+                size += _entries[first + segment].size + _entries[first + segment].payload_size;
+            }
+            if (messages[id].msg_len != size) {
+                LOG_ERROR(_entries[first].source->to_string() << ": Short write to socket! "
+                          << messages[id].msg_len << '/' << size << " bytes sent.");
+                failures += segments[id];
+            }
+            first += segments[id];
+        }
+    }
+#else
+    for (; first < last; first++) {
+        entry& current = _entries[first];
+
+        WSABUF buffers[2];
+        buffers[0].buf = &_lanes[current.lane].staging[current.offset];
+        buffers[0].len = current.size;
+        buffers[1].buf = (char*)current.payload;
+        buffers[1].len = current.payload_size;
+
+        DWORD sent_size = 0;
+        int res = WSASendTo(current.fd, buffers, (current.payload != NULL)? 2 : 1, &sent_size, 0,
+                            (const struct sockaddr*)&current.saddr, sizeof(struct sockaddr_in), NULL, NULL);
+        if (res != 0 && socket::wouldblock()) {
+            for (; first < last; first++) {
+                retry(_entries[first]);
+            }
+            break;
+        }
+        if (res != 0 || sent_size != current.size + current.payload_size) {
+            LOG_ERROR(current.source->to_string() << ": Failed to write to socket! errno:" << socket::getlasterror());
+            failures++;
+        }
+    }
+#endif
+
+    return failures;
+}
+
+#ifdef VISTAS_HAVE_URING
+//
+// Submit all entries through the ring, one io_uring_enter per chunk.
+// The requests of a socket are linked, so they are sent in order: when one
+// finds the socket buffer full, the next ones are cancelled and wait behind
+// it, as with sendmmsg.
+//
+uint32_t send_batch::submit_uring()
+{
+    uint32_t failures = 0;
+
+    struct msghdr messages[SEND_BATCH_MAX];
+    struct iovec  iovecs[SEND_BATCH_MAX][2];
+    uring::completion completions[SEND_BATCH_MAX];
+    int32_t       results[SEND_BATCH_MAX];
+
+    uint32_t first = 0;
+    while (first < _entries.size()) {
+        uint32_t count = std::min((uint32_t)_entries.size() - first,
+                                  std::min(_uring->space(), (uint32_t)SEND_BATCH_MAX));
+
+        // A socket already waiting, since a previous chunk, keeps its next datagrams
+        for (uint32_t id = 0; id < count; id++) {
+            send_retry* waiting = _entries[first + id].source->_send_retry;
+            results[id] = (waiting != NULL && waiting->count > 0)? -ECANCELED : 0;
+        }
+
+        memset(messages, 0, count * sizeof(struct msghdr));
+        uint32_t submitted = 0;
+        for (uint32_t id = 0; id < count; id++) {
+            if (results[id] != 0) continue;
+            entry& current = _entries[first + id];
+            bool linked = (id + 1 < count && results[id + 1] == 0 && _entries[first + id + 1].fd == current.fd);
+            fill_message(current, messages[id], iovecs[id]);
+            _uring->send(current.fd, &messages[id], first + id, linked);
+            submitted++;
+        }
+
+        // Messages live on the stack: wait for all of them
+        _uring->submit(submitted);
+
+        uint32_t reaped = 0;
+        while (reaped < submitted) {
+            uint32_t nb_completions = _uring->reap(completions, submitted - reaped);
+            if (nb_completions == 0) {
+                _uring->submit(submitted - reaped);
+                continue;
+            }
+
+            for (uint32_t icompletion = 0; icompletion < nb_completions; icompletion++) {
+                results[completions[icompletion].user_data - first] = completions[icompletion].res;
+            }
+            reaped += nb_completions;
+        }
+
+        // Completions come in any order: handle them in the sending order,
+        // so the waiting datagrams of a socket keep it.
+        for (uint32_t id = 0; id < count; id++) {
+            entry& current = _entries[first + id];
+            if (results[id] < 0 && (is_full(-results[id]) || results[id] == -ECANCELED)) {
+                retry(current);
+            } else if (results[id] < 0) {
+                LOG_ERROR(current.source->to_string() << ": Failed to write to socket! "
+                          << strerror(-results[id]));
+                failures++;
+            } else if ((uint32_t)results[id] != current.size + current.payload_size) {
+                LOG_ERROR(current.source->to_string() << ": Short write to socket! "
+                          << results[id] << '/' << current.size + current.payload_size << " bytes sent.");
+                failures++;
+            }
+        }
+
+        first += count;
+    }
+
+    return failures;
+}
+#endif
+
+}
@@ -0,0 +1,245 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Staging area of the datagrams emitted during one send_all.
+// While the batch is open, attached output sockets copy their datagrams here
+// instead of writing them. flush() then submits the whole cycle with as few
+// sendmmsg calls as possible, or with a single io_uring submission per
+// chunk when a ring is set.
+// Ports may be sent by several threads at once: each one stages in its own
+// lane, and flush() submits the lanes in order.
+// Consecutive datagrams of the same size to the same destination, like the
+// burst of a queuing port, are submitted as one UDP GSO datagram when the
+// kernel supports it: the kernel splits it again, after a single traversal
+// of the network stack.
+// Output sockets don't block: datagrams a full socket buffer refuses wait
+// in a bounded queue of their socket, and are submitted first by the next
+// flush(), before any new datagram of the socket. When the queue is full,
+// its oldest datagram is dropped. flush() never waits for room; only the
+// destruction of the batch does, for a bounded time, to send what is left.
+//
+#ifndef _VISTAS_SEND_BATCH_HH_
+#define _VISTAS_SEND_BATCH_HH_
+#include "vistas_socket.hh"
+#include "vistas_uring.hh"
+#include "vistas_sync.hh"
+#include <errno.h>
+#include <map>
+#include <set>
+#include <vector>
+#ifdef __linux
+#include <netinet/udp.h>
+#include <poll.h>
+#ifdef UDP_SEGMENT
+#define VISTAS_HAVE_UDP_GSO
+#endif
+#endif
+
+// Datagrams waiting per socket
+#define SEND_RETRY_DEPTH 64
+
+namespace vistas
+{
+class send_batch;
+typedef shared_ptr<send_batch> send_batch_ptr;
+
+//
+// Datagrams of a socket waiting for room in the socket buffer, oldest first
+//
+class send_retry
+{
+public:
+    inline send_retry() : first(0), count(0) {}
+
+    struct datagram_t
+    {
+        IMS_SOCKET         fd;
+        struct sockaddr_in saddr;
+        std::vector<char>  data;        // Only grows, so no allocation in steady state
+    };
+
+    inline datagram_t& at(uint32_t index) { return datagrams[(first + index) % SEND_RETRY_DEPTH]; }
+
+    datagram_t datagrams[SEND_RETRY_DEPTH];
+    uint32_t   first;
+    uint32_t   count;
+};
+
+class send_batch
+{
+public:
+    inline send_batch();
+
+    // Sockets still waiting to send are detached
+    ~send_batch();
+
+    // Make the given output socket stage its datagrams in this batch.
+    // Sockets without outgoing port share a carrier socket with the same
+    // interface and TTL, so their datagrams can be submitted together.
+    void attach(socket_ptr socket) throw(ims::exception);
+
+    // Number of lanes, 1 by default. Only while the batch is closed.
+    void set_lane_count(uint32_t count);
+
+    // Lane where the calling thread stages its datagrams, 0 by default.
+    // Two threads must never stage in the same lane at once.
+    static void select_lane(uint32_t lane);
+
+    // Start staging datagrams
+    inline void open();
+    inline bool is_open();
+
+    // Copy a datagram in the staging area of the current lane.
+    // The socket is only used to report errors.
+    // An optional payload is sent behind the buffer. It is NOT copied: it
+    // must stay unchanged until flush().
+    void stage(socket* socket, IMS_SOCKET fd, const struct sockaddr_in& saddr,
+               const char* buffer, uint32_t size,
+               const char* payload = NULL, uint32_t payload_size = 0);
+
+    // Submit the waiting datagrams, then all staged datagrams, and close the batch.
+    // All datagrams are submitted even if some of them fail. Each failure
+    // is logged with its socket, then an error is thrown.
+    // A full socket buffer is not a failure: its datagrams wait for the next flush.
+    void flush() throw(ims::exception);
+
+    // Copy a datagram refused by a full socket buffer in the queue of its
+    // socket. Drop the oldest one if the queue is full.
+    void retry(socket* socket, IMS_SOCKET fd, const struct sockaddr_in& saddr,
+               const char* buffer, uint32_t size,
+               const char* payload = NULL, uint32_t payload_size = 0);
+
+    // Forget a socket being destroyed, and its waiting datagrams
+    void forget(socket* socket);
+
+#ifdef VISTAS_HAVE_URING
+    // Submit the datagrams through the given ring instead of sendmmsg
+    inline void set_uring(uring_ptr ring) { _uring = ring; }
+#endif
+
+    // Send buffer size of the sockets attached from now on, 0 for the system default
+    inline void set_send_buffer_size(uint32_t size) { _send_buffer_size = size; }
+
+private:
+    struct entry
+    {
+        socket*            source;    // Only used to report errors
+        IMS_SOCKET         fd;
+        struct sockaddr_in saddr;
+        uint32_t           lane;
+        uint32_t           offset;    // In the staging area of the lane
+        uint32_t           size;
+        const char*        payload;   // Sent behind the staged part, may be NULL
+        uint32_t           payload_size;
+
+        static inline bool fd_less(const entry& left, const entry& right) { return left.fd < right.fd; }
+    };
+
+    typedef std::vector<entry>                  entry_vector_t;
+    typedef std::map<std::string, socket_ptr>   carrier_map_t;
+
+    struct lane_t
+    {
+        inline lane_t() : staging_size(0) {}
+        std::vector<char> staging;      // Datagrams payloads. Only grows, so no allocation in steady state.
+        uint32_t          staging_size;
+        entry_vector_t    entries;
+        char              padding[VISTAS_CACHE_LINE_SIZE];   // Lanes are written by different threads
+    };
+
+    // Submit the entries [first, last[ which all use the same fd.
+    // @return The number of failed datagrams.
+    uint32_t submit(uint32_t first, uint32_t last);
+
+    // Submit the waiting datagrams of each socket, until its buffer is full again
+    // @return The number of failed datagrams.
+    uint32_t submit_retries();
+
+    // Submit the waiting datagrams, waiting for room up to timeout_us.
+    // The ones still waiting then are dropped.
+    void drain_retries(uint32_t timeout_us);
+
+    // Apply _send_buffer_size to the socket
+    void set_send_buffer(socket_ptr socket);
+
+    // Is the socket buffer full
+    static inline bool is_full(int error) { return error == EAGAIN || error == EWOULDBLOCK || error == ENOBUFS; }
+
+    // Queue a staged entry behind the waiting datagrams of its socket
+    inline void retry(entry& current);
+
+#ifdef __linux
+    // Describe an entry for sendmsg. iovecs must have 2 elements.
+    void fill_message(entry& current, struct msghdr& message, struct iovec* iovecs);
+#endif
+
+#ifdef VISTAS_HAVE_UDP_GSO
+    // Number of entries from first which can be sent as one GSO datagram, at
+    // most max_count: 1 if they cannot.
+    uint32_t gso_segments(uint32_t first, uint32_t last, uint32_t max_count);
+
+    // Check the kernel supports UDP_SEGMENT
+    static bool probe_gso();
+
+    bool              _gso;
+#endif
+
+#ifdef VISTAS_HAVE_URING
+    // Submit all the entries through the ring.
+    // @return The number of failed datagrams.
+    uint32_t submit_uring();
+
+    uring_ptr         _uring;
+#endif
+
+    bool              _open;
+    uint32_t          _send_buffer_size;
+    std::vector<lane_t> _lanes;
+    entry_vector_t    _entries;         // Entries of all the lanes, being submitted
+    std::vector<socket*> _retrying;     // Sockets with waiting datagrams
+    std::set<socket*> _attached;        // Sockets staging in this batch, detached when it is destroyed
+    carrier_map_t     _carriers;        // Shared sockets, by interface and TTL
+};
+
+//***************************************************************************
+// Inlines
+//***************************************************************************
+send_batch::send_batch() :
+#ifdef VISTAS_HAVE_UDP_GSO
+    _gso(probe_gso()),
+#endif
+    _open(false),
+    _send_buffer_size(0),
+    _lanes(1)
+{
+}
+
+void send_batch::open()
+{
+    _open = true;
+}
+
+bool send_batch::is_open()
+{
+    return _open;
+}
+
+void send_batch::retry(entry& current)
+{
+    retry(current.source, current.fd, current.saddr,
+          &_lanes[current.lane].staging[current.offset], current.size,
+          current.payload, current.payload_size);
+}
+
+}
+#endif
@@ -14,11 +14,28 @@
 // Abstract base socket class
 //
 #include "vistas_socket.hh"
+#include "vistas_uring.hh"
+#include "vistas_io_thread.hh"
+#include "vistas_send_batch.hh"
+#include "vistas_pacer.hh"
+#include <algorithm>
 #include <unistd.h>
+#include <fcntl.h>
+#include <vector>
 #ifdef __linux
 #include <errno.h>
+#include <sys/socket.h>
 #endif
 
+// Max datagrams read by one receive_many call
+#define RECEIVE_MANY_MAX 64
+
+// Slots used by receive_latest
+#define RECEIVE_LATEST_SLOTS 16
+
+// Biggest coalesced datagram
+#define GRO_STAGING_SIZE 65536
+
 namespace vistas
 {
 /*
@@ -70,9 +87,431 @@ void socket::close()
     }
 }
 
+#ifdef VISTAS_HAVE_UDP_GRO
+struct socket::gro_staging
+{
+    inline gro_staging() : buffer(GRO_STAGING_SIZE), size(0), segment_size(0), segment_count(0), segment_next(0) {}
+
+    std::vector<char>  buffer;
+    uint32_t           size;            // Of the whole datagram
+    uint32_t           segment_size;    // The last segment may be smaller
+    uint32_t           segment_count;
+    uint32_t           segment_next;    // Next segment to hand
+    struct sockaddr_in from;
+};
+#endif
+
 socket::~socket()
 {
+#ifdef VISTAS_HAVE_PACER
+    if (_pacer != NULL) _pacer->remove(this);
+#endif
+    if (_send_batch != NULL) _send_batch->forget(this);
+    delete _send_retry;
     close();
+#ifdef VISTAS_HAVE_UDP_GRO
+    delete _gro;
+#endif
+}
+
+//
+// Set SO_SNDBUF
+//
+bool socket::set_send_buffer_size(uint32_t size)
+{
+    if (_sock == INVALID_SOCKET) return false;
+
+    int value = size;
+    return setsockopt(_sock, SOL_SOCKET, SO_SNDBUF, (const char*) &value, sizeof(value)) == 0;
+}
+
+//
+// Enable or disable UDP_GRO
+//
+bool socket::set_gro(__attribute__((__unused__)) bool enabled)
+{
+#ifdef VISTAS_HAVE_UDP_GRO
+    if (_sock == INVALID_SOCKET) return false;
+    if (enabled == (_gro != NULL)) return true;
+
+    int value = enabled? 1 : 0;
+    if (setsockopt(_sock, SOL_UDP, UDP_GRO, (const char*) &value, sizeof(value)) != 0) {
+        return false;
+    }
+
+    if (enabled) {
+        _gro = new gro_staging();
+    } else {
+        delete _gro;
+        _gro = NULL;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef ENABLE_INSTRUMENTATION
+//
+// Call the receive handler with the whole datagram, even if it was scattered
+//
+static void call_handler_recv(const socket::datagram& datagram, const struct sockaddr_in& client)
+{
+    if (datagram.payload == NULL || datagram.size <= datagram.buffer_size) {
+        ims_socket_handler_recv(datagram.buffer, datagram.size,
+                                inet_ntoa(client.sin_addr), ntohs(client.sin_port));
+        return;
+    }
+
+    // Only when instrumented: assemble the datagram
+    std::vector<char> whole(datagram.buffer, datagram.buffer + datagram.buffer_size);
+    whole.insert(whole.end(), datagram.payload, datagram.payload + datagram.size - datagram.buffer_size);
+    ims_socket_handler_recv(&whole[0], whole.size(),
+                            inet_ntoa(client.sin_addr), ntohs(client.sin_port));
+}
+#endif
+
+//
+// Receive a batch of datagrams
+//
+uint32_t socket::receive_many(datagram* datagrams, uint32_t count)
+throw(ims::exception)
+{
+#ifdef VISTAS_HAVE_IO_THREAD
+    if (_io_inbox != NULL) {
+        return _io_inbox->receive_many(datagrams, count);
+    }
+#endif
+
+#ifdef VISTAS_HAVE_URING
+    if (_uring != NULL) {
+        return _uring->receive_many(*_uring_inbox, datagrams, count);
+    }
+#endif
+
+#ifdef VISTAS_HAVE_UDP_GRO
+    if (_gro != NULL) {
+        return receive_gro(datagrams, count);
+    }
+#endif
+
+#ifdef __linux
+    if (count > RECEIVE_MANY_MAX) count = RECEIVE_MANY_MAX;
+
+    struct mmsghdr     messages[RECEIVE_MANY_MAX];
+    struct iovec       iovecs[RECEIVE_MANY_MAX][2];
+#ifdef ENABLE_INSTRUMENTATION
+    struct sockaddr_in clients[RECEIVE_MANY_MAX];
+#endif
+
+    memset(messages, 0, count * sizeof(struct mmsghdr));
+    for (uint32_t id = 0; id < count; id++) {
+        iovecs[id][0].iov_base = datagrams[id].buffer;
+        iovecs[id][0].iov_len = datagrams[id].buffer_size;
+        iovecs[id][1].iov_base = datagrams[id].payload;
+        iovecs[id][1].iov_len = datagrams[id].payload_size;
+        messages[id].msg_hdr.msg_iov = iovecs[id];
+        messages[id].msg_hdr.msg_iovlen = (datagrams[id].payload != NULL)? 2 : 1;
+#ifdef ENABLE_INSTRUMENTATION
+        messages[id].msg_hdr.msg_name = &clients[id];
+        messages[id].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+#endif
+    }
+
+    int res = recvmmsg(_sock, messages, count, MSG_DONTWAIT, NULL);
+    if (res < 0) {
+        if (wouldblock() || errno == EINTR) return 0;
+        THROW_IMS_ERROR(ims_implementation_specific_error, to_string() << ": Failed to read from socket. error: " << socket::getlasterror());
+    }
+
+    for (int id = 0; id < res; id++) {
+        datagrams[id].size = messages[id].msg_len;
+
+#ifdef ENABLE_INSTRUMENTATION
+        // Call handler
+        if(ims_socket_handler_recv){
+            call_handler_recv(datagrams[id], clients[id]);
+        }
+#endif
+    }
+
+    return res;
+#else
+    // Socket is non-blocking: receive return 0 when nothing is pending
+    uint32_t received;
+    for (received = 0; received < count; received++) {
+        datagram& current = datagrams[received];
+
+        if (current.payload == NULL) {
+            current.size = receive(current.buffer, current.buffer_size);
+        } else {
+            WSABUF buffers[2];
+            buffers[0].buf = current.buffer;
+            buffers[0].len = current.buffer_size;
+            buffers[1].buf = current.payload;
+            buffers[1].len = current.payload_size;
+
+            struct sockaddr_in client;
+            int client_size = sizeof(struct sockaddr_in);
+            DWORD size = 0;
+            DWORD flags = 0;
+            if (WSARecvFrom(_sock, buffers, 2, &size, &flags, (struct sockaddr*)&client, &client_size, NULL, NULL) != 0) {
+                if (wouldblock()) break;
+                // Truncated datagram: the buffers are full
+                if (WSAGetLastError() != WSAEMSGSIZE) {
+                    THROW_IMS_ERROR(ims_implementation_specific_error, to_string() << ": Failed to read from socket. error: " << socket::getlasterror());
+                }
+                size = current.buffer_size + current.payload_size;
+            }
+            current.size = size;
+
+#ifdef ENABLE_INSTRUMENTATION
+            if(ims_socket_handler_recv){
+                call_handler_recv(current, client);
+            }
+#endif
+        }
+
+        if (current.size == 0) break;
+    }
+    return received;
+#endif
+}
+
+#ifdef VISTAS_HAVE_UDP_GRO
+//
+// Read the datagrams one by one in the staging, and hand their segments
+//
+uint32_t socket::receive_gro(datagram* datagrams, uint32_t count)
+throw(ims::exception)
+{
+    uint32_t received = 0;
+
+    while (received < count) {
+        gro_staging& staging = *_gro;
+
+        if (staging.segment_next == staging.segment_count) {
+            struct iovec iovec;
+            iovec.iov_base = &staging.buffer[0];
+            iovec.iov_len = staging.buffer.size();
+
+            char control_buffer[CMSG_SPACE(sizeof(int))];
+            struct msghdr message;
+            memset(&message, 0, sizeof(struct msghdr));
+            message.msg_name = &staging.from;
+            message.msg_namelen = sizeof(struct sockaddr_in);
+            message.msg_iov = &iovec;
+            message.msg_iovlen = 1;
+            message.msg_control = control_buffer;
+            message.msg_controllen = sizeof(control_buffer);
+
+            int res = recvmsg(_sock, &message, MSG_DONTWAIT);
+            if (res < 0) {
+                if (wouldblock() || errno == EINTR) break;
+                THROW_IMS_ERROR(ims_implementation_specific_error, to_string() << ": Failed to read from socket. error: " << socket::getlasterror());
+            }
+
+            // No control message: the datagram was not coalesced
+            staging.size = res;
+            staging.segment_size = res;
+            for (struct cmsghdr* control = CMSG_FIRSTHDR(&message);
+                 control != NULL;
+                 control = CMSG_NXTHDR(&message, control))
+            {
+                if (control->cmsg_level == SOL_UDP && control->cmsg_type == UDP_GRO) {
+                    int segment_size;
+                    memcpy(&segment_size, CMSG_DATA(control), sizeof(int));
+                    if (segment_size > 0) staging.segment_size = segment_size;
+                    break;
+                }
+            }
+            staging.segment_count = (staging.size == 0)? 1 : (staging.size + staging.segment_size - 1) / staging.segment_size;
+            staging.segment_next = 0;
+        }
+
+        // Same behaviour as recvmmsg: what doesn't fit in the buffer goes to the payload segment
+        uint32_t offset = staging.segment_next * staging.segment_size;
+        uint32_t size = std::min(staging.segment_size, staging.size - offset);
+        const char* data = &staging.buffer[offset];
+
+        datagram& current = datagrams[received];
+        uint32_t head_size = std::min(size, current.buffer_size);
+        uint32_t tail_size = (current.payload != NULL)? std::min(size - head_size, current.payload_size) : 0;
+        memcpy(current.buffer, data, head_size);
+        if (tail_size > 0) memcpy(current.payload, data + head_size, tail_size);
+        current.size = head_size + tail_size;
+
+#ifdef ENABLE_INSTRUMENTATION
+        // Call handler
+        if (ims_socket_handler_recv) {
+            ims_socket_handler_recv(data, current.size,
+                                    inet_ntoa(staging.from.sin_addr), ntohs(staging.from.sin_port));
+        }
+#endif
+        staging.segment_next++;
+        received++;
+    }
+
+    return received;
+}
+#endif
+
+//
+// Drain all pending datagrams, only keep the latest one
+//
+uint32_t socket::receive_latest(char* buffer, uint32_t buffer_size, uint32_t& latest_size)
+throw(ims::exception)
+{
+    return receive_latest(buffer, buffer_size, NULL, 0, latest_size);
+}
+
+uint32_t socket::receive_latest(char* header, uint32_t header_size,
+                                char* payload, uint32_t payload_size,
+                                uint32_t& latest_size)
+throw(ims::exception)
+{
+    datagram datagrams[RECEIVE_LATEST_SLOTS];
+    for (uint32_t id = 0; id < RECEIVE_LATEST_SLOTS; id++) {
+        datagrams[id].buffer = header;
+        datagrams[id].buffer_size = header_size;
+        datagrams[id].payload = payload;
+        datagrams[id].payload_size = payload_size;
+    }
+
+    // All slots share the same buffer. Read them one by one if someone
+    // wants to see each datagram content.
+    uint32_t slots = RECEIVE_LATEST_SLOTS;
+#ifdef ENABLE_INSTRUMENTATION
+    if (ims_socket_handler_recv) slots = 1;
+#endif
+
+    uint32_t total = 0;
+    uint32_t received;
+    do {
+        received = receive_many(datagrams, slots);
+        for (uint32_t id = 0; id < received; id++) {
+            // A datagram which stopped in the header didn't overwrite the payload
+            if (payload == NULL || datagrams[id].size > header_size) {
+                latest_size = datagrams[id].size;
+            }
+        }
+        total += received;
+    } while (received == slots);
+
+    return total;
+}
+
+//
+// Write a header and its payload: default implementation assembles them
+//
+void socket::send_gather(const char* header, uint32_t header_size,
+                         const char* payload, uint32_t payload_size)
+throw(ims::exception)
+{
+    std::vector<char> whole(header, header + header_size);
+    whole.insert(whole.end(), payload, payload + payload_size);
+    send(&whole[0], whole.size());
+}
+
+//
+// Write a datagram to the given address
+//
+void socket::write_to(const struct sockaddr_in& saddr,
+                      const char* header, uint32_t header_size,
+                      const char* payload, uint32_t payload_size)
+throw(ims::exception)
+{
+#ifdef ENABLE_INSTRUMENTATION
+    // Call handler
+    if(ims_socket_handler_send){
+        if (payload == NULL) {
+            ims_socket_handler_send(header, header_size,
+                                    inet_ntoa(saddr.sin_addr), ntohs(saddr.sin_port));
+        } else {
+            std::vector<char> whole(header, header + header_size);
+            whole.insert(whole.end(), payload, payload + payload_size);
+            ims_socket_handler_send(&whole[0], whole.size(),
+                                    inet_ntoa(saddr.sin_addr), ntohs(saddr.sin_port));
+        }
+    }
+#endif
+
+#ifdef VISTAS_HAVE_PACER
+    // Outputs without fd send through the carrier of their batch
+    if (_pacer != NULL) {
+        _pacer->push(this, (_sock != INVALID_SOCKET)? _sock : _batch_fd, saddr,
+                     header, header_size, payload, payload_size);
+        return;
+    }
+#endif
+
+    if (_send_batch != NULL && _send_batch->is_open()) {
+        _send_batch->stage(this, _batch_fd, saddr, header, header_size, payload, payload_size);
+        return;
+    }
+
+    uint32_t size = header_size + payload_size;
+    int32_t sent_size;
+#ifdef __linux
+    struct iovec iovecs[2];
+    iovecs[0].iov_base = (void*)header;
+    iovecs[0].iov_len = header_size;
+    iovecs[1].iov_base = (void*)payload;
+    iovecs[1].iov_len = payload_size;
+
+    struct msghdr message;
+    memset(&message, 0, sizeof(struct msghdr));
+    message.msg_name = (void*)&saddr;
+    message.msg_namelen = sizeof(struct sockaddr_in);
+    message.msg_iov = iovecs;
+    message.msg_iovlen = (payload != NULL)? 2 : 1;
+
+    // Outputs without fd send through the carrier of their batch
+    sent_size = sendmsg((_sock != INVALID_SOCKET)? _sock : _batch_fd, &message, 0);
+#else
+    WSABUF buffers[2];
+    buffers[0].buf = (char*)header;
+    buffers[0].len = header_size;
+    buffers[1].buf = (char*)payload;
+    buffers[1].len = payload_size;
+
+    DWORD sent = 0;
+    sent_size = (WSASendTo(_sock, buffers, (payload != NULL)? 2 : 1, &sent, 0,
+                           (const struct sockaddr*)&saddr, sizeof(struct sockaddr_in), NULL, NULL) == 0)? sent : -1;
+#endif
+
+    // Socket buffer full: never block nor abort the sending cycle
+    if (sent_size < 0 && (wouldblock() || errno == ENOBUFS)) {
+        if (_send_batch != NULL) {
+            _send_batch->retry(this, (_sock != INVALID_SOCKET)? _sock : _batch_fd, saddr,
+                               header, header_size, payload, payload_size);
+        } else {
+            __atomic_add_fetch(&_dropped_count, 1, __ATOMIC_RELAXED);
+        }
+        return;
+    }
+
+    if (sent_size < 0 || (unsigned)sent_size != size) {
+        THROW_IMS_ERROR(ims_implementation_specific_error, to_string() << ": Failed to write to socket! errno:" << socket::getlasterror());
+    }
+}
+
+//
+// Set the socket to blocking
+//
+void socket::set_blocking(bool blocking)
+throw(ims::exception)
+{
+#ifdef _WIN32
+    unsigned long mode = blocking ? 0 : 1;
+    if (ioctlsocket(_sock, FIONBIO, &mode) != 0) {
+#else
+    int flags = fcntl(_sock, F_GETFL, 0);
+    flags = blocking ? (flags&~O_NONBLOCK) : (flags|O_NONBLOCK);
+    if (fcntl(_sock, F_SETFL, flags) != 0) {
+#endif
+        THROW_IMS_ERROR(ims_implementation_specific_error, to_string() << ": Failed to set socket blocking mode. error: " << socket::getlasterror());
+    }
 }
 
 char * socket::getlasterror()
@@ -22,9 +22,13 @@
 
 #ifdef __linux
 #include <arpa/inet.h>
+#include <netinet/udp.h>
 #include <string.h>
 #define IMS_SOCKET int
 #define INVALID_SOCKET (-1)
+#ifdef UDP_GRO
+#define VISTAS_HAVE_UDP_GRO
+#endif
 #endif
 #ifdef _WIN32
 #define FD_SETSIZE 2048
@@ -47,6 +51,13 @@ namespace vistas
 class socket;
 typedef shared_ptr<socket> socket_ptr;
 
+class send_batch;
+class send_retry;
+class pacer;
+class uring;
+struct uring_inbox;
+class io_inbox;
+
 class socket
 {
     // Store information on emmiter
@@ -58,6 +69,20 @@ public:
         struct sockaddr_in saddr;
     };
 
+    // A datagram slot for batched receive.
+    // If payload is set, the bytes beyond buffer_size are scattered in it,
+    // so a header and its payload can be read in separate buffers.
+    struct datagram
+    {
+        inline datagram();
+
+        char*    buffer;        // Slot buffer
+        uint32_t buffer_size;   // Slot buffer size
+        uint32_t size;          // Received size (both segments)
+        char*    payload;       // Optional second segment
+        uint32_t payload_size;  // Second segment size
+    };
+
 public:
     // Address associated with this socket
     inline socket_address_ptr get_address();
@@ -68,10 +93,35 @@ public:
     virtual uint32_t receive(char* buffer, uint32_t buffer_size, client* client = NULL)
     throw(ims::exception) = 0;
 
+    // Receive up to count pending datagrams in the given slots without blocking.
+    // @return The number of datagrams received, 0 when none is pending.
+    virtual uint32_t receive_many(datagram* datagrams, uint32_t count)
+    throw(ims::exception);
+
+    // Drain all pending datagrams in the same buffer, so only the latest one
+    // is left in it. Its size is returned in latest_size.
+    // @return The number of datagrams received, 0 when none is pending.
+    uint32_t receive_latest(char* buffer, uint32_t buffer_size, uint32_t& latest_size)
+    throw(ims::exception);
+
+    // Same as above, but the datagrams are scattered between header and payload.
+    // latest_size is the size of the latest datagram which reached the payload,
+    // as it is the one left in the payload buffer.
+    uint32_t receive_latest(char* header, uint32_t header_size,
+                            char* payload, uint32_t payload_size,
+                            uint32_t& latest_size)
+    throw(ims::exception);
+
     // Write to the socket
     virtual void send(const char* buffer, uint32_t size)
     throw(ims::exception) = 0;
 
+    // Write a datagram made of a header followed by a payload, without
+    // assembling them. Default implementation copies them and calls send().
+    virtual void send_gather(const char* header, uint32_t header_size,
+                             const char* payload, uint32_t payload_size)
+    throw(ims::exception);
+
     // Reply to the emmiter
     virtual void reply(client& client, const char* buffer, uint32_t size)
     throw(ims::exception) = 0;
@@ -86,6 +136,41 @@ public:
 
     // Return associated file descriptor
     inline IMS_SOCKET get_fd();
+
+    // Set the socket to blocking
+    void set_blocking(bool blocking)
+    throw(ims::exception);
+
+    // Stage sent datagrams in the given batch while it is open (@see send_batch).
+    // They will be submitted through batch_fd.
+    inline void set_send_batch(send_batch* batch, IMS_SOCKET batch_fd);
+
+    // Send the datagrams through the given pacer (@see pacer), which knows
+    // the socket by pacer_id
+    inline void set_pacer(pacer* pacer, uint32_t pacer_id);
+
+    // Datagrams the socket buffer could not take at once, retried by the send
+    // batch, and the ones dropped because too many were waiting
+    inline uint32_t get_retried_count();
+    inline uint32_t get_dropped_count();
+
+    // Read received datagrams from the inbox, filled by the ring, instead of
+    // the socket (@see uring). A NULL ring restores direct reads.
+    inline void set_uring(uring* ring, uring_inbox* inbox);
+
+    // Read received datagrams from the inbox, filled by the I/O thread,
+    // instead of the socket (@see io_thread). NULL restores direct reads.
+    inline void set_io_inbox(io_inbox* inbox);
+
+    // Let the kernel coalesce bursts of same-size datagrams (UDP_GRO).
+    // receive_many splits them again, at the cost of a copy: only for sockets
+    // read directly, not by the ring or the I/O thread.
+    // @return false if the socket or the kernel doesn't support it
+    bool set_gro(bool enabled);
+
+    // Set the size of the socket send buffer (SO_SNDBUF), as doubled by the kernel.
+    // @return false if the socket refuses it
+    bool set_send_buffer_size(uint32_t size);
     
     // get a string with last socket error
     static char * getlasterror();
@@ -106,15 +191,60 @@ protected:
     // Deinitialize the socket
     void close();
 
+    // Write a datagram to the given address, for output sockets.
+    // payload may be NULL. It is staged in the send batch while it is open.
+    void write_to(const struct sockaddr_in& saddr,
+                  const char* header, uint32_t header_size,
+                  const char* payload, uint32_t payload_size)
+    throw(ims::exception);
+
+#ifdef VISTAS_HAVE_UDP_GRO
+    // Coalesced datagram being split
+    struct gro_staging;
+
+    // Hand the segments of coalesced datagrams, like recvmmsg
+    uint32_t receive_gro(datagram* datagrams, uint32_t count)
+    throw(ims::exception);
+#endif
+
+    friend class send_batch;
+    friend class pacer;
+
     IMS_SOCKET         _sock;
     socket_address_ptr _address;
+    send_batch*        _send_batch;
+    IMS_SOCKET         _batch_fd;
+    send_retry*        _send_retry;     // Owned, managed by the send batch. NULL while no datagram waits.
+    uint32_t           _retried_count;
+    uint32_t           _dropped_count;
+    pacer*             _pacer;          // NULL when not paced
+    uint32_t           _pacer_id;
+    uring*             _uring;
+    uring_inbox*       _uring_inbox;
+    io_inbox*          _io_inbox;
+#ifdef VISTAS_HAVE_UDP_GRO
+    gro_staging*       _gro;            // NULL when GRO is disabled
+#endif
 };
 
 //***************************************************************************
 // Inlines
 //***************************************************************************
 socket::socket() :
-    _sock(INVALID_SOCKET)
+    _sock(INVALID_SOCKET),
+    _send_batch(NULL),
+    _batch_fd(INVALID_SOCKET),
+    _send_retry(NULL),
+    _retried_count(0),
+    _dropped_count(0),
+    _pacer(NULL),
+    _pacer_id(0),
+    _uring(NULL),
+    _uring_inbox(NULL),
+    _io_inbox(NULL)
+#ifdef VISTAS_HAVE_UDP_GRO
+    , _gro(NULL)
+#endif
 {
 }
 
@@ -134,6 +264,48 @@ IMS_SOCKET socket::get_fd()
     return _sock;
 }
 
+void socket::set_send_batch(send_batch* batch, IMS_SOCKET batch_fd)
+{
+    _send_batch = batch;
+    _batch_fd = batch_fd;
+}
+
+void socket::set_pacer(pacer* pacer, uint32_t pacer_id)
+{
+    _pacer = pacer;
+    _pacer_id = pacer_id;
+}
+
+uint32_t socket::get_retried_count()
+{
+    return __atomic_load_n(&_retried_count, __ATOMIC_RELAXED);
+}
+
+uint32_t socket::get_dropped_count()
+{
+    return __atomic_load_n(&_dropped_count, __ATOMIC_RELAXED);
+}
+
+void socket::set_uring(uring* ring, uring_inbox* inbox)
+{
+    _uring = ring;
+    _uring_inbox = inbox;
+}
+
+void socket::set_io_inbox(io_inbox* inbox)
+{
+    _io_inbox = inbox;
+}
+
+socket::datagram::datagram() :
+    buffer(NULL),
+    buffer_size(0),
+    size(0),
+    payload(NULL),
+    payload_size(0)
+{
+}
+
 socket::client::client()
 {
     memset(&saddr, 0, sizeof(sockaddr_in));
@@ -39,7 +39,9 @@ socket_address_t::socket_address_t(ims_direction_t direction,
     _target_port(target_port),
     _interface_ip(interface_ip),
     _TTL(TTL),
-    _outgoing_port(outgoing_port)
+    _outgoing_port(outgoing_port),
+    _bag_us(0),
+    _priority(0)
 {
     if (_direction == ims_input && outgoing_port != 0)
     {
@@ -74,6 +76,8 @@ std::string socket_address_t::to_string()
     if (_interface_ip.empty() == false) ss << " on interface " << _interface_ip;
     if (_TTL != 1) ss << " with TTL " << _TTL;
     if (_outgoing_port != 0) ss << " ouput port " << _outgoing_port;
+    if (_bag_us != 0) ss << " BAG " << _bag_us << "us";
+    if (_priority != 0) ss << " priority " << _priority;
     return ss.str();
 }
 
@@ -88,4 +92,16 @@ bool socket_address_t::is_multicast() const
     
     return (addr_int & ip_mask) == multicast_prefix;
 }
+
+static const uint32_t loopback_mask = 0xFF;
+static const uint32_t loopback_prefix = 0x7F;
+
+bool socket_address_t::is_local() const
+{
+    // loopback addresses are in the range 127.0.0.0 - 127.255.255.255
+    if ((inet_addr(_target_ip.c_str()) & loopback_mask) == loopback_prefix) return true;
+
+    return is_multicast() && _interface_ip.empty() == false &&
+           (inet_addr(_interface_ip.c_str()) & loopback_mask) == loopback_prefix;
+}
 }
@@ -27,6 +27,9 @@
 #include <tr1/unordered_map>
 #include "shared_ptr.hh"
 
+// Number of port priorities: from 0, the default, to VISTAS_PRIORITY_COUNT - 1, the highest
+#define VISTAS_PRIORITY_COUNT 4
+
 namespace vistas
 {
 class socket_address_t;
@@ -51,8 +54,14 @@ public:
     inline std::string get_interface_ip() const;
     inline uint32_t get_TTL() const;
     inline uint32_t get_outgoing_port() const;
+    inline uint32_t get_bag_us() const;
+    inline uint32_t get_priority() const;
     bool is_multicast() const;
 
+    // Return true if the traffic never leaves the host: loopback target,
+    // or multicast sent on the loopback interface.
+    bool is_local() const;
+
     // Setters
     inline void set_direction(ims_direction_t direction);
     inline void set_ip(std::string target_ip);
@@ -60,6 +69,14 @@ public:
     inline void set_interface_ip(std::string interface_ip);
     inline void set_TTL(uint32_t TTL);
     inline void set_outgoing_port(uint32_t outgoing_port);
+
+    // Bandwidth allocation gap of an output: min time between two of its
+    // datagrams, in us. 0 when not paced.
+    inline void set_bag_us(uint32_t bag_us);
+
+    // Priority of the port: its datagrams are sent, and read, before the
+    // ones of lower priorities. Below VISTAS_PRIORITY_COUNT.
+    inline void set_priority(uint32_t priority);
     
     // Map key function
     // Only field direction, target_ip, target_port are used.
@@ -78,6 +95,8 @@ private:
     std::string     _interface_ip;
     uint32_t        _TTL;
     uint32_t        _outgoing_port;
+    uint32_t        _bag_us;
+    uint32_t        _priority;
     size_t          _hash;
 };
 }
@@ -177,4 +196,24 @@ void vistas::socket_address_t::set_outgoing_port(uint32_t outgoing_port)
     _outgoing_port = outgoing_port;
 }
 
+uint32_t vistas::socket_address_t::get_bag_us() const
+{
+    return _bag_us;
+}
+
+void vistas::socket_address_t::set_bag_us(uint32_t bag_us)
+{
+    _bag_us = bag_us;
+}
+
+uint32_t vistas::socket_address_t::get_priority() const
+{
+    return _priority;
+}
+
+void vistas::socket_address_t::set_priority(uint32_t priority)
+{
+    _priority = priority;
+}
+
 #endif
@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// In-process loopback socket.
+//
+#include "vistas_socket_loopback.hh"
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+namespace vistas
+{
+
+socket_loopback::socket_loopback(socket_address_ptr address)
+throw(ims::exception)
+{
+    _address = address;
+
+    std::stringstream key;
+    key << address->get_ip() << ':' << address->get_port();
+    _channel = get_channel(key.str());
+
+    if (address->get_direction() == ims_input) {
+        _inbox.allocate();
+
+        spinlock::guard guard(_channel->lock);
+        _channel->readers.push_back(this);
+    }
+}
+
+socket_loopback::~socket_loopback()
+{
+    spinlock::guard guard(_channel->lock);
+    std::vector<socket_loopback*>::iterator ireader = std::find(_channel->readers.begin(),
+                                                                _channel->readers.end(), this);
+    if (ireader != _channel->readers.end()) {
+        _channel->readers.erase(ireader);
+    }
+}
+
+//
+// Channels are never freed: there is one per address of the configurations
+//
+socket_loopback::channel_ptr socket_loopback::get_channel(const std::string& key)
+{
+    static spinlock                           registry_lock;
+    static std::map<std::string, channel_ptr> registry;
+
+    spinlock::guard guard(registry_lock);
+    channel_ptr& channel = registry[key];
+    if (!channel) {
+        channel = channel_ptr(new socket_loopback::channel);
+    }
+    return channel;
+}
+
+//
+// Copy the datagram in the inbox of each reader. Emitters of the channel
+// take turns, so each inbox still has a single producer.
+//
+void socket_loopback::publish(const char* header, uint32_t header_size,
+                              const char* payload, uint32_t payload_size)
+throw(ims::exception)
+{
+#ifdef ENABLE_INSTRUMENTATION
+    // Call handler
+    if (ims_socket_handler_send) {
+        std::vector<char> whole(header, header + header_size);
+        if (payload != NULL) whole.insert(whole.end(), payload, payload + payload_size);
+        ims_socket_handler_send(&whole[0], whole.size(),
+                                _address->get_ip().c_str(), _address->get_port());
+    }
+#endif
+
+    struct sockaddr_in from;
+    memset(&from, 0, sizeof(from));
+    from.sin_family = AF_INET;
+    from.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    spinlock::guard guard(_channel->lock);
+    for (uint32_t ireader = 0; ireader < _channel->readers.size(); ireader++) {
+        if (_channel->readers[ireader]->_inbox.push(header, header_size, payload, payload_size, from) == false) {
+            LOG_ERROR_RATE_LIMITED(to_string() << ": datagram lost, the reader is full.");
+        }
+    }
+}
+
+void socket_loopback::send(const char* buffer, uint32_t size)
+throw(ims::exception)
+{
+    publish(buffer, size, NULL, 0);
+}
+
+void socket_loopback::send_gather(const char* header, uint32_t header_size,
+                                  const char* payload, uint32_t payload_size)
+throw(ims::exception)
+{
+    publish(header, header_size, payload, payload_size);
+}
+
+uint32_t socket_loopback::receive_many(datagram* datagrams, uint32_t count)
+throw(ims::exception)
+{
+    if (_address->get_direction() != ims_input) return 0;
+    return _inbox.receive_many(datagrams, count);
+}
+
+//
+// Receive the next datagram
+//
+uint32_t socket_loopback::receive(char* buffer, uint32_t buffer_size, client* client)
+throw(ims::exception)
+{
+    datagram slot;
+    slot.buffer = buffer;
+    slot.buffer_size = buffer_size;
+
+    if (receive_many(&slot, 1) == 0) return 0;
+
+    fill_client(client);
+    return slot.size;
+}
+
+//
+// Return true if datagrams are waiting for this reader
+//
+bool socket_loopback::has_pending()
+{
+    return _address->get_direction() == ims_input && _inbox.empty() == false;
+}
+
+}
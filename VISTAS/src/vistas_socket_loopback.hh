@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// In-process loopback socket.
+// Contexts of the same process exchange the datagrams of a channel directly:
+// a send copies the datagram in the inbox of every reader of the same
+// address, whatever the order the contexts were created in. No syscall,
+// and the datagram is available to the next import of the readers.
+// Datagrams sent while no reader exists are dropped, as on the network.
+//
+#ifndef _VISTAS_SOCKET_LOOPBACK_HH_
+#define _VISTAS_SOCKET_LOOPBACK_HH_
+#include "vistas_socket_memory.hh"
+#include "vistas_io_thread.hh"
+#include "vistas_sync.hh"
+#include <vector>
+
+namespace vistas
+{
+class socket_loopback;
+typedef shared_ptr<socket_loopback> socket_loopback_ptr;
+
+class socket_loopback : public socket_memory
+{
+public:
+    // Join the channel of the given address. An input starts reading it.
+    socket_loopback(socket_address_ptr address)
+    throw(ims::exception);
+
+    // An input stops reading the channel
+    ~socket_loopback();
+
+    // Receive the next datagram
+    uint32_t receive(char* buffer, uint32_t buffer_size, client* client = NULL)
+    throw(ims::exception);
+
+    // Receive up to count pending datagrams
+    uint32_t receive_many(datagram* datagrams, uint32_t count)
+    throw(ims::exception);
+
+    // Copy a datagram to every reader of the channel
+    void send(const char* buffer, uint32_t size)
+    throw(ims::exception);
+
+    // Copy a header and its payload to every reader of the channel
+    void send_gather(const char* header, uint32_t header_size,
+                     const char* payload, uint32_t payload_size)
+    throw(ims::exception);
+
+    // Return true if datagrams are waiting for this reader
+    bool has_pending();
+
+private:
+    // Sockets of one address, shared by all the contexts of the process
+    struct channel
+    {
+        spinlock                      lock;
+        std::vector<socket_loopback*> readers;
+    };
+    typedef shared_ptr<channel> channel_ptr;
+
+    // Return the channel of the address, created on first use
+    static channel_ptr get_channel(const std::string& key);
+
+    void publish(const char* header, uint32_t header_size,
+                 const char* payload, uint32_t payload_size)
+    throw(ims::exception);
+
+    channel_ptr _channel;
+    io_inbox    _inbox;         // Inputs only
+};
+
+}
+#endif
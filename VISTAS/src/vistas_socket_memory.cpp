@@ -0,0 +1,44 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Base of the memory sockets
+//
+#include "vistas_socket_memory.hh"
+
+namespace vistas
+{
+
+//
+// Reply to the emmiter
+//
+void socket_memory::reply(__attribute__((__unused__)) client& client,
+                          __attribute__((__unused__)) const char* buffer,
+                          __attribute__((__unused__)) uint32_t size)
+throw(ims::exception)
+{
+    THROW_IMS_ERROR(ims_invalid_configuration, to_string() << ": Cannot reply through a memory socket!");
+}
+
+//
+// Same host, unknown emitter
+//
+void socket_memory::fill_client(client* client)
+{
+    if (client == NULL) return;
+
+    client->saddr.sin_family = AF_INET;
+    client->saddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    client->saddr.sin_port = 0;
+}
+
+}
@@ -0,0 +1,41 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Base of the sockets exchanging datagrams through memory instead of the
+// network stack. They have no fd: the socket pool asks them at each import
+// if datagrams are pending.
+//
+#ifndef _VISTAS_SOCKET_MEMORY_HH_
+#define _VISTAS_SOCKET_MEMORY_HH_
+#include "vistas_socket.hh"
+
+namespace vistas
+{
+
+class socket_memory : public socket
+{
+public:
+    // Return true if datagrams are waiting for this reader
+    virtual bool has_pending() = 0;
+
+    // Will always throw: there is no emitter address
+    void reply(client& client, const char* buffer, uint32_t size)
+    throw(ims::exception);
+
+protected:
+    // Fill the emitter information of a received datagram: same host, unknown emitter
+    static void fill_client(client* client);
+};
+
+}
+#endif
@@ -46,6 +46,9 @@ throw(ims::exception)
         THROW_IMS_ERROR(ims_init_failure, to_string() << ": Error while binding socket to port '" << address->get_port() << "'.");
     }
 
+    // Pending datagrams are drained without blocking
+    set_blocking(false);
+
     // Join the multicast group
     struct ip_mreq imreq;
     memset(&imreq, 0, sizeof(struct ip_mreq));
@@ -76,6 +79,8 @@ throw(ims::exception)
     }
 
     if (res < 0) {
+        // Nothing pending
+        if (socket::wouldblock()) return 0;
 #ifdef _WIN32
         // Data truncated to buffer size
         if (WSAGetLastError() == WSAEMSGSIZE) return buffer_size;
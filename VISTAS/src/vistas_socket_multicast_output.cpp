@@ -68,7 +68,28 @@ throw(ims::exception)
         THROW_IMS_ERROR(ims_init_failure, to_string() << ": Failed to setup multicast loop interface.");
     }
 
-    // Set destination multicast address
+    // A full socket buffer must not stall the sending cycle (@see send_batch)
+    set_blocking(false);
+
+    set_destination(address);
+}
+
+void socket_multicast_output::create_shared(socket_address_ptr address)
+throw(ims::exception)
+{
+    if (address->get_outgoing_port() != 0) {
+        THROW_IMS_ERROR(ims_init_failure, address->to_string() << ": An output with an outgoing port needs its own socket!");
+    }
+
+    _address = address;
+    set_destination(address);
+}
+
+//
+// Set destination multicast address
+//
+void socket_multicast_output::set_destination(socket_address_ptr address)
+{
     _saddr.sin_family = PF_INET;
     _saddr.sin_addr.s_addr = inet_addr(address->get_ip().c_str());
     _saddr.sin_port = htons(address->get_port());
@@ -92,21 +113,17 @@ throw(ims::exception)
 void socket_multicast_output::send(const char* buffer, uint32_t size)
 throw(ims::exception)
 {
-#ifdef ENABLE_INSTRUMENTATION
-    // Call handler
-    if(ims_socket_handler_send){
-        ims_socket_handler_send(buffer,
-                                size,
-                                inet_ntoa(_saddr.sin_addr),
-                                ntohs(_saddr.sin_port));
-    }
-#endif
-
-    int32_t sent_size = sendto(_sock, buffer, size, 0, (struct sockaddr *)&_saddr, _socklen);
+    write_to(_saddr, buffer, size, NULL, 0);
+}
 
-    if (sent_size < 0 || (unsigned)sent_size != size) {
-        THROW_IMS_ERROR(ims_implementation_specific_error, to_string() << ": Failed to write to socket! errno:" << socket::getlasterror());
-    }
+//
+// Write a header and its payload to the socket
+//
+void socket_multicast_output::send_gather(const char* header, uint32_t header_size,
+                                          const char* payload, uint32_t payload_size)
+throw(ims::exception)
+{
+    write_to(_saddr, header, header_size, payload, payload_size);
 }
 
 //
@@ -40,6 +40,14 @@ public:
     void create(socket_address_ptr address)
     throw(ims::exception);
 
+    //
+    // Initialize an output socket without its own fd. It must have no
+    // outgoing port: its datagrams are sent by the carrier socket shared with
+    // the other outputs of the same interface (@see send_batch::attach).
+    //
+    void create_shared(socket_address_ptr address)
+    throw(ims::exception);
+
     // Receive from the socket
     // Will always thow error::invalid_direction.
     virtual uint32_t receive(char* buffer, uint32_t buffer_size, client* client = NULL)
@@ -48,12 +56,20 @@ public:
     // Write to the socket
     virtual void send(const char* buffer, uint32_t size) throw(ims::exception);
 
+    // Write a header and its payload to the socket
+    virtual void send_gather(const char* header, uint32_t header_size,
+                             const char* payload, uint32_t payload_size)
+    throw(ims::exception);
+
     // Reply to the emmiter
     // Will always thow error::invalid_direction.
     virtual void reply(client& client,const char* buffer, uint32_t size)
     throw(ims::exception);
 
 private:
+    // Set the destination multicast address
+    void set_destination(socket_address_ptr address);
+
     struct sockaddr_in _saddr;
     socklen_t          _socklen;
 };
@@ -0,0 +1,323 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Multicast inputs sharing one socket per UDP port (Linux only).
+//
+#include "vistas_socket_multicast_shared.hh"
+
+#ifdef VISTAS_HAVE_SHARED_MULTICAST
+#include <algorithm>
+#include <errno.h>
+#include <linux/filter.h>
+#include <string.h>
+#include <sys/socket.h>
+
+// Max datagrams read by one drain call
+#define DRAIN_MAX 64
+
+namespace vistas
+{
+
+/*
+* Constant for setsockopt calls
+*/
+static const __attribute__((__unused__)) int zero = 0;
+static const __attribute__((__unused__)) int one = 1;
+
+//===========================================================================
+// Shared socket
+//===========================================================================
+socket_multicast_shared::socket_multicast_shared(uint16_t port, const std::string& interface_ip)
+throw(ims::exception)
+{
+    socket::create(socket_address_ptr(new socket_address_t(ims_input, "0.0.0.0", port, interface_ip)), SOCK_DGRAM);
+
+    // Bound to the port only: the groups are told apart by their destination address
+    struct sockaddr_in saddr;
+    memset(&saddr, 0, sizeof(sockaddr_in));
+    saddr.sin_family = PF_INET;
+    saddr.sin_port = htons(port);
+    saddr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(_sock, (struct sockaddr *)&saddr, sizeof(struct sockaddr_in)) != 0) {
+        close();
+        THROW_IMS_ERROR(ims_init_failure, to_string() << ": Error while binding socket to port '" << port << "'.");
+    }
+
+    // Only the groups joined by this socket, not the ones of the other sockets of the host
+    if (setsockopt(_sock, IPPROTO_IP, IP_MULTICAST_ALL, (const char*) &zero, sizeof(zero)) != 0) {
+        close();
+        THROW_IMS_ERROR(ims_init_failure, to_string() << ": Failed to disable IP_MULTICAST_ALL.");
+    }
+
+    // Destination address of each datagram
+    if (setsockopt(_sock, IPPROTO_IP, IP_PKTINFO, (const char*) &one, sizeof(one)) != 0) {
+        close();
+        THROW_IMS_ERROR(ims_init_failure, to_string() << ": Failed to enable IP_PKTINFO.");
+    }
+
+    set_blocking(false);
+}
+
+//
+// Join the group of the member
+//
+bool socket_multicast_shared::join(socket_multicast_member* member)
+throw(ims::exception)
+{
+    socket_address_ptr address = member->get_address();
+
+    struct ip_mreq imreq;
+    memset(&imreq, 0, sizeof(struct ip_mreq));
+    imreq.imr_multiaddr.s_addr = inet_addr(address->get_ip().c_str());
+    if (address->get_interface_ip().empty() == false) {
+        imreq.imr_interface.s_addr = inet_addr(address->get_interface_ip().c_str());
+    } else {
+        imreq.imr_interface.s_addr = htonl(INADDR_ANY);
+    }
+    if (setsockopt(_sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char *)&imreq, sizeof(struct ip_mreq)) != 0) {
+        if (errno == ENOBUFS && _members.empty() == false) return false;
+        THROW_IMS_ERROR(ims_init_failure, to_string() << ": Failed to join multicast group for address " <<
+                        address->to_string() << ". error: " << socket::getlasterror());
+    }
+
+    _members[imreq.imr_multiaddr.s_addr] = member;
+    return true;
+}
+
+//
+// Leave the group of the member
+//
+void socket_multicast_shared::leave(socket_multicast_member* member)
+{
+    socket_address_ptr address = member->get_address();
+
+    struct ip_mreq imreq;
+    memset(&imreq, 0, sizeof(struct ip_mreq));
+    imreq.imr_multiaddr.s_addr = inet_addr(address->get_ip().c_str());
+    if (address->get_interface_ip().empty() == false) {
+        imreq.imr_interface.s_addr = inet_addr(address->get_interface_ip().c_str());
+    } else {
+        imreq.imr_interface.s_addr = htonl(INADDR_ANY);
+    }
+    setsockopt(_sock, IPPROTO_IP, IP_DROP_MEMBERSHIP, (const char *)&imreq, sizeof(struct ip_mreq));
+
+    _members.erase(imreq.imr_multiaddr.s_addr);
+}
+
+//
+// The filter sees the datagram from its UDP header
+//
+void socket_multicast_shared::drop_small_datagrams(uint32_t max_size)
+throw(ims::exception)
+{
+    struct sock_filter code[] = {
+        BPF_STMT(BPF_LD  | BPF_W   | BPF_LEN, 0),
+        BPF_JUMP(BPF_JMP | BPF_JGT | BPF_K,   max_size, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K,             0xFFFF),
+        BPF_STMT(BPF_RET | BPF_K,             0),
+    };
+    struct sock_fprog filter;
+    filter.len = sizeof(code) / sizeof(code[0]);
+    filter.filter = code;
+
+    if (setsockopt(_sock, SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) != 0) {
+        THROW_IMS_ERROR(ims_init_failure, to_string() << ": Failed to attach socket filter. error: " << socket::getlasterror());
+    }
+}
+
+//
+// Read a batch of datagrams and hand them to their members
+//
+uint32_t socket_multicast_shared::drain(char* staging, uint32_t slot_size, uint32_t slot_count,
+                                        std::vector<socket_multicast_member*>& ready)
+throw(ims::exception)
+{
+    if (slot_count > DRAIN_MAX) slot_count = DRAIN_MAX;
+
+    struct mmsghdr     messages[DRAIN_MAX];
+    struct iovec       iovecs[DRAIN_MAX];
+    struct sockaddr_in clients[DRAIN_MAX];
+    char               controls[DRAIN_MAX][CMSG_SPACE(sizeof(struct in_pktinfo))];
+
+    memset(messages, 0, slot_count * sizeof(struct mmsghdr));
+    for (uint32_t id = 0; id < slot_count; id++) {
+        iovecs[id].iov_base = staging + id * slot_size;
+        iovecs[id].iov_len = slot_size;
+        messages[id].msg_hdr.msg_iov = &iovecs[id];
+        messages[id].msg_hdr.msg_iovlen = 1;
+        messages[id].msg_hdr.msg_name = &clients[id];
+        messages[id].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        messages[id].msg_hdr.msg_control = controls[id];
+        messages[id].msg_hdr.msg_controllen = sizeof(controls[id]);
+    }
+
+    int res = recvmmsg(_sock, messages, slot_count, MSG_DONTWAIT, NULL);
+    if (res < 0) {
+        if (wouldblock() || errno == EINTR) return 0;
+        THROW_IMS_ERROR(ims_implementation_specific_error, to_string() << ": Failed to read from socket. error: " << socket::getlasterror());
+    }
+
+    for (int id = 0; id < res; id++) {
+        uint32_t group = htonl(INADDR_ANY);
+        for (struct cmsghdr* control = CMSG_FIRSTHDR(&messages[id].msg_hdr);
+             control != NULL;
+             control = CMSG_NXTHDR(&messages[id].msg_hdr, control))
+        {
+            if (control->cmsg_level == IPPROTO_IP && control->cmsg_type == IP_PKTINFO) {
+                group = ((struct in_pktinfo*)CMSG_DATA(control))->ipi_addr.s_addr;
+                break;
+            }
+        }
+
+        // Unicast datagram to the same port, or group left meanwhile
+        member_map_t::iterator imember = _members.find(group);
+        if (imember == _members.end()) continue;
+
+        if (imember->second->deliver(staging + id * slot_size, messages[id].msg_len, clients[id])) {
+            ready.push_back(imember->second);
+        }
+    }
+
+    return res;
+}
+
+uint32_t socket_multicast_shared::receive(__attribute__((__unused__)) char* buffer,
+                                          __attribute__((__unused__)) uint32_t buffer_size,
+                                          __attribute__((__unused__)) client* client)
+throw(ims::exception)
+{
+    THROW_IMS_ERROR(ims_implementation_specific_error, to_string() << ": A shared socket is read through its members!");
+}
+
+void socket_multicast_shared::send(__attribute__((__unused__)) const char* buffer,
+                                   __attribute__((__unused__)) uint32_t size)
+throw(ims::exception)
+{
+    THROW_IMS_ERROR(ims_invalid_configuration, to_string() << ": Cannot send an input socket!");
+}
+
+//
+// Reply to the emmiter
+//
+void socket_multicast_shared::reply(client& client, const char* buffer, uint32_t size)
+throw(ims::exception)
+{
+#ifdef ENABLE_INSTRUMENTATION
+    // Call handler
+    if(ims_socket_handler_reply){
+        ims_socket_handler_reply(buffer,
+                                 size,
+                                 inet_ntoa(client.saddr.sin_addr),
+                                 ntohs(client.saddr.sin_port));
+    }
+#endif
+
+    int32_t sent_size = sendto(_sock, buffer, size, 0, (struct sockaddr *)&client.saddr, sizeof(client.saddr));
+
+    if (sent_size < 0 || (unsigned)sent_size != size) {
+        THROW_IMS_ERROR(ims_implementation_specific_error, to_string() << ": Failed to write to socket! errno:" << socket::getlasterror());
+    }
+}
+
+//===========================================================================
+// Member
+//===========================================================================
+socket_multicast_member::socket_multicast_member(socket_address_ptr address) :
+    _pending_next(0),
+    _pool_id(0)
+{
+    _address = address;
+}
+
+socket_multicast_member::~socket_multicast_member()
+{
+    if (_shared) _shared->leave(this);
+}
+
+bool socket_multicast_member::join(socket_multicast_shared_ptr shared)
+throw(ims::exception)
+{
+    if (shared->join(this) == false) return false;
+    _shared = shared;
+    return true;
+}
+
+//
+// Copy the datagrams handed by the shared socket, like recvmmsg
+//
+uint32_t socket_multicast_member::receive_many(datagram* datagrams, uint32_t count)
+throw(ims::exception)
+{
+    uint32_t received = 0;
+
+    while (received < count && _pending_next < _pending.size()) {
+        const pending_t& pending = _pending[_pending_next++];
+
+        // Same behaviour as recvmmsg: what doesn't fit in the buffer goes to the payload segment
+        datagram& current = datagrams[received];
+        uint32_t head_size = std::min(pending.size, current.buffer_size);
+        uint32_t tail_size = (current.payload != NULL)? std::min(pending.size - head_size, current.payload_size) : 0;
+        memcpy(current.buffer, pending.data, head_size);
+        if (tail_size > 0) memcpy(current.payload, pending.data + head_size, tail_size);
+        current.size = head_size + tail_size;
+
+#ifdef ENABLE_INSTRUMENTATION
+        // Call handler
+        if (ims_socket_handler_recv) {
+            ims_socket_handler_recv(pending.data, current.size,
+                                    inet_ntoa(pending.from.sin_addr), ntohs(pending.from.sin_port));
+        }
+#endif
+        received++;
+    }
+
+    return received;
+}
+
+//
+// Receive the next datagram
+//
+uint32_t socket_multicast_member::receive(char* buffer, uint32_t buffer_size, client* client)
+throw(ims::exception)
+{
+    if (_pending_next >= _pending.size()) return 0;
+    if (client != NULL) client->saddr = _pending[_pending_next].from;
+
+    datagram slot;
+    slot.buffer = buffer;
+    slot.buffer_size = buffer_size;
+    receive_many(&slot, 1);
+    return slot.size;
+}
+
+void socket_multicast_member::send(__attribute__((__unused__)) const char* buffer,
+                                   __attribute__((__unused__)) uint32_t size)
+throw(ims::exception)
+{
+    THROW_IMS_ERROR(ims_invalid_configuration, to_string() << ": Cannot send an input socket!");
+}
+
+//
+// Reply to the emmiter
+//
+void socket_multicast_member::reply(client& client, const char* buffer, uint32_t size)
+throw(ims::exception)
+{
+    if (!_shared) {
+        THROW_IMS_ERROR(ims_implementation_specific_error, to_string() << ": Socket has not joined its group!");
+    }
+    _shared->reply(client, buffer, size);
+}
+
+}
+#endif
@@ -0,0 +1,161 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Multicast inputs sharing one socket per UDP port (Linux only).
+// The shared socket joins the groups of all its members and reads their
+// datagrams at once. The destination group of each datagram, given by
+// IP_PKTINFO, tells which member it belongs to.
+// Members have no fd: the socket pool polls the shared socket instead.
+//
+#ifndef _VISTAS_SOCKET_MULTICAST_SHARED_HH_
+#define _VISTAS_SOCKET_MULTICAST_SHARED_HH_
+#include "vistas_socket.hh"
+#include <tr1/unordered_map>
+#include <vector>
+
+#ifdef __linux
+#define VISTAS_HAVE_SHARED_MULTICAST
+#endif
+
+namespace vistas
+{
+#ifdef VISTAS_HAVE_SHARED_MULTICAST
+class socket_multicast_shared;
+typedef shared_ptr<socket_multicast_shared> socket_multicast_shared_ptr;
+class socket_multicast_member;
+
+class socket_multicast_shared : public socket
+{
+public:
+    // Open the socket of the given UDP port, on the given interface ("" for any)
+    socket_multicast_shared(uint16_t port, const std::string& interface_ip)
+    throw(ims::exception);
+
+    // Join the group of the member and deliver its datagrams to it.
+    // @return false if the socket cannot join more groups (net.ipv4.igmp_max_memberships).
+    // A socket without member always joins, or throws.
+    bool join(socket_multicast_member* member)
+    throw(ims::exception);
+
+    // Leave the group of the member
+    void leave(socket_multicast_member* member);
+
+    // Only keep the datagrams bigger than max_size (UDP header included):
+    // the others are read from a packet ring (@see packet_ring)
+    void drop_small_datagrams(uint32_t max_size)
+    throw(ims::exception);
+
+    // Read up to slot_count datagrams in the staging slots and hand each one
+    // to the member of its destination group. Members which got datagrams are
+    // appended to ready: they are valid until the staging slots are reused.
+    // @return The number of datagrams read
+    uint32_t drain(char* staging, uint32_t slot_size, uint32_t slot_count,
+                   std::vector<socket_multicast_member*>& ready)
+    throw(ims::exception);
+
+    // Will always throw: datagrams are read through the members
+    uint32_t receive(char* buffer, uint32_t buffer_size, client* client = NULL)
+    throw(ims::exception);
+
+    // Will always throw: this is an input socket
+    void send(const char* buffer, uint32_t size)
+    throw(ims::exception);
+
+    // Reply to the emmiter of a datagram of a member
+    void reply(client& client, const char* buffer, uint32_t size)
+    throw(ims::exception);
+
+private:
+    typedef std::tr1::unordered_map<uint32_t, socket_multicast_member*> member_map_t;
+    member_map_t _members;      // By group address, in network order
+};
+
+class socket_multicast_member : public socket
+{
+public:
+    // Create a member of no shared socket. You have to call join.
+    socket_multicast_member(socket_address_ptr address);
+
+    // Leave the group
+    ~socket_multicast_member();
+
+    // Join the group of the address through the given shared socket
+    // @return false if it cannot join more groups: use another one.
+    bool join(socket_multicast_shared_ptr shared)
+    throw(ims::exception);
+
+    // Receive the next datagram handed by the shared socket
+    uint32_t receive(char* buffer, uint32_t buffer_size, client* client = NULL)
+    throw(ims::exception);
+
+    // Receive up to count datagrams handed by the shared socket
+    uint32_t receive_many(datagram* datagrams, uint32_t count)
+    throw(ims::exception);
+
+    // Will always throw: this is an input socket
+    void send(const char* buffer, uint32_t size)
+    throw(ims::exception);
+
+    // Reply through the shared socket
+    void reply(client& client, const char* buffer, uint32_t size)
+    throw(ims::exception);
+
+    inline socket_multicast_shared_ptr get_shared() { return _shared; }
+
+    // Input pool id of the member, used by the pool to find its port
+    inline uint32_t get_pool_id() { return _pool_id; }
+    inline void set_pool_id(uint32_t pool_id) { _pool_id = pool_id; }
+
+    // Shared socket side: hand a datagram of the staging slots
+    // @return true if it is the first one since the last clear
+    inline bool deliver(const char* data, uint32_t size, const struct sockaddr_in& from);
+
+    // Forget the datagrams not read, once the staging slots are reused
+    inline void clear_pending();
+
+private:
+    struct pending_t
+    {
+        const char*        data;
+        uint32_t           size;
+        struct sockaddr_in from;
+    };
+
+    socket_multicast_shared_ptr _shared;
+    std::vector<pending_t>      _pending;
+    uint32_t                    _pending_next;  // Next pending datagram to read
+    uint32_t                    _pool_id;
+};
+
+//***************************************************************************
+// Inlines
+//***************************************************************************
+bool socket_multicast_member::deliver(const char* data, uint32_t size, const struct sockaddr_in& from)
+{
+    pending_t pending;
+    pending.data = data;
+    pending.size = size;
+    pending.from = from;
+    _pending.push_back(pending);
+    return _pending.size() == 1;
+}
+
+void socket_multicast_member::clear_pending()
+{
+    _pending.clear();
+    _pending_next = 0;
+}
+
+#endif
+}
+#endif
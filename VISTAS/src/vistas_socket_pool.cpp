@@ -16,7 +16,11 @@
 #include "vistas_socket_pool.hh"
 #include "vistas_port.hh"
 #include "ims_time.hh"
+#include <algorithm>
 #include <errno.h>
+#ifdef __linux
+#include <unistd.h>
+#endif
 #include "vistas_socket_multicast_input.hh"
 #include "vistas_socket_multicast_output.hh"
 #include "vistas_socket_void.hh"
@@ -85,29 +89,71 @@ socket_pool_ptr socket_pool::factory::create_pool()
 {
     socket_pool_ptr pool = socket_pool_ptr(new socket_pool);
 
-    pool->_select_nfds = -1;
-    FD_ZERO(&pool->_select_set);
-
     pool->_input_pool.reserve(_addresses.size());
     pool->_output_pool.reserve(_addresses.size());
 
-    for (address_map_t::iterator iaddr = _addresses.begin();
-         iaddr != _addresses.end();
-         iaddr++)
+    if (_engine == socket_engine_io_uring) {
+        pool->enable_uring(_addresses.size());
+    }
+
+    if (_io_thread) {
+        pool->enable_io_thread(_addresses.size(), _io_thread_cpu, _io_thread_priority);
+    }
+
+    if (_engine == socket_engine_packet_ring) {
+        // Bound to the interface of the multicast inputs, or to all if they don't agree
+        std::string interface_ip;
+        bool first = true;
+        for (address_map_t::iterator iaddr = _addresses.begin(); iaddr != _addresses.end(); iaddr++) {
+            if (iaddr->first->get_direction() != ims_input || iaddr->first->is_multicast() == false) continue;
+            if (first) {
+                interface_ip = iaddr->first->get_interface_ip();
+                first = false;
+            } else if (interface_ip != iaddr->first->get_interface_ip()) {
+                interface_ip = "";
+            }
+        }
+        pool->enable_packet_ring(interface_ip);
+    }
+
+    if (_import_workers > 1) {
+        pool->enable_import_workers(_addresses.size(), _import_workers);
+    }
+
+    bool paced = (_max_frame_rate != 0);
+    for (address_map_t::iterator iaddr = _addresses.begin(); iaddr != _addresses.end() && paced == false; iaddr++) {
+        paced = (iaddr->first->get_direction() == ims_output && iaddr->first->get_bag_us() != 0);
+    }
+    if (paced) {
+        pool->enable_pacer(_max_frame_rate);
+    }
+
+    pool->_send_batch->set_send_buffer_size(_send_buffer_size);
+
+    // Highest priority first: pool ids give the order inputs are read in
+    std::vector<address_map_t::iterator> ordered;
+    ordered.reserve(_addresses.size());
+    for (int32_t priority = VISTAS_PRIORITY_COUNT - 1; priority >= 0; priority--) {
+        for (address_map_t::iterator iaddr = _addresses.begin(); iaddr != _addresses.end(); iaddr++) {
+            if (iaddr->first->get_priority() == (uint32_t)priority) ordered.push_back(iaddr);
+        }
+    }
+
+    for (uint32_t iordered = 0; iordered < ordered.size(); iordered++)
     {
+        address_map_t::iterator iaddr = ordered[iordered];
         uint32_t pool_id = 0;
 
         if (iaddr->first->get_direction() == ims_input)
         {
             pool_id = pool->_input_pool.size();
-            IMS_SOCKET fd = iaddr->second.socket->get_fd();
-            pool->_select_nfds = std::max( (int)(fd + 1), pool->_select_nfds);
-            FD_SET(fd, &pool->_select_set);
             pool->_input_pool.push_back(iaddr->second);
+            pool->poll_add(pool_id);
         }
         else {
             pool_id = pool->_output_pool.size();
             pool->_output_pool.push_back(iaddr->second);
+            pool->attach_output(iaddr->second.socket);
         }
 
         // add to the map which uses ip/port/direction as key
@@ -141,29 +187,729 @@ socket_pool_ptr socket_pool::factory::create_pool()
 //===========================================================================
 // Pool implementation
 //===========================================================================
-ims_return_code_t socket_pool::import(uint32_t timeout_us)
+socket_pool::socket_pool() :
+    _send_batch(new send_batch()),
+    _import_deadline(UINT64_MAX),
+    _import_priority(VISTAS_PRIORITY_COUNT)
 {
-    if (_select_nfds == -1)
-    {
-        // If no consumed data, _select_set is still at -1
-        // Avoid calling select, the call will fail
-        // Just return without any error
+#ifdef __linux
+    _epoll_count = 0;
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd < 0) {
+        THROW_IMS_ERROR(ims_init_failure, "Cannot create epoll instance! errno: " << errno);
+    }
+#else
+    _select_nfds = -1;
+    FD_ZERO(&_select_set);
+#endif
+}
 
-        return ims_no_error;
+socket_pool::~socket_pool()
+{
+    pause_io_thread();
+#ifdef VISTAS_HAVE_WORKER_POOL
+    _workers = worker_pool_ptr();
+    for (uint32_t ishard = 0; ishard < _shards.size(); ishard++) {
+        ::close(_shards[ishard].epoll_fd);
     }
-    
-    uint64_t begin = ims_get_real_time();
+#endif
+#ifdef __linux
+    ::close(_epoll_fd);
+#endif
+}
+
+#ifdef __linux
+// Max events handled by one epoll_wait call. Remaining ones are reported by the next call.
+#define IMPORT_EVENTS_MAX 64
+
+// Import workers: number of shards per thread. Shards are claimed one at a
+// time, so a thread done with a quiet shard takes the next one.
+#define IMPORT_SHARDS_PER_WORKER 4
+
+// io_uring engine: submission queue size and number of receive buffers
+#define URING_ENTRIES 256
+#define URING_BUFFERS 512
+
+// Event user data: the polled fd is kept along the pool id, so an event
+// concerning a socket replaced meanwhile by a data_exchange request is ignored.
+#define POLL_DATA(pool_id, fd)     (((uint64_t)(uint32_t)(fd) << 32) | (pool_id))
+#define POLL_DATA_POOL_ID(data)    ((pool_id_t)((data) & 0xFFFFFFFF))
+#define POLL_DATA_FD(data)         ((IMS_SOCKET)((data) >> 32))
+
+// Shared multicast sockets are polled with their demux entry id and this flag as pool id
+#define POLL_DEMUX                 0x80000000
+
+// Pool id of the packet ring
+#define POLL_RING                  0x40000000
+
+// Staging of the shared multicast sockets: datagrams read at once, and their max size
+#define DEMUX_SLOT_COUNT 16
+#define DEMUX_SLOT_SIZE  65536
+
+//
+// Only datagram sockets are received by the ring or the I/O thread. TCP ones stay polled.
+//
+static bool is_datagram_socket(IMS_SOCKET fd)
+{
+    int type = 0;
+    socklen_t type_size = sizeof(type);
+    return getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &type_size) == 0 && type == SOCK_DGRAM;
+}
+
+//
+// Input pool ids follow the priorities. Shared sockets and the packet ring
+// come first: they hold the datagrams of inputs of any priority.
+//
+bool socket_pool::event_before(const struct epoll_event& left, const struct epoll_event& right)
+{
+    pool_id_t left_id = POLL_DATA_POOL_ID(left.data.u64);
+    pool_id_t right_id = POLL_DATA_POOL_ID(right.data.u64);
+    bool left_shared = (left_id & (POLL_DEMUX | POLL_RING)) != 0;
+    bool right_shared = (right_id & (POLL_DEMUX | POLL_RING)) != 0;
+    if (left_shared != right_shared) return left_shared;
+    return left_id < right_id;
+}
+
+#ifdef VISTAS_HAVE_SHARED_MULTICAST
+bool socket_pool::member_before(socket_multicast_member* left, socket_multicast_member* right)
+{
+    return left->get_pool_id() < right->get_pool_id();
+}
+#endif
+
+void socket_pool::poll_add(pool_id_t pool_id) throw (ims::exception)
+{
+    if (dynamic_cast<socket_memory*>(_input_pool[pool_id].socket.get()) != NULL) {
+        _memory_inputs.push_back(pool_id);
+        return;
+    }
+
+#ifdef VISTAS_HAVE_SHARED_MULTICAST
+    socket_multicast_member* member = dynamic_cast<socket_multicast_member*>(_input_pool[pool_id].socket.get());
+    if (member != NULL) {
+        demux_add(pool_id, member);
+        return;
+    }
+#endif
+
+    IMS_SOCKET fd = _input_pool[pool_id].socket->get_fd();
+    if (fd == INVALID_SOCKET) return;
+
+#ifdef VISTAS_HAVE_IO_THREAD
+    if (_io_thread && is_datagram_socket(fd)) {
+        // Inbox slots are too small for coalesced datagrams
+        _input_pool[pool_id].socket->set_gro(false);
+        io_inbox& inbox = _io_inboxes[pool_id];
+        inbox.allocate();
+        _io_thread->watch(pool_id, fd, &inbox);
+        _input_pool[pool_id].socket->set_io_inbox(&inbox);
+        return;
+    }
+#endif
+
+#ifdef VISTAS_HAVE_URING
+    if (_uring && is_datagram_socket(fd)) {
+        // Ring buffers are too small for coalesced datagrams
+        _input_pool[pool_id].socket->set_gro(false);
+        uring_inbox& inbox = _uring_inboxes[pool_id];
+        inbox.armed = true;
+        inbox.rearm = false;
+        _input_pool[pool_id].socket->set_uring(_uring.get(), &inbox);
+        _uring->arm_receive(fd, POLL_DATA(pool_id, fd));
+        return;
+    }
+#endif
+
+    poll_add_epoll(pool_id, fd);
+}
+
+//
+// Poll a socket with epoll, in the shard of its worker if any
+//
+void socket_pool::poll_add_epoll(pool_id_t pool_id, IMS_SOCKET fd)
+throw (ims::exception)
+{
+    int epoll_fd = _epoll_fd;
+    uint32_t* epoll_count = &_epoll_count;
+#ifdef VISTAS_HAVE_WORKER_POOL
+    // Instrumentation (TCP) sockets stay with the caller: their requests replace sockets
+    if (_workers && is_datagram_socket(fd)) {
+        shard_t& shard = _shards[pool_id % _shards.size()];
+        epoll_fd = shard.epoll_fd;
+        epoll_count = &shard.epoll_count;
+        _input_shard[pool_id] = pool_id % _shards.size();
+    }
+#endif
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = POLL_DATA(pool_id, fd);
+
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        THROW_IMS_ERROR(ims_implementation_specific_error, "Cannot poll " <<
+                        _input_pool[pool_id].socket->to_string() << "! errno: " << errno);
+    }
+    (*epoll_count)++;
+}
+
+void socket_pool::poll_remove(pool_id_t pool_id)
+{
+    std::vector<pool_id_t>::iterator imemory = std::find(_memory_inputs.begin(), _memory_inputs.end(), pool_id);
+    if (imemory != _memory_inputs.end()) {
+        _memory_inputs.erase(imemory);
+        return;
+    }
+
+#ifdef VISTAS_HAVE_SHARED_MULTICAST
+    socket_multicast_member* member = dynamic_cast<socket_multicast_member*>(_input_pool[pool_id].socket.get());
+    if (member != NULL) {
+        demux_remove(member);
+        return;
+    }
+#endif
+
+    IMS_SOCKET fd = _input_pool[pool_id].socket->get_fd();
+    if (fd == INVALID_SOCKET) return;
+
+#ifdef VISTAS_HAVE_IO_THREAD
+    // The thread is already paused (@see pause_io_thread)
+    if (_io_thread && _io_thread->unwatch(pool_id)) {
+        _io_inboxes[pool_id].clear();
+        _input_pool[pool_id].socket->set_io_inbox(NULL);
+        return;
+    }
+#endif
+
+#ifdef VISTAS_HAVE_URING
+    if (_uring && _uring_inboxes[pool_id].armed) {
+        uring_inbox& inbox = _uring_inboxes[pool_id];
+        inbox.armed = false;
+        _uring->cancel(POLL_DATA(pool_id, fd));
+        _uring->clear(inbox);
+        _input_pool[pool_id].socket->set_uring(NULL, NULL);
+        return;
+    }
+#endif
+
+    int epoll_fd = _epoll_fd;
+    uint32_t* epoll_count = &_epoll_count;
+#ifdef VISTAS_HAVE_WORKER_POOL
+    if (_workers && _input_shard[pool_id] >= 0) {
+        shard_t& shard = _shards[_input_shard[pool_id]];
+        epoll_fd = shard.epoll_fd;
+        epoll_count = &shard.epoll_count;
+        _input_shard[pool_id] = -1;
+    }
+#endif
+
+    // Event pointer is ignored but must not be NULL for kernels < 2.6.9
+    struct epoll_event event;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, &event) == 0) {
+        (*epoll_count)--;
+    }
+}
+
+void socket_pool::import_begin(uint64_t begin, uint32_t timeout_us)
+{
+    _import_deadline = begin + timeout_us;
+
+#ifdef VISTAS_HAVE_WORKER_POOL
+    // Shards first, in parallel. Then the caller alone handles its own sockets:
+    // instrumentation requests may replace sockets of any shard.
+    if (_workers) {
+        import_job job(this, begin, timeout_us);
+        _workers->run(job, _shards.size());
+    }
+#endif
+#ifdef VISTAS_HAVE_PACKET_RING
+    // Frames captured before the import are only readable once their block is retired
+    if (_packet_ring) _packet_ring->settle(timeout_us);
+#endif
+}
+
+uint32_t socket_pool::import_once()
+{
+    struct epoll_event events[IMPORT_EVENTS_MAX];
+    int nb_events = 0;
 
     // 0 timeout for polling
-    struct timeval zero_timeout;
-    zero_timeout.tv_sec = 0;
-    zero_timeout.tv_usec = 0;
+    if (_epoll_count != 0) {
+        do {
+            nb_events = epoll_wait(_epoll_fd, events, IMPORT_EVENTS_MAX, 0);
+        } while (nb_events < 0 && errno == EINTR);
+    }
+
+    if (nb_events < 0) {
+        THROW_IMS_ERROR(ims_implementation_specific_error,
+                        "epoll_wait fail! errno: " << errno);
+    }
+
+    // By decreasing priority. A deferred socket is reported again by the next wait.
+    std::sort(events, events + nb_events, event_before);
+    _import_priority = VISTAS_PRIORITY_COUNT;
+
+    for (int ievent = 0; ievent < nb_events; ievent++) {
+        pool_id_t pool_id = POLL_DATA_POOL_ID(events[ievent].data.u64);
+#ifdef VISTAS_HAVE_PACKET_RING
+        if (pool_id == POLL_RING) {
+            ring_dispatch();
+            continue;
+        }
+#endif
+#ifdef VISTAS_HAVE_SHARED_MULTICAST
+        if (pool_id & POLL_DEMUX) {
+            demux_t& demux = _demux[pool_id & ~POLL_DEMUX];
+            if (demux.shared && demux.shared->get_fd() == POLL_DATA_FD(events[ievent].data.u64)) {
+                demux_dispatch(pool_id & ~POLL_DEMUX);
+            }
+            continue;
+        }
+#endif
+        pool_element_t& element = _input_pool[pool_id];
+        if (element.socket->get_fd() == POLL_DATA_FD(events[ievent].data.u64) &&
+            is_deferred(pool_id) == false) {
+            element.port->receive();
+        }
+    }
+
+#ifdef VISTAS_HAVE_URING
+    if (_uring) nb_events += uring_dispatch();
+#endif
+#ifdef VISTAS_HAVE_IO_THREAD
+    if (_io_thread) nb_events += io_dispatch();
+#endif
+    if (_memory_inputs.empty() == false) nb_events += memory_dispatch();
+
+    return nb_events;
+}
+
+void socket_pool::import_end()
+{
+#ifdef VISTAS_HAVE_IO_THREAD
+    // Sockets have been replaced meanwhile: drain the new ones
+    if (_io_thread && _io_thread->is_running() == false) {
+        _io_thread->start();
+    }
+#endif
+}
+
+//
+// Select the io_uring engine. Keep epoll if the ring cannot be created.
+//
+void socket_pool::enable_uring(__attribute__((__unused__)) uint32_t pool_size)
+{
+#ifdef VISTAS_HAVE_URING
+    try {
+        _uring = uring_ptr(new uring(URING_ENTRIES, URING_BUFFERS));
+        _send_batch->set_uring(uring_ptr(new uring(URING_ENTRIES)));
+    } catch (ims::exception&) {
+        LOG_WARN("io_uring is not available, falling back to epoll.");
+        _uring = uring_ptr();
+        return;
+    }
+
+    // Sockets keep a pointer on their inbox: never resize it after that
+    _uring_inboxes.resize(pool_size);
+    LOG_INFO("Using io_uring socket engine.");
+#else
+    LOG_WARN("io_uring is not supported by this build, falling back to epoll.");
+#endif
+}
+
+#ifdef VISTAS_HAVE_WORKER_POOL
+//
+// Read the ready sockets of a shard. Run by an import worker: only the ports
+// of this shard may be touched.
+//
+void socket_pool::import_shard(uint32_t shard_id, uint64_t begin, uint32_t timeout_us)
+throw (ims::exception)
+{
+    shard_t& shard = _shards[shard_id];
+    if (shard.epoll_count == 0) return;
 
-    int select_status = 1;
-    fd_set select_set;
+    struct epoll_event events[IMPORT_EVENTS_MAX];
+    int nb_events;
 
     do
     {
+        nb_events = epoll_wait(shard.epoll_fd, events, IMPORT_EVENTS_MAX, 0);
+
+        if (nb_events < 0) {
+            if (errno == EINTR) continue;
+            THROW_IMS_ERROR(ims_implementation_specific_error,
+                            "epoll_wait fail! errno: " << errno);
+        }
+
+        // By decreasing priority. Never deferred: the deadline already bounds the loop.
+        std::sort(events, events + nb_events, event_before);
+
+        for (int ievent = 0; ievent < nb_events; ievent++) {
+            pool_element_t& element = _input_pool[POLL_DATA_POOL_ID(events[ievent].data.u64)];
+            if (element.socket->get_fd() == POLL_DATA_FD(events[ievent].data.u64)) {
+                element.port->receive();
+            }
+        }
+
+    } while ((nb_events != 0) &&
+             (ims_get_real_time() - begin < timeout_us));
+}
+#endif
+
+//
+// Input pool ids follow the priorities (@see create_pool): inputs read in
+// pool id order are read by decreasing priority.
+//
+bool socket_pool::is_deferred(pool_id_t pool_id)
+{
+    uint32_t priority = _input_pool[pool_id].port->get_priority();
+    if (priority < _import_priority && _import_priority != VISTAS_PRIORITY_COUNT &&
+        ims_get_real_time() >= _import_deadline) {
+        return true;
+    }
+    _import_priority = priority;
+    return false;
+}
+
+//
+// Let the ports read the datagrams waiting in their memory socket.
+// @return The number of ports which had pending datagrams.
+//
+uint32_t socket_pool::memory_dispatch()
+{
+    uint32_t nb_ready = 0;
+    for (uint32_t imemory = 0; imemory < _memory_inputs.size(); imemory++) {
+        pool_element_t& element = _input_pool[_memory_inputs[imemory]];
+        if (static_cast<socket_memory*>(element.socket.get())->has_pending()) {
+            if (is_deferred(_memory_inputs[imemory]) == false) element.port->receive();
+            nb_ready++;
+        }
+    }
+    return nb_ready;
+}
+
+#ifdef VISTAS_HAVE_SHARED_MULTICAST
+//
+// Poll the shared socket of a member, once for all its members.
+// It stays with the caller thread: its members may belong to any shard.
+//
+void socket_pool::demux_add(pool_id_t pool_id, socket_multicast_member* member) throw (ims::exception)
+{
+    member->set_pool_id(pool_id);
+    socket_multicast_shared_ptr shared = member->get_shared();
+    if (!shared) return;
+
+#ifdef VISTAS_HAVE_PACKET_RING
+    if (_packet_ring) _packet_ring->add(member);
+#endif
+
+    uint32_t demux_id = _demux.size();
+    for (uint32_t idemux = 0; idemux < _demux.size(); idemux++) {
+        if (_demux[idemux].shared == shared) {
+            _demux[idemux].member_count++;
+            return;
+        }
+        if (!_demux[idemux].shared && demux_id == _demux.size()) demux_id = idemux;
+    }
+    if (demux_id == _demux.size()) _demux.push_back(demux_t());
+
+    if (_demux_staging.empty()) _demux_staging.resize(DEMUX_SLOT_COUNT * DEMUX_SLOT_SIZE);
+
+#ifdef VISTAS_HAVE_PACKET_RING
+    // Only the datagrams too big for the ring are left to the socket
+    if (_packet_ring) shared->drop_small_datagrams(PACKET_RING_DATAGRAM_MAX);
+#endif
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = POLL_DATA(POLL_DEMUX | demux_id, shared->get_fd());
+
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, shared->get_fd(), &event) != 0) {
+        THROW_IMS_ERROR(ims_implementation_specific_error, "Cannot poll " <<
+                        shared->to_string() << "! errno: " << errno);
+    }
+    _epoll_count++;
+
+    _demux[demux_id].shared = shared;
+    _demux[demux_id].member_count = 1;
+}
+
+//
+// Stop polling the shared socket with its last member
+//
+void socket_pool::demux_remove(socket_multicast_member* member)
+{
+#ifdef VISTAS_HAVE_PACKET_RING
+    if (_packet_ring) _packet_ring->remove(member);
+#endif
+
+    for (uint32_t idemux = 0; idemux < _demux.size(); idemux++) {
+        demux_t& demux = _demux[idemux];
+        if (demux.shared != member->get_shared() || --demux.member_count > 0) continue;
+
+        // Event pointer is ignored but must not be NULL for kernels < 2.6.9
+        struct epoll_event event;
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, demux.shared->get_fd(), &event) == 0) {
+            _epoll_count--;
+        }
+        demux.shared = socket_multicast_shared_ptr();
+        return;
+    }
+}
+
+//
+// Read the datagrams of a shared socket, then let the ports of the members
+// which got some read them before the staging is reused.
+// @return The number of ports which had pending datagrams.
+//
+uint32_t socket_pool::demux_dispatch(uint32_t demux_id)
+{
+    socket_multicast_shared_ptr shared = _demux[demux_id].shared;
+    uint32_t nb_ready = 0;
+    uint32_t received;
+
+    do {
+        received = shared->drain(&_demux_staging[0], DEMUX_SLOT_SIZE, DEMUX_SLOT_COUNT, _demux_ready);
+        nb_ready += _demux_ready.size();
+        demux_receive();
+    } while (received == DEMUX_SLOT_COUNT);
+
+    return nb_ready;
+}
+
+//
+// The datagrams of the ready members are only valid until the staging is
+// reused: forget them even if a port fails.
+//
+void socket_pool::demux_receive()
+{
+    // By decreasing priority, but never deferred
+    std::sort(_demux_ready.begin(), _demux_ready.end(), member_before);
+
+    try {
+        for (uint32_t iready = 0; iready < _demux_ready.size(); iready++) {
+            _input_pool[_demux_ready[iready]->get_pool_id()].port->receive();
+        }
+    } catch (ims::exception&) {
+        for (uint32_t iready = 0; iready < _demux_ready.size(); iready++) {
+            _demux_ready[iready]->clear_pending();
+        }
+        _demux_ready.clear();
+        throw;
+    }
+
+    for (uint32_t iready = 0; iready < _demux_ready.size(); iready++) {
+        _demux_ready[iready]->clear_pending();
+    }
+    _demux_ready.clear();
+}
+#endif
+
+//
+// Read the multicast inputs from an AF_PACKET ring. Keep their shared
+// sockets if the ring cannot be created (no CAP_NET_RAW).
+//
+void socket_pool::enable_packet_ring(__attribute__((__unused__)) const std::string& interface_ip)
+{
+#ifdef VISTAS_HAVE_PACKET_RING
+    try {
+        _packet_ring = packet_ring_ptr(new packet_ring(interface_ip));
+    } catch (ims::exception&) {
+        LOG_WARN("The packet ring is not available, falling back to UDP sockets.");
+        return;
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = POLL_DATA(POLL_RING, _packet_ring->get_fd());
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _packet_ring->get_fd(), &event) != 0) {
+        LOG_WARN("The packet ring cannot be polled (errno: " << errno << "), falling back to UDP sockets.");
+        _packet_ring = packet_ring_ptr();
+        return;
+    }
+    _epoll_count++;
+    LOG_INFO("Using AF_PACKET ring for multicast inputs.");
+#else
+    LOG_WARN("The packet ring is only available on Linux, falling back to UDP sockets.");
+#endif
+}
+
+#ifdef VISTAS_HAVE_PACKET_RING
+//
+// Let the members read the datagrams of each retired block, then give the
+// block back to the kernel.
+// @return The number of ports which had pending datagrams.
+//
+uint32_t socket_pool::ring_dispatch()
+{
+    uint32_t nb_ready = 0;
+
+    while (_packet_ring->next_block(_demux_ready)) {
+        nb_ready += _demux_ready.size();
+        try {
+            demux_receive();
+        } catch (ims::exception&) {
+            _packet_ring->release_block();
+            throw;
+        }
+        _packet_ring->release_block();
+    }
+
+    return nb_ready;
+}
+#endif
+
+#ifdef VISTAS_HAVE_IO_THREAD
+//
+// Let the ports read the datagrams received by the I/O thread.
+// @return The number of ports which had pending datagrams.
+//
+uint32_t socket_pool::io_dispatch()
+{
+    uint32_t nb_ready = 0;
+    for (pool_id_t pool_id = 0; pool_id < _io_inboxes.size(); pool_id++) {
+        if (_io_inboxes[pool_id].empty() == false) {
+            if (is_deferred(pool_id) == false) _input_pool[pool_id].port->receive();
+            nb_ready++;
+        }
+    }
+    return nb_ready;
+}
+#endif
+
+#ifdef VISTAS_HAVE_URING
+//
+// Move the datagrams received by the ring into the socket inboxes, then
+// let the ports read them.
+// @return The number of datagrams received.
+//
+uint32_t socket_pool::uring_dispatch()
+{
+    // Submit pending arms/cancellations and get the new completions
+    _uring->submit();
+
+    uring::completion completions[IMPORT_EVENTS_MAX];
+    uint32_t nb_completions;
+    uint32_t nb_datagrams = 0;
+
+    do {
+        nb_completions = _uring->reap(completions, IMPORT_EVENTS_MAX);
+
+        for (uint32_t icompletion = 0; icompletion < nb_completions; icompletion++) {
+            uring::completion& completion = completions[icompletion];
+            if (completion.user_data == uring::ignored_data) continue;
+
+            pool_id_t pool_id = POLL_DATA_POOL_ID(completion.user_data);
+            uring_inbox& inbox = _uring_inboxes[pool_id];
+            bool current = inbox.armed &&
+                    _input_pool[pool_id].socket->get_fd() == POLL_DATA_FD(completion.user_data);
+
+            uring_inbox::pending datagram;
+            if (_uring->get_datagram(completion, datagram)) {
+                if (current == false) {
+                    // Socket replaced meanwhile
+                    _uring->release_buffer(datagram.buffer_id);
+                    continue;
+                }
+
+                inbox.datagrams.push_back(datagram);
+                nb_datagrams++;
+                if (inbox.ready == false) {
+                    inbox.ready = true;
+                    _uring_ready.push_back(pool_id);
+                }
+            }
+
+            // The multishot receive stopped
+            if (current && (completion.flags & IORING_CQE_F_MORE) == 0) {
+                if (completion.res >= 0 || completion.res == -ENOBUFS) {
+                    if (inbox.rearm == false) {
+                        inbox.rearm = true;
+                        _uring_rearm.push_back(pool_id);
+                    }
+                } else if (completion.res != -ECANCELED) {
+                    LOG_WARN(_input_pool[pool_id].socket->to_string() << ": io_uring receive failed (" <<
+                             strerror(-completion.res) << "), falling back to epoll.");
+                    _uring->clear(inbox);
+                    inbox.armed = false;
+                    _input_pool[pool_id].socket->set_uring(NULL, NULL);
+                    poll_add_epoll(pool_id, _input_pool[pool_id].socket->get_fd());
+                }
+            }
+        }
+    } while (nb_completions == IMPORT_EVENTS_MAX);
+
+    // Let the ports read their inbox, by decreasing priority. A port which
+    // didn't read everything, or was deferred, stays ready.
+    std::sort(_uring_ready.begin(), _uring_ready.end());
+    uint32_t nb_ready = 0;
+    for (uint32_t iready = 0; iready < _uring_ready.size(); iready++) {
+        pool_id_t pool_id = _uring_ready[iready];
+        uring_inbox& inbox = _uring_inboxes[pool_id];
+
+        if (inbox.armed && inbox.empty() == false && is_deferred(pool_id) == false) {
+            _input_pool[pool_id].port->receive();
+        }
+
+        if (inbox.armed && inbox.empty() == false) {
+            _uring_ready[nb_ready++] = pool_id;
+        } else {
+            inbox.ready = false;
+        }
+    }
+    _uring_ready.resize(nb_ready);
+
+    // Buffers are released: arm again the stopped receives
+    for (uint32_t irearm = 0; irearm < _uring_rearm.size(); irearm++) {
+        pool_id_t pool_id = _uring_rearm[irearm];
+        uring_inbox& inbox = _uring_inboxes[pool_id];
+        if (inbox.armed && inbox.rearm) {
+            _uring->arm_receive(_input_pool[pool_id].socket->get_fd(), POLL_DATA(pool_id, _input_pool[pool_id].socket->get_fd()));
+        }
+        inbox.rearm = false;
+    }
+    _uring_rearm.clear();
+
+    return nb_datagrams;
+}
+#endif
+#else
+void socket_pool::poll_add(pool_id_t pool_id) throw (ims::exception)
+{
+    IMS_SOCKET fd = _input_pool[pool_id].socket->get_fd();
+    if (fd == INVALID_SOCKET) return;
+
+    _select_nfds = std::max( (int)(fd + 1), _select_nfds);
+    FD_SET(fd, &_select_set);
+}
+
+void socket_pool::poll_remove(pool_id_t pool_id)
+{
+    IMS_SOCKET fd = _input_pool[pool_id].socket->get_fd();
+    if (fd == INVALID_SOCKET) return;
+
+    FD_CLR(fd, &_select_set);
+}
+
+void socket_pool::import_begin(uint64_t begin, uint32_t timeout_us)
+{
+    _import_deadline = begin + timeout_us;
+}
+
+uint32_t socket_pool::import_once()
+{
+    int select_status = 0;
+    _import_priority = VISTAS_PRIORITY_COUNT;
+
+    // If no consumed data, _select_set is still at -1
+    // Avoid calling select, the call will fail
+    if (_select_nfds != -1)
+    {
+        // 0 timeout for polling
+        struct timeval zero_timeout;
+        zero_timeout.tv_sec = 0;
+        zero_timeout.tv_usec = 0;
+
+        fd_set select_set;
         memcpy(&select_set, &_select_set, sizeof(fd_set));
         select_status = select(_select_nfds, &select_set, NULL, NULL, &zero_timeout);
 
@@ -174,25 +920,158 @@ ims_return_code_t socket_pool::import(uint32_t timeout_us)
 
         if (select_status > 0)
         {
-            for(pool_vector_t::iterator ipool = _input_pool.begin();
-                ipool != _input_pool.end();
-                ipool++) {
-                if (ipool->socket->get_fd() != INVALID_SOCKET &&
-                        FD_ISSET(ipool->socket->get_fd(), &select_set)) {
-                    ipool->port->receive();
+            // Pool id order is the priority order
+            for (pool_id_t pool_id = 0; pool_id < _input_pool.size(); pool_id++) {
+                pool_element_t& element = _input_pool[pool_id];
+                if (element.socket->get_fd() != INVALID_SOCKET &&
+                        FD_ISSET(element.socket->get_fd(), &select_set) &&
+                        is_deferred(pool_id) == false) {
+                    element.port->receive();
                 }
             }
         }
+    }
 
-    } while ((select_status != 0) &&
-             (ims_get_real_time() - begin < timeout_us));
+    if (_memory_inputs.empty() == false) select_status += memory_dispatch();
+
+    return select_status;
+}
+
+void socket_pool::import_end()
+{
+}
+
+void socket_pool::enable_uring(uint32_t)
+{
+    LOG_WARN("io_uring is only available on Linux, falling back to select.");
+}
+#endif
+
+//
+// Read the inputs until nothing is left or the time is out
+//
+ims_return_code_t socket_pool::import(uint32_t timeout_us)
+{
+    uint64_t begin = ims_get_real_time();
+
+    import_begin(begin, timeout_us);
+    while (import_once() != 0 &&
+           ims_get_real_time() - begin < timeout_us);
+    import_end();
 
     return ims_no_error;
 }
 
+//
+// Drain the input sockets in a background thread. Keep reading them during
+// imports if the thread cannot be created.
+//
+void socket_pool::enable_io_thread(__attribute__((__unused__)) uint32_t pool_size,
+                                   __attribute__((__unused__)) int cpu,
+                                   __attribute__((__unused__)) int priority)
+{
+#ifdef VISTAS_HAVE_IO_THREAD
+    try {
+        _io_thread = io_thread_ptr(new io_thread(pool_size, cpu, priority));
+    } catch (ims::exception&) {
+        LOG_WARN("The I/O thread cannot be created, sockets will be read by imports.");
+        return;
+    }
+
+    // Sockets keep a pointer on their inbox: never resize it after that
+    _io_inboxes.resize(pool_size);
+    LOG_INFO("Using a background I/O thread.");
+#else
+    LOG_WARN("The I/O thread is only available on Linux, sockets will be read by imports.");
+#endif
+}
+
+//
+// Pace the outputs in a background thread. Send them at once if the thread
+// cannot be created.
+//
+void socket_pool::enable_pacer(__attribute__((__unused__)) uint32_t max_frame_rate)
+{
+#ifdef VISTAS_HAVE_PACER
+    try {
+        _pacer = pacer_ptr(new pacer(max_frame_rate));
+    } catch (ims::exception&) {
+        LOG_WARN("The pacing thread cannot be created, outputs are not paced.");
+        return;
+    }
+    LOG_INFO("Pacing the outputs in a background thread.");
+#else
+    LOG_WARN("Pacing is only available on Linux, outputs are not paced.");
+#endif
+}
+
+//
+// Attach an output socket to the send batch, and to the pacer if it is paced
+//
+void socket_pool::attach_output(socket_ptr socket)
+{
+    _send_batch->attach(socket);
+
+#ifdef VISTAS_HAVE_PACER
+    socket_address_ptr address = socket->get_address();
+    if (_pacer && address && (address->get_bag_us() != 0 || _pacer->get_max_frame_rate() != 0)) {
+        _pacer->add(socket.get(), address->get_bag_us());
+    }
+#endif
+}
+
+//
+// Split the input datagram sockets in shards imported by a pool of threads.
+// Keep importing them in the caller thread if the pool cannot be created.
+//
+void socket_pool::enable_import_workers(__attribute__((__unused__)) uint32_t pool_size,
+                                        __attribute__((__unused__)) uint32_t worker_count)
+{
+#ifdef VISTAS_HAVE_WORKER_POOL
+    // Datagram sockets are already drained elsewhere
+#ifdef VISTAS_HAVE_URING
+    if (_uring) {
+        LOG_WARN("Import workers are not used with io_uring, sockets will be read by the caller.");
+        return;
+    }
+#endif
+#ifdef VISTAS_HAVE_IO_THREAD
+    if (_io_thread) {
+        LOG_WARN("Import workers are not used with the I/O thread, sockets will be read by the caller.");
+        return;
+    }
+#endif
+
+    uint32_t shard_count = std::min(pool_size, worker_count * IMPORT_SHARDS_PER_WORKER);
+    if (shard_count == 0) return;
+
+    _shards.resize(shard_count);
+    for (uint32_t ishard = 0; ishard < shard_count; ishard++) {
+        _shards[ishard].epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (_shards[ishard].epoll_fd < 0) {
+            LOG_WARN("Cannot create the import worker pollers (errno: " << errno <<
+                     "), sockets will be read by the caller.");
+            for (uint32_t iclose = 0; iclose < ishard; iclose++) {
+                ::close(_shards[iclose].epoll_fd);
+            }
+            _shards.clear();
+            return;
+        }
+    }
+
+    _input_shard.resize(pool_size, -1);
+    _workers = worker_pool_ptr(new worker_pool(worker_count - 1));
+    LOG_INFO("Importing with " << _workers->get_thread_count() + 1 << " threads, " << shard_count << " shards.");
+#else
+    LOG_WARN("Import workers are only available on Linux, sockets will be read by the caller.");
+#endif
+}
+
 // Apply the given redirection
 bool socket_pool::instrumentation_apply(socket_address_ptr address_key, socket_address_ptr target)
 {
+    pause_io_thread();
+
     address_key_map_t::iterator iaddr = _address_key_map.find(address_key);
     if (iaddr == _address_key_map.end()) {
         LOG_ERROR("Redirect fail: Unknown address " << address_key->to_string());
@@ -203,31 +1082,30 @@ bool socket_pool::instrumentation_apply(socket_address_ptr address_key, socket_a
         target->set_interface_ip(address_key->get_interface_ip());
         target->set_TTL(address_key->get_TTL());
         target->set_outgoing_port(address_key->get_outgoing_port());
+        target->set_bag_us(address_key->get_bag_us());
+        target->set_priority(address_key->get_priority());
     }
 
     // Create and set the new socket
     if (address_key->get_direction() == ims_input)
     {
-        // Remove old socket from fd_set
-        if (_input_pool[iaddr->second].socket->get_fd() != INVALID_SOCKET) {
-            FD_CLR(_input_pool[iaddr->second].socket->get_fd(), &_select_set);
-        }
-
-        // Create the new socket and register it in the FD SET
+        // Create the new socket
         socket_ptr socket;
         if (target) {
             socket = socket_ptr(new socket_multicast_input(target));
-            _select_nfds = std::max( (int)(socket->get_fd() + 1), _select_nfds);
-            FD_SET(socket->get_fd(), &_select_set);
         }
         else  // We don't have an address
         {
             socket = socket_ptr(new socket_void());
         }
 
-        // Insert the new socket in the pool. (the old one will be destroyed with socket object)
+        // Remove old socket from the poller
+        poll_remove(iaddr->second);
+
+        // Insert the new socket in the pool and register it in the poller. (the old one will be destroyed with socket object)
         _input_pool[iaddr->second].socket = socket;
         _input_pool[iaddr->second].port->set_socket(socket);
+        poll_add(iaddr->second);
     }
     else // output
     {
@@ -242,6 +1120,7 @@ bool socket_pool::instrumentation_apply(socket_address_ptr address_key, socket_a
         // Insert the new socket in the pool. (the old one will be destroyed with socket object)
         _output_pool[iaddr->second].socket = socket;
         _output_pool[iaddr->second].port->set_socket(socket);
+        attach_output(socket);
     }
 
     return true;
@@ -249,6 +1128,8 @@ bool socket_pool::instrumentation_apply(socket_address_ptr address_key, socket_a
 
 bool socket_pool::start_or_stop_full(channel_ip_t ip, bool start)
 {
+    pause_io_thread();
+
     ip_key_map_t::iterator iaddr = _ip_key_map.find(ip);
     if (iaddr == _ip_key_map.end()) {
         LOG_ERROR("Start or stop fail: Unknown address " << ip.to_string());
@@ -263,27 +1144,24 @@ bool socket_pool::start_or_stop_full(channel_ip_t ip, bool start)
             uint32_t port = it->first;
             pool_id_t pool_id = it->second;
 
-            // Remove old socket from fd_set
-            if (_input_pool[pool_id].socket->get_fd() != INVALID_SOCKET) {
-                FD_CLR(_input_pool[pool_id].socket->get_fd(), &_select_set);
-            }
-
-            // Create the new socket and register it in the FD SET
+            // Create the new socket
             socket_ptr socket;
             if (start) {
                 socket_address_ptr target(new socket_address_t(ip.direction, ip.ip, port));
                 socket = socket_ptr(new socket_multicast_input(target));
-                _select_nfds = std::max( (int) (socket->get_fd() + 1), _select_nfds);
-                FD_SET(socket->get_fd(), &_select_set);
             }
             else  // We don't have an address
             {
                 socket = socket_ptr(new socket_void());
             }
 
-            // Insert the new socket in the pool. (the old one will be destroyed with socket object)
+            // Remove old socket from the poller
+            poll_remove(pool_id);
+
+            // Insert the new socket in the pool and register it in the poller. (the old one will be destroyed with socket object)
             _input_pool[pool_id].socket = socket;
             _input_pool[pool_id].port->set_socket(socket);
+            poll_add(pool_id);
 
         }
     }
@@ -306,6 +1184,7 @@ bool socket_pool::start_or_stop_full(channel_ip_t ip, bool start)
             // Insert the new socket in the pool. (the old one will be destroyed with socket object)
             _output_pool[pool_id].socket = socket;
             _output_pool[pool_id].port->set_socket(socket);
+            attach_output(socket);
         }
 
     }
@@ -16,13 +16,21 @@
 #ifndef _VISTAS_SOCKET_POOL_HH_
 #define _VISTAS_SOCKET_POOL_HH_
 #include "vistas_socket.hh"
+#include "vistas_send_batch.hh"
+#include "vistas_uring.hh"
+#include "vistas_io_thread.hh"
+#include "vistas_pacer.hh"
+#include "vistas_worker_pool.hh"
+#include "vistas_socket_memory.hh"
+#include "vistas_socket_multicast_shared.hh"
+#include "vistas_packet_ring.hh"
 #include <tr1/unordered_map>
 #include <map>
 #include <sstream>
 #include <vector>
 #include <cstring>
 #ifdef __linux
-#include <sys/select.h>
+#include <sys/epoll.h>
 #endif
 
 namespace vistas
@@ -79,6 +87,13 @@ namespace vistas
 class port;
 typedef shared_ptr<port> port_ptr;
 
+// How input sockets are polled and output datagrams submitted
+enum socket_engine_t {
+    socket_engine_poll,         // epoll (select on Windows) and sendmmsg
+    socket_engine_io_uring,     // io_uring multishot receives and batched sends (Linux only)
+    socket_engine_packet_ring,  // AF_PACKET ring for the multicast inputs, poll for the rest (Linux only)
+};
+
 class socket_pool;
 typedef shared_ptr<socket_pool> socket_pool_ptr;
 
@@ -88,8 +103,39 @@ typedef shared_ptr<socket_pool> socket_pool_ptr;
 class socket_pool
 {
 public:
+    ~socket_pool();
+
     // Read available data on the network and fill inputs ports.
     ims_return_code_t import(uint32_t timeout_us);
+
+    // Steps of import, for a reactor driving several pools: import_begin,
+    // then import_once until nothing is read or the time is out, then import_end.
+    // Ready inputs are read by decreasing priority. Once the time is out, the
+    // ones of a lower priority than the last read are left for the next call.
+    void import_begin(uint64_t begin, uint32_t timeout_us);
+    uint32_t import_once();     // @return The number of inputs which were read
+    void import_end();
+
+#ifdef __linux
+    // Poller of the input sockets, readable when one of them is
+    inline int get_poll_fd() { return _epoll_fd; }
+#endif
+
+    // Return true if some inputs are not reported by the poller
+    // (memory sockets, io_uring or I/O thread). Import workers are run by import_begin.
+    inline bool has_unpolled_inputs();
+
+    // Batch where output sockets stage their datagrams during send_all
+    inline send_batch_ptr get_send_batch() { return _send_batch; }
+
+#ifdef VISTAS_HAVE_IO_THREAD
+    // Background I/O thread, NULL if disabled.
+    // It is stopped while sockets are replaced, and started again by the next import.
+    inline io_thread_ptr get_io_thread() { return _io_thread; }
+#endif
+
+    // Stop the I/O thread, if any, until the next import
+    inline void pause_io_thread();
     
     // Redirect the given channel to the target address.
     // Both must have the same direction.
@@ -115,6 +161,8 @@ public:
     void stop_all_instrumentations();
 
 private:
+    socket_pool();
+
     bool instrumentation_apply(socket_address_ptr address_key, socket_address_ptr target);
     
     bool start_or_stop_full(channel_ip_t ip, bool start);
@@ -144,13 +192,146 @@ private:
     
     typedef std::map<const char *, socket_address_ptr, cmp_str> channel_address_map_t;
 
+    // Register/unregister the socket of the given input pool element in the poller
+    void poll_add(pool_id_t pool_id) throw (ims::exception);
+    void poll_remove(pool_id_t pool_id);
+
+    // Poll a datagram or TCP socket with epoll, whatever the engine
+    void poll_add_epoll(pool_id_t pool_id, IMS_SOCKET fd) throw (ims::exception);
+
+    // Use io_uring for input sockets, if available. Must be called before any poll_add.
+    void enable_uring(uint32_t pool_size);
+#ifdef VISTAS_HAVE_URING
+    uint32_t uring_dispatch();
+#endif
+
+    // Drain input datagram sockets in a background thread, if available.
+    // Must be called before any poll_add.
+    void enable_io_thread(uint32_t pool_size, int cpu, int priority);
+#ifdef VISTAS_HAVE_IO_THREAD
+    uint32_t io_dispatch();
+#endif
+
+    // Let the ports of the memory sockets read their pending datagrams
+    uint32_t memory_dispatch();
+
+    // Return true if the input must wait for the next import: the time is
+    // out, and an input of a higher priority was read by this import_once.
+    bool is_deferred(pool_id_t pool_id);
+
+#ifdef __linux
+    // Order of the ready input sockets
+    static bool event_before(const struct epoll_event& left, const struct epoll_event& right);
+#endif
+#ifdef VISTAS_HAVE_SHARED_MULTICAST
+    static bool member_before(socket_multicast_member* left, socket_multicast_member* right);
+#endif
+
+    // Pace the outputs with a BAG, or all of them with a max frame rate, if available.
+    // Must be called before any attach_output.
+    void enable_pacer(uint32_t max_frame_rate);
+
+    // Stage the datagrams of an output socket in the send batch, or hand
+    // them to the pacer
+    void attach_output(socket_ptr socket);
+
+#ifdef VISTAS_HAVE_SHARED_MULTICAST
+    // Poll the shared socket of a member, once for all its members
+    void demux_add(pool_id_t pool_id, socket_multicast_member* member) throw (ims::exception);
+    void demux_remove(socket_multicast_member* member);
+
+    // Read a shared socket and let the ports of its members read their datagrams
+    uint32_t demux_dispatch(uint32_t demux_id);
+
+    // Let the ports of the ready members read their datagrams, then forget them
+    void demux_receive();
+#endif
+
+    // Read the multicast inputs from an AF_PACKET ring, if available.
+    // Must be called before any poll_add.
+    void enable_packet_ring(const std::string& interface_ip);
+#ifdef VISTAS_HAVE_PACKET_RING
+    uint32_t ring_dispatch();
+#endif
+
+    // Import the input datagram sockets with worker_count threads, caller included.
+    // Must be called after the engine selection and before any poll_add.
+    void enable_import_workers(uint32_t pool_size, uint32_t worker_count);
+#ifdef VISTAS_HAVE_WORKER_POOL
+    // Read the ready sockets of a shard until none is left or the deadline is reached
+    void import_shard(uint32_t shard, uint64_t begin, uint32_t timeout_us)
+    throw (ims::exception);
+
+    class import_job : public worker_pool::job
+    {
+    public:
+        inline import_job(socket_pool* pool, uint64_t begin, uint32_t timeout_us) :
+            _pool(pool), _begin(begin), _timeout_us(timeout_us) {}
+        virtual void run(uint32_t item) { _pool->import_shard(item, _begin, _timeout_us); }
+    private:
+        socket_pool* _pool;
+        uint64_t     _begin;
+        uint32_t     _timeout_us;
+    };
+#endif
+
     pool_vector_t     _input_pool;             // 2 differents pools for import performances reasons.
     pool_vector_t     _output_pool;
     address_key_map_t _address_key_map;        // Map addresses (ip+port+direction) to pool id. Use direction to know wich pool it refers to.
     ip_key_map_t      _ip_key_map;             // Map ip/direction (no port) to a vector of (port, pool id). Use direction to know wich pool it refers to.
     channel_address_map_t _channel_address_map;  // Map channel name of address, used because VISTAS VCC uses channel names...
+    send_batch_ptr    _send_batch;             // Output sockets are attached to it
+#ifdef VISTAS_HAVE_PACER
+    pacer_ptr         _pacer;                  // NULL when no output is paced
+#endif
+#ifdef __linux
+    int               _epoll_fd;               // Input sockets poller. Only ready sockets are reported, no fd count limit.
+    uint32_t          _epoll_count;            // Number of sockets in the poller
+#endif
+#ifdef VISTAS_HAVE_URING
+    uring_ptr                 _uring;          // Input ring, NULL with the poll engine
+    std::vector<uring_inbox>  _uring_inboxes;  // By input pool id
+    std::vector<pool_id_t>    _uring_ready;    // Inputs with pending datagrams
+    std::vector<pool_id_t>    _uring_rearm;    // Inputs whose multishot receive stopped
+#endif
+#ifdef VISTAS_HAVE_IO_THREAD
+    io_thread_ptr             _io_thread;      // NULL when disabled
+    std::vector<io_inbox>     _io_inboxes;     // By input pool id
+#endif
+    std::vector<pool_id_t> _memory_inputs;     // Inputs without fd, checked at each import
+    uint64_t          _import_deadline;        // Set by import_begin
+    uint32_t          _import_priority;        // Of the last input read by import_once, VISTAS_PRIORITY_COUNT if none
+#ifdef VISTAS_HAVE_SHARED_MULTICAST
+    struct demux_t
+    {
+        inline demux_t() : member_count(0) {}
+        socket_multicast_shared_ptr shared;     // NULL when the entry is free
+        uint32_t                    member_count;
+    };
+    std::vector<demux_t>                  _demux;          // Shared sockets, always polled by the caller
+    std::vector<char>                     _demux_staging;  // Datagrams read from a shared socket
+    std::vector<socket_multicast_member*> _demux_ready;    // Members which got datagrams from the staging
+#endif
+#ifdef VISTAS_HAVE_PACKET_RING
+    packet_ring_ptr           _packet_ring;    // NULL when disabled
+#endif
+#ifdef VISTAS_HAVE_WORKER_POOL
+    // A shard owns the datagram sockets of the pool ids it is given, and so
+    // their ports: one thread at most reads them, no lock is needed.
+    struct shard_t
+    {
+        inline shard_t() : epoll_fd(-1), epoll_count(0) {}
+        int      epoll_fd;
+        uint32_t epoll_count;
+    };
+    worker_pool_ptr           _workers;        // NULL when disabled
+    std::vector<shard_t>      _shards;
+    std::vector<int32_t>      _input_shard;    // By input pool id. -1: polled by the caller thread
+#endif
+#ifndef __linux
     fd_set            _select_set;
     int               _select_nfds;
+#endif
 
     //=========================================================================
     // Pool Factory
@@ -159,6 +340,25 @@ public:
     class factory
     {
     public:
+        inline factory() : _engine(socket_engine_poll), _io_thread(false), _io_thread_cpu(-1), _io_thread_priority(0),
+                           _import_workers(1), _max_frame_rate(0), _send_buffer_size(0) {}
+
+        // Select the socket engine of the pool
+        inline void set_socket_engine(socket_engine_t engine) { _engine = engine; }
+        inline socket_engine_t get_socket_engine() { return _engine; }
+
+        // Drain the input sockets in a background thread (@see io_thread)
+        inline void set_io_thread(bool enabled, int cpu, int priority);
+
+        // Number of threads importing the input sockets, caller included (@see worker_pool)
+        inline void set_import_workers(uint32_t count) { _import_workers = count; }
+
+        // Datagrams per second of all the outputs, 0 for no limit (@see pacer)
+        inline void set_max_frame_rate(uint32_t max_frame_rate) { _max_frame_rate = max_frame_rate; }
+
+        // Send buffer size of the output sockets, 0 for the system default (@see send_batch)
+        inline void set_send_buffer_size(uint32_t size) { _send_buffer_size = size; }
+
         // Check if the given address is already registered
         bool exists(socket_address_ptr address);
 
@@ -176,8 +376,43 @@ public:
 
     private:
         typedef std::tr1::unordered_map<socket_address_ptr, pool_element_t> address_map_t;
-        address_map_t _addresses;
+        address_map_t   _addresses;
+        socket_engine_t _engine;
+        bool            _io_thread;
+        int             _io_thread_cpu;
+        int             _io_thread_priority;
+        uint32_t        _import_workers;
+        uint32_t        _max_frame_rate;
+        uint32_t        _send_buffer_size;
     };
 };
+
+//***************************************************************************
+// Inlines
+//***************************************************************************
+void socket_pool::pause_io_thread()
+{
+#ifdef VISTAS_HAVE_IO_THREAD
+    if (_io_thread) _io_thread->stop();
+#endif
+}
+
+bool socket_pool::has_unpolled_inputs()
+{
+#ifdef VISTAS_HAVE_URING
+    if (_uring) return true;
+#endif
+#ifdef VISTAS_HAVE_IO_THREAD
+    if (_io_thread) return true;
+#endif
+    return _memory_inputs.empty() == false;
+}
+
+void socket_pool::factory::set_io_thread(bool enabled, int cpu, int priority)
+{
+    _io_thread = enabled;
+    _io_thread_cpu = cpu;
+    _io_thread_priority = priority;
+}
 }
 #endif
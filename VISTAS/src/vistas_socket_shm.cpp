@@ -0,0 +1,267 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Same-host shared memory socket (Linux only).
+//
+#include "vistas_socket_shm.hh"
+
+#ifdef VISTAS_HAVE_SHM
+#include "ims_time.hh"
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <vector>
+
+// Ring identification. The magic is set last, once the geometry is written.
+#define SHM_MAGIC            0x56534852   // "VSHR"
+#define SHM_MAGIC_INIT       0x56534849   // "VSHI": being initialized
+#define SHM_VERSION          1
+
+// Ring geometry: all the processes must agree on it
+#define SHM_SLOT_COUNT       64
+#define SHM_SLOT_SIZE        (16 * 1024 - sizeof(slot_header))
+#define SHM_SLOT_STRIDE      (sizeof(slot_header) + SHM_SLOT_SIZE)
+
+// Max wait for another process initializing the ring, in us
+#define SHM_INIT_TIMEOUT_US  (1000 * 1000)
+
+namespace vistas
+{
+
+socket_shm::socket_shm(socket_address_ptr address)
+throw(ims::exception) :
+    _ring(NULL),
+    _ring_size(0),
+    _read_sequence(0)
+{
+    _address = address;
+
+    std::stringstream name;
+    name << "/vistas." << address->get_ip() << '.' << address->get_port();
+    map(name.str());
+
+    // Only the datagrams published from now on are received
+    _read_sequence = __atomic_load_n(&_ring->write_sequence, __ATOMIC_ACQUIRE);
+}
+
+socket_shm::~socket_shm()
+{
+    if (_ring != NULL) {
+        munmap(_ring, _ring_size);
+    }
+}
+
+//
+// Map the ring, create and initialize it if needed
+//
+void socket_shm::map(const std::string& name)
+throw(ims::exception)
+{
+    _ring_size = sizeof(ring_header) + SHM_SLOT_COUNT * SHM_SLOT_STRIDE;
+
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    if (fd < 0) {
+        THROW_IMS_ERROR(ims_init_failure, to_string() << ": Cannot open shared memory " << name <<
+                        "! error: " << strerror(errno));
+    }
+
+    // Both sides may create it: growing it to the same size twice is harmless
+    struct stat status;
+    if (fstat(fd, &status) != 0 ||
+        ((size_t)status.st_size < _ring_size && ftruncate(fd, _ring_size) != 0)) {
+        int error = errno;
+        ::close(fd);
+        THROW_IMS_ERROR(ims_init_failure, to_string() << ": Cannot size shared memory " << name <<
+                        "! error: " << strerror(error));
+    }
+
+    void* ring = mmap(NULL, _ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (ring == MAP_FAILED) {
+        THROW_IMS_ERROR(ims_init_failure, to_string() << ": Cannot map shared memory " << name <<
+                        "! error: " << strerror(errno));
+    }
+    _ring = (ring_header*)ring;
+
+    // The first process to map it writes the geometry
+    uint32_t magic = 0;
+    if (__atomic_compare_exchange_n(&_ring->magic, &magic, SHM_MAGIC_INIT, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        _ring->version = SHM_VERSION;
+        _ring->slot_count = SHM_SLOT_COUNT;
+        _ring->slot_size = SHM_SLOT_SIZE;
+        _ring->write_sequence = 0;
+        __atomic_store_n(&_ring->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+    } else {
+        uint64_t begin = ims_get_real_time();
+        while (magic == SHM_MAGIC_INIT && ims_get_real_time() - begin < SHM_INIT_TIMEOUT_US) {
+            sched_yield();
+            magic = __atomic_load_n(&_ring->magic, __ATOMIC_ACQUIRE);
+        }
+    }
+
+    if (__atomic_load_n(&_ring->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC ||
+        _ring->version != SHM_VERSION ||
+        _ring->slot_count != SHM_SLOT_COUNT ||
+        _ring->slot_size != SHM_SLOT_SIZE) {
+        munmap(_ring, _ring_size);
+        _ring = NULL;
+        THROW_IMS_ERROR(ims_init_failure, to_string() << ": Shared memory " << name <<
+                        " is not a compatible VISTAS ring! Remove it from /dev/shm.");
+    }
+}
+
+inline socket_shm::slot_header* socket_shm::get_slot(uint64_t sequence)
+{
+    return (slot_header*)((char*)(_ring + 1) + (sequence % SHM_SLOT_COUNT) * SHM_SLOT_STRIDE);
+}
+
+//
+// Publish a datagram. Readers check the slot sequence before and after
+// copying it, so they never keep a datagram overwritten meanwhile.
+//
+void socket_shm::publish(const char* header, uint32_t header_size,
+                         const char* payload, uint32_t payload_size)
+throw(ims::exception)
+{
+    // Dropped like a frame too big for the link: throwing would leave it at
+    // the head of a queuing port, and block it for good.
+    if (header_size + payload_size > SHM_SLOT_SIZE) {
+        LOG_ERROR_RATE_LIMITED(to_string() << ": Datagram of " << header_size + payload_size <<
+                               " bytes is too big for shared memory (max " << SHM_SLOT_SIZE << "), dropped!");
+        return;
+    }
+
+#ifdef ENABLE_INSTRUMENTATION
+    // Call handler
+    if (ims_socket_handler_send) {
+        std::vector<char> whole(header, header + header_size);
+        if (payload != NULL) whole.insert(whole.end(), payload, payload + payload_size);
+        ims_socket_handler_send(&whole[0], whole.size(),
+                                _address->get_ip().c_str(), _address->get_port());
+    }
+#endif
+
+    // Single emitter: nobody else moves the write sequence
+    uint64_t sequence = __atomic_load_n(&_ring->write_sequence, __ATOMIC_RELAXED);
+    slot_header* slot = get_slot(sequence);
+
+    __atomic_store_n(&slot->sequence, 2 * sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    memcpy(slot + 1, header, header_size);
+    if (payload != NULL) memcpy((char*)(slot + 1) + header_size, payload, payload_size);
+    slot->size = header_size + payload_size;
+
+    __atomic_store_n(&slot->sequence, 2 * sequence + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&_ring->write_sequence, sequence + 1, __ATOMIC_RELEASE);
+}
+
+void socket_shm::send(const char* buffer, uint32_t size)
+throw(ims::exception)
+{
+    publish(buffer, size, NULL, 0);
+}
+
+void socket_shm::send_gather(const char* header, uint32_t header_size,
+                             const char* payload, uint32_t payload_size)
+throw(ims::exception)
+{
+    publish(header, header_size, payload, payload_size);
+}
+
+//
+// Copy the pending datagrams in the given slots, like recvmmsg
+//
+uint32_t socket_shm::receive_many(datagram* datagrams, uint32_t count)
+throw(ims::exception)
+{
+    uint64_t write_sequence = __atomic_load_n(&_ring->write_sequence, __ATOMIC_ACQUIRE);
+    uint32_t received = 0;
+
+    while (received < count && _read_sequence < write_sequence) {
+        // The emitter went round the ring: the oldest datagrams are lost
+        if (write_sequence - _read_sequence > SHM_SLOT_COUNT) {
+            LOG_ERROR_RATE_LIMITED(to_string() << ": " << write_sequence - _read_sequence - SHM_SLOT_COUNT <<
+                                   " datagram(s) lost, the reader is too slow.");
+            _read_sequence = write_sequence - SHM_SLOT_COUNT;
+        }
+
+        slot_header* slot = get_slot(_read_sequence);
+        uint64_t expected = 2 * _read_sequence + 2;
+        _read_sequence++;
+
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != expected) {
+            // Already overwritten
+            continue;
+        }
+
+        // Same behaviour as recvmmsg: a too big datagram is truncated,
+        // and what doesn't fit in the buffer goes to the payload segment.
+        datagram& current = datagrams[received];
+        const char* data = (const char*)(slot + 1);
+        uint32_t size = std::min(slot->size, (uint32_t)SHM_SLOT_SIZE);
+        uint32_t head_size = std::min(size, current.buffer_size);
+        uint32_t tail_size = (current.payload != NULL)? std::min(size - head_size, current.payload_size) : 0;
+        memcpy(current.buffer, data, head_size);
+        if (tail_size > 0) memcpy(current.payload, data + head_size, tail_size);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) != expected) {
+            // Overwritten while it was copied
+            continue;
+        }
+        current.size = head_size + tail_size;
+
+#ifdef ENABLE_INSTRUMENTATION
+        // Call handler
+        if (ims_socket_handler_recv) {
+            ims_socket_handler_recv(data, current.size, _address->get_ip().c_str(), _address->get_port());
+        }
+#endif
+        received++;
+    }
+
+    return received;
+}
+
+//
+// Receive the next datagram
+//
+uint32_t socket_shm::receive(char* buffer, uint32_t buffer_size, client* client)
+throw(ims::exception)
+{
+    datagram slot;
+    slot.buffer = buffer;
+    slot.buffer_size = buffer_size;
+
+    if (receive_many(&slot, 1) == 0) return 0;
+
+    fill_client(client);
+    return slot.size;
+}
+
+//
+// Return true if datagrams are waiting for this reader
+//
+bool socket_shm::has_pending()
+{
+    return __atomic_load_n(&_ring->write_sequence, __ATOMIC_ACQUIRE) != _read_sequence;
+}
+
+}
+#endif
@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Same-host shared memory socket (Linux only).
+// Datagrams of a channel go through a POSIX shared memory ring, named after
+// the channel address, instead of the network stack. Like a multicast group,
+// every reader gets every datagram: each one has its own read position.
+// There must be only one emitter per channel.
+// A reader too slow to follow the emitter loses the oldest datagrams, as a
+// full socket buffer would. A datagram bigger than a slot is dropped.
+//
+#ifndef _VISTAS_SOCKET_SHM_HH_
+#define _VISTAS_SOCKET_SHM_HH_
+#include "vistas_socket_memory.hh"
+#include "vistas_sync.hh"
+
+#ifdef __linux
+#define VISTAS_HAVE_SHM
+#endif
+
+namespace vistas
+{
+#ifdef VISTAS_HAVE_SHM
+class socket_shm;
+typedef shared_ptr<socket_shm> socket_shm_ptr;
+
+class socket_shm : public socket_memory
+{
+public:
+    // Map the ring of the given address, and create it if needed
+    socket_shm(socket_address_ptr address)
+    throw(ims::exception);
+
+    // Unmap the ring. It is kept for the other processes.
+    ~socket_shm();
+
+    // Receive the next datagram
+    uint32_t receive(char* buffer, uint32_t buffer_size, client* client = NULL)
+    throw(ims::exception);
+
+    // Receive up to count pending datagrams
+    uint32_t receive_many(datagram* datagrams, uint32_t count)
+    throw(ims::exception);
+
+    // Publish a datagram in the ring
+    void send(const char* buffer, uint32_t size)
+    throw(ims::exception);
+
+    // Publish a header and its payload, copied once in the ring
+    void send_gather(const char* header, uint32_t header_size,
+                     const char* payload, uint32_t payload_size)
+    throw(ims::exception);
+
+    // Return true if datagrams are waiting for this reader
+    bool has_pending();
+
+private:
+    // Shared header, at the beginning of the ring
+    struct ring_header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slot_count;
+        uint32_t slot_size;
+        char     padding_begin[VISTAS_CACHE_LINE_SIZE - 4 * sizeof(uint32_t)];
+        uint64_t write_sequence;    // Number of datagrams ever published
+        char     padding_end[VISTAS_CACHE_LINE_SIZE - sizeof(uint64_t)];
+    };
+
+    // Header of a slot. The datagram follows.
+    struct slot_header
+    {
+        uint64_t sequence;          // 2 * (datagram sequence) + 1 while written, + 2 once written
+        uint32_t size;
+        uint32_t reserved;
+    };
+
+    // Map the ring and check its geometry
+    void map(const std::string& name)
+    throw(ims::exception);
+
+    inline slot_header* get_slot(uint64_t sequence);
+
+    void publish(const char* header, uint32_t header_size,
+                 const char* payload, uint32_t payload_size)
+    throw(ims::exception);
+
+    ring_header* _ring;
+    size_t       _ring_size;
+    uint64_t     _read_sequence;    // Next datagram to read
+};
+
+#endif
+
+}
+#endif
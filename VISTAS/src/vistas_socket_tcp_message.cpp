@@ -159,22 +159,6 @@ throw(ims::exception)
 
 }
 
-//
-// Set the socket to blocking
-//
-void socket_tcp_message::set_blocking(bool blocking)
-throw(ims::exception)
-{
-#ifdef _WIN32
-    unsigned long mode = blocking ? 0 : 1;
-    ioctlsocket(_sock, FIONBIO, &mode);
-#else
-    int flags = fcntl(_sock, F_GETFL, 0);
-    flags = blocking ? (flags&~O_NONBLOCK) : (flags|O_NONBLOCK);
-    fcntl(_sock, F_SETFL, flags);
-#endif
-}
-
 //
 // Reply to the emmiter
 //
@@ -42,10 +42,6 @@ namespace vistas
     // Receive a VISTAS packet from the socket
     uint32_t receive_packet(char* buffer, uint32_t buffer_size)
       throw(ims::exception);
-    
-    // Set the socket to blocking
-    void set_blocking(bool blocking)
-      throw(ims::exception);
   };
 
 }
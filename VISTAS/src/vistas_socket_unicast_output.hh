@@ -48,6 +48,11 @@ public:
     // Write to the socket
     virtual void send(const char* buffer, uint32_t size) throw(ims::exception);
 
+    // Write a header and its payload to the socket
+    virtual void send_gather(const char* header, uint32_t header_size,
+                             const char* payload, uint32_t payload_size)
+    throw(ims::exception);
+
 
     // Reply to the emmiter
     // Will always thow error::invalid_direction.
@@ -25,10 +25,20 @@ class socket_void : public socket
                             __attribute__((__unused__)) client* client = NULL)
     throw(ims::exception) { return 0; }
 
+    inline uint32_t receive_many(__attribute__((__unused__)) datagram* datagrams,
+                                 __attribute__((__unused__)) uint32_t count)
+    throw(ims::exception) { return 0; }
+
     inline void send(__attribute__((__unused__)) const char* buffer,
                      __attribute__((__unused__)) uint32_t size)
     throw(ims::exception) { }
 
+    inline void send_gather(__attribute__((__unused__)) const char* header,
+                            __attribute__((__unused__)) uint32_t header_size,
+                            __attribute__((__unused__)) const char* payload,
+                            __attribute__((__unused__)) uint32_t payload_size)
+    throw(ims::exception) { }
+
     inline void reply(__attribute__((__unused__)) client& client,
                       __attribute__((__unused__)) const char* buffer,
                       __attribute__((__unused__)) uint32_t size)
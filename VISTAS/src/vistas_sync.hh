@@ -0,0 +1,146 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Synchronization helpers of the thread-safe mode.
+// The data path takes no lock: application threads never wait for the
+// import/send thread, and the other way round.
+//
+#ifndef _VISTAS_SYNC_HH_
+#define _VISTAS_SYNC_HH_
+#include <stdint.h>
+
+// Used to keep data written by different threads on different cache lines
+#define VISTAS_CACHE_LINE_SIZE 64
+
+namespace vistas
+{
+
+//
+// Sequence lock protecting the data of one message.
+// Writers are exclusive: a writer waits for the one in progress. Readers never
+// block the writers: they copy the data, then retry if it was modified meanwhile.
+// A disabled lock (the default) costs one test.
+//
+class seqlock
+{
+public:
+    inline seqlock() : _sequence(0), _enabled(false) {}
+
+    inline void enable()     { _enabled = true; }
+    inline bool is_enabled() { return _enabled; }
+
+    // Writer side: data must only be modified between these calls.
+    // write_begin() waits for a write in progress in another thread.
+    inline void write_begin();
+    inline void write_end();
+
+    // Reader side:
+    //   do { sequence = read_begin(); <copy data> } while (read_retry(sequence));
+    inline uint32_t read_begin();
+    inline bool read_retry(uint32_t sequence);
+
+    // Current sequence, changed by each write
+    inline uint32_t get_sequence() { return __atomic_load_n(&_sequence, __ATOMIC_ACQUIRE); }
+
+private:
+    uint32_t _sequence;   // Odd while a write is in progress
+    bool     _enabled;
+};
+
+//
+// Minimal spin lock, for short sections which almost never contend
+// (e.g. the channels shared by the contexts of a process).
+//
+class spinlock
+{
+public:
+    inline spinlock() : _locked(0) {}
+
+    inline void lock();
+    inline void unlock() { __atomic_store_n(&_locked, 0, __ATOMIC_RELEASE); }
+
+    // Hold the lock in a scope
+    class guard
+    {
+    public:
+        inline guard(spinlock& lock) : _lock(lock) { _lock.lock(); }
+        inline ~guard() { _lock.unlock(); }
+    private:
+        spinlock& _lock;
+    };
+
+private:
+    uint32_t _locked;
+};
+
+//***************************************************************************
+// Inlines
+//***************************************************************************
+void spinlock::lock()
+{
+    while (__atomic_exchange_n(&_locked, 1, __ATOMIC_ACQUIRE) != 0) {
+        while (__atomic_load_n(&_locked, __ATOMIC_RELAXED) != 0) {
+#if defined(__i386__) || defined(__x86_64__)
+            __builtin_ia32_pause();
+#endif
+        }
+    }
+}
+
+void seqlock::write_begin()
+{
+    if (!_enabled) return;
+
+    // From even to odd: only one writer gets it
+    uint32_t sequence = __atomic_load_n(&_sequence, __ATOMIC_RELAXED);
+    for (;;) {
+        if ((sequence & 1) == 0 &&
+            __atomic_compare_exchange_n(&_sequence, &sequence, sequence + 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            break;
+        }
+#if defined(__i386__) || defined(__x86_64__)
+        __builtin_ia32_pause();
+#endif
+        sequence = __atomic_load_n(&_sequence, __ATOMIC_RELAXED);
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void seqlock::write_end()
+{
+    if (!_enabled) return;
+    __atomic_store_n(&_sequence, _sequence + 1, __ATOMIC_RELEASE);
+}
+
+uint32_t seqlock::read_begin()
+{
+    if (!_enabled) return 0;
+
+    uint32_t sequence;
+    while ((sequence = __atomic_load_n(&_sequence, __ATOMIC_ACQUIRE)) & 1) {
+#if defined(__i386__) || defined(__x86_64__)
+        __builtin_ia32_pause();
+#endif
+    }
+    return sequence;
+}
+
+bool seqlock::read_retry(uint32_t sequence)
+{
+    if (!_enabled) return false;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&_sequence, __ATOMIC_RELAXED) != sequence;
+}
+
+}
+#endif
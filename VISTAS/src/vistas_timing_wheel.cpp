@@ -0,0 +1,195 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Hierarchical timing wheel of periodic output ports.
+//
+#include "vistas_timing_wheel.hh"
+#include <string.h>
+
+#define TIMING_WHEEL_MASK (TIMING_WHEEL_SLOTS - 1)
+
+namespace vistas
+{
+
+timing_wheel::timing_wheel(uint32_t tick_us) :
+    _tick_us((tick_us != 0)? tick_us : 1),
+    _current(0),
+    _overflow(NULL),
+    _count(0)
+{
+    memset(_slots, 0, sizeof(_slots));
+    memset(_level_count, 0, sizeof(_level_count));
+}
+
+//
+// Forget all the entries and restart at the given time
+//
+void timing_wheel::reset(uint64_t now_us)
+{
+    for (uint32_t level = 0; level < TIMING_WHEEL_LEVELS; level++) {
+        for (uint32_t slot = 0; slot < TIMING_WHEEL_SLOTS; slot++) {
+            while (_slots[level][slot]) unlink(_slots[level][slot]);
+        }
+    }
+    while (_overflow) unlink(_overflow);
+
+    _current = now_us / _tick_us;
+}
+
+void timing_wheel::schedule(entry* e, uint64_t due_us)
+{
+    cancel(e);
+    e->due_us = due_us;
+    insert(e);
+}
+
+void timing_wheel::cancel(entry* e)
+{
+    if (e->is_scheduled()) unlink(e);
+}
+
+//
+// Level 0 for the next turn of ticks, then each level for the next turn of
+// the level below
+//
+void timing_wheel::insert(entry* e)
+{
+    uint64_t tick = e->due_us / _tick_us;
+    if (tick < _current) tick = _current;
+    uint64_t delta = tick - _current;
+
+    entry** head = &_overflow;
+    e->level = TIMING_WHEEL_LEVELS;
+    for (uint32_t level = 0; level < TIMING_WHEEL_LEVELS; level++) {
+        if (delta < (1ULL << (TIMING_WHEEL_BITS * (level + 1)))) {
+            head = &_slots[level][(tick >> (TIMING_WHEEL_BITS * level)) & TIMING_WHEEL_MASK];
+            e->level = level;
+            break;
+        }
+    }
+
+    e->next = *head;
+    if (e->next) e->next->pprev = &e->next;
+    *head = e;
+    e->pprev = head;
+
+    _level_count[e->level]++;
+    _count++;
+}
+
+void timing_wheel::unlink(entry* e)
+{
+    *e->pprev = e->next;
+    if (e->next) e->next->pprev = e->pprev;
+    e->next = NULL;
+    e->pprev = NULL;
+
+    _level_count[e->level]--;
+    _count--;
+}
+
+//
+// Called when the current tick starts a slot of the level
+//
+void timing_wheel::cascade(uint32_t level)
+{
+    entry** head = (level < TIMING_WHEEL_LEVELS)?
+                   &_slots[level][(_current >> (TIMING_WHEEL_BITS * level)) & TIMING_WHEEL_MASK] :
+                   &_overflow;
+
+    entry* e = *head;
+    while (e) {
+        entry* next = e->next;
+        unlink(e);
+        insert(e);
+        e = next;
+    }
+}
+
+//
+// Walk the ticks up to now_us. Empty stretches of level 0 are skipped up to
+// the next cascade.
+//
+void timing_wheel::advance(uint64_t now_us, std::vector<entry*>& due)
+{
+    uint64_t target = now_us / _tick_us;
+
+    for (;;) {
+        // Entries of the current tick due later stay in its slot
+        entry* e = _slots[0][_current & TIMING_WHEEL_MASK];
+        while (e) {
+            entry* next = e->next;
+            if (e->due_us <= now_us) {
+                unlink(e);
+                due.push_back(e);
+            }
+            e = next;
+        }
+
+        if (_current >= target) break;
+
+        if (_count == 0) {
+            _current = target;
+            continue;
+        }
+        if (_level_count[0] == 0) {
+            uint64_t turn_end = (_current | TIMING_WHEEL_MASK) + 1;
+            _current = (target < turn_end)? target : turn_end;
+        } else {
+            _current++;
+        }
+
+        // Upper levels first: their entries may go down to the next cascaded slot
+        if ((_current & TIMING_WHEEL_MASK) == 0) {
+            uint32_t top = 1;
+            while (top < TIMING_WHEEL_LEVELS &&
+                   ((_current >> (TIMING_WHEEL_BITS * top)) & TIMING_WHEEL_MASK) == 0) {
+                top++;
+            }
+            for (uint32_t level = top; level >= 1; level--) {
+                cascade(level);
+            }
+        }
+    }
+}
+
+//
+// Level 0 entries are in the next turn of ticks: the first slot found holds
+// the earliest ones. Entries of upper levels are not due before the next
+// cascade.
+//
+uint64_t timing_wheel::next_wakeup_us()
+{
+    if (_count == 0) return UINT64_MAX;
+
+    uint64_t wakeup_us = UINT64_MAX;
+    if (_count != _level_count[0]) {
+        wakeup_us = ((_current | TIMING_WHEEL_MASK) + 1) * _tick_us;
+    }
+
+    if (_level_count[0] != 0) {
+        for (uint32_t islot = 0; islot < TIMING_WHEEL_SLOTS; islot++) {
+            entry* e = _slots[0][(_current + islot) & TIMING_WHEEL_MASK];
+            if (e == NULL) continue;
+
+            for (; e != NULL; e = e->next) {
+                if (e->due_us < wakeup_us) wakeup_us = e->due_us;
+            }
+            break;
+        }
+    }
+
+    return wakeup_us;
+}
+
+}
@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Hierarchical timing wheel of periodic output ports.
+// Ports are kept by due date: finding the due ones costs the number of due
+// ports, not the number of scheduled ones. Level 0 has one slot per tick,
+// each upper level one slot per turn of the level below. Entries of an upper
+// level are moved down when its slot comes (cascade).
+// The entries are intrusive (@see port_application_base): no allocation.
+//
+#ifndef _VISTAS_TIMING_WHEEL_HH_
+#define _VISTAS_TIMING_WHEEL_HH_
+#include "ims.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#define TIMING_WHEEL_BITS   8
+#define TIMING_WHEEL_SLOTS  (1 << TIMING_WHEEL_BITS)
+#define TIMING_WHEEL_LEVELS 3       // Farther entries wait in an overflow list
+
+namespace vistas
+{
+class port_application_base;
+
+class timing_wheel
+{
+public:
+    struct entry
+    {
+        inline entry(port_application_base* p) : next(NULL), pprev(NULL), due_us(0), level(0), port(p) {}
+        inline bool is_scheduled() { return pprev != NULL; }
+
+        entry*                 next;
+        entry**                pprev;   // NULL when not scheduled
+        uint64_t               due_us;
+        uint32_t               level;   // TIMING_WHEEL_LEVELS for the overflow list
+        port_application_base* port;
+    };
+
+    // tick_us: duration of a level 0 slot. Due dates are kept exact: an
+    // entry is only due once the time has reached its date.
+    timing_wheel(uint32_t tick_us);
+
+    // Forget all the entries and restart at the given time
+    void reset(uint64_t now_us);
+
+    // (Re)schedule an entry. A date already passed is due at the next advance.
+    void schedule(entry* e, uint64_t due_us);
+
+    // Unschedule an entry, if scheduled
+    void cancel(entry* e);
+
+    // Move the time to now_us, and append the entries due to the vector, in
+    // due slot order. They are unscheduled. The time never goes back.
+    void advance(uint64_t now_us, std::vector<entry*>& due);
+
+    // Date to call advance at: the earliest due date, or an earlier one when
+    // entries of upper levels must be moved down. UINT64_MAX when empty.
+    uint64_t next_wakeup_us();
+
+    inline uint32_t size() { return _count; }
+
+private:
+    void insert(entry* e);
+    void unlink(entry* e);
+
+    // Move the entries of the slot of an upper level, and the overflow list
+    // after the last level, down to their level
+    void cascade(uint32_t level);
+
+    uint32_t _tick_us;
+    uint64_t _current;                                     // Current tick: the ones before are done
+    entry*   _slots[TIMING_WHEEL_LEVELS][TIMING_WHEEL_SLOTS];
+    uint32_t _level_count[TIMING_WHEEL_LEVELS + 1];
+    entry*   _overflow;
+    uint32_t _count;
+};
+}
+#endif
@@ -0,0 +1,357 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Minimal io_uring instance (Linux only).
+//
+#include "vistas_uring.hh"
+
+#ifdef VISTAS_HAVE_URING
+#include <algorithm>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+
+// Size of a provided buffer: the biggest UDP datagram, behind the recvmsg header and source address.
+// Buffers are anonymous mappings, so only the pages effectively written are resident.
+#define URING_BUFFER_SIZE   (65536 + sizeof(struct io_uring_recvmsg_out) + sizeof(struct sockaddr_in))
+
+// Provided buffer group used by receives
+#define URING_BUFFER_GROUP  0
+
+namespace vistas
+{
+
+//
+// Create the ring
+//
+uring::uring(uint32_t entries, uint32_t buffer_count)
+throw(ims::exception) :
+    _fd(-1),
+    _sq_ring(MAP_FAILED),
+    _sq_ring_size(0),
+    _sq_tail(0),
+    _sqes((struct io_uring_sqe*)MAP_FAILED),
+    _sqes_size(0),
+    _cq_ring(MAP_FAILED),
+    _cq_ring_size(0),
+    _buf_ring((struct io_uring_buf_ring*)MAP_FAILED),
+    _buf_ring_size(0),
+    _buf_tail(0),
+    _buf_mask(0),
+    _buffers((char*)MAP_FAILED),
+    _buffers_size(0),
+    _buffer_count(buffer_count)
+{
+    memset(&_recv_msg, 0, sizeof(_recv_msg));
+    _recv_msg.msg_namelen = sizeof(struct sockaddr_in);
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    // Multishot receives may produce much more completions than submissions
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = (buffer_count > entries)? buffer_count * 2 : entries * 2;
+
+    _fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (_fd < 0) {
+        THROW_IMS_ERROR(ims_init_failure, "Cannot create io_uring instance! error: " << strerror(errno));
+    }
+
+    // Map the rings
+    _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+    }
+
+    _sq_ring = mmap(NULL, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+    if (_sq_ring == MAP_FAILED) {
+        release();
+        THROW_IMS_ERROR(ims_init_failure, "Cannot map io_uring submission queue! error: " << strerror(errno));
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        _cq_ring = _sq_ring;
+    } else {
+        _cq_ring = mmap(NULL, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+        if (_cq_ring == MAP_FAILED) {
+            release();
+            THROW_IMS_ERROR(ims_init_failure, "Cannot map io_uring completion queue! error: " << strerror(errno));
+        }
+    }
+
+    _sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    _sqes = (struct io_uring_sqe*)mmap(NULL, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+    if (_sqes == MAP_FAILED) {
+        release();
+        THROW_IMS_ERROR(ims_init_failure, "Cannot map io_uring submission entries! error: " << strerror(errno));
+    }
+
+    char* sq_ring = (char*)_sq_ring;
+    _sq_khead   = (uint32_t*)(sq_ring + params.sq_off.head);
+    _sq_ktail   = (uint32_t*)(sq_ring + params.sq_off.tail);
+    _sq_array   = (uint32_t*)(sq_ring + params.sq_off.array);
+    _sq_mask    = *(uint32_t*)(sq_ring + params.sq_off.ring_mask);
+    _sq_entries = params.sq_entries;
+    _sq_tail    = *_sq_ktail;
+
+    char* cq_ring = (char*)_cq_ring;
+    _cq_khead = (uint32_t*)(cq_ring + params.cq_off.head);
+    _cq_ktail = (uint32_t*)(cq_ring + params.cq_off.tail);
+    _cq_mask  = *(uint32_t*)(cq_ring + params.cq_off.ring_mask);
+    _cqes     = (struct io_uring_cqe*)(cq_ring + params.cq_off.cqes);
+
+    if (buffer_count == 0) return;
+
+    // Register the provided buffer ring
+    _buf_ring_size = buffer_count * sizeof(struct io_uring_buf);
+    _buf_ring = (struct io_uring_buf_ring*)mmap(NULL, _buf_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    _buffers_size = buffer_count * URING_BUFFER_SIZE;
+    _buffers = (char*)mmap(NULL, _buffers_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (_buf_ring == MAP_FAILED || _buffers == MAP_FAILED) {
+        release();
+        THROW_IMS_ERROR(ims_init_failure, "Cannot allocate io_uring buffers! error: " << strerror(errno));
+    }
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)_buf_ring;
+    reg.ring_entries = buffer_count;
+    reg.bgid = URING_BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, _fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+        release();
+        THROW_IMS_ERROR(ims_init_failure, "Cannot register io_uring buffer ring! error: " << strerror(errno));
+    }
+
+    _buf_mask = buffer_count - 1;
+    for (uint32_t buffer_id = 0; buffer_id < buffer_count; buffer_id++) {
+        release_buffer(buffer_id);
+    }
+}
+
+uring::~uring()
+{
+    release();
+}
+
+void uring::release()
+{
+    if (_buffers != MAP_FAILED) munmap(_buffers, _buffers_size);
+    if (_buf_ring != MAP_FAILED) munmap(_buf_ring, _buf_ring_size);
+    if (_sqes != MAP_FAILED) munmap(_sqes, _sqes_size);
+    if (_cq_ring != MAP_FAILED && _cq_ring != _sq_ring) munmap(_cq_ring, _cq_ring_size);
+    if (_sq_ring != MAP_FAILED) munmap(_sq_ring, _sq_ring_size);
+    if (_fd >= 0) ::close(_fd);
+
+    _buffers = (char*)MAP_FAILED;
+    _buf_ring = (struct io_uring_buf_ring*)MAP_FAILED;
+    _sqes = (struct io_uring_sqe*)MAP_FAILED;
+    _cq_ring = _sq_ring = MAP_FAILED;
+    _fd = -1;
+}
+
+//
+// Get a free submission entry. Submit queued ones if the queue is full.
+//
+struct io_uring_sqe* uring::get_sqe()
+throw(ims::exception)
+{
+    if (space() == 0) submit();
+
+    uint32_t index = _sq_tail & _sq_mask;
+    struct io_uring_sqe* sqe = &_sqes[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    _sq_array[index] = index;
+    _sq_tail++;
+
+    return sqe;
+}
+
+void uring::arm_receive(IMS_SOCKET fd, uint64_t user_data)
+throw(ims::exception)
+{
+    struct io_uring_sqe* sqe = get_sqe();
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)&_recv_msg;
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = user_data;
+}
+
+void uring::cancel(uint64_t user_data)
+throw(ims::exception)
+{
+    struct io_uring_sqe* sqe = get_sqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = user_data;
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_ALL;
+    sqe->user_data = ignored_data;
+}
+
+void uring::send(IMS_SOCKET fd, const struct msghdr* msg, uint64_t user_data, bool linked)
+throw(ims::exception)
+{
+    struct io_uring_sqe* sqe = get_sqe();
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)msg;
+    sqe->len = 1;
+    // A full socket fails at once, instead of waiting in the kernel
+    sqe->msg_flags = MSG_DONTWAIT;
+    sqe->user_data = user_data;
+    if (linked) sqe->flags = IOSQE_IO_LINK;
+}
+
+//
+// Submit queued requests
+//
+void uring::submit(uint32_t wait_nr)
+throw(ims::exception)
+{
+    // Publish the new entries
+    __atomic_store_n(_sq_ktail, _sq_tail, __ATOMIC_RELEASE);
+
+    for (;;) {
+        uint32_t to_submit = _sq_tail - __atomic_load_n(_sq_khead, __ATOMIC_ACQUIRE);
+
+        // GETEVENTS also runs the pending task work, which posts the receive completions
+        int res = syscall(__NR_io_uring_enter, _fd, to_submit, wait_nr, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (res >= 0) return;
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EBUSY) {
+            // Completion queue is full: the caller has to reap it
+            if (wait_nr == 0) return;
+            wait_nr = 0;
+            continue;
+        }
+        THROW_IMS_ERROR(ims_implementation_specific_error, "io_uring_enter fail! error: " << strerror(errno));
+    }
+}
+
+//
+// Read available completions
+//
+uint32_t uring::reap(completion* completions, uint32_t count)
+{
+    uint32_t head = *_cq_khead;
+    uint32_t tail = __atomic_load_n(_cq_ktail, __ATOMIC_ACQUIRE);
+
+    uint32_t reaped;
+    for (reaped = 0; reaped < count && head != tail; reaped++, head++) {
+        struct io_uring_cqe* cqe = &_cqes[head & _cq_mask];
+        completions[reaped].user_data = cqe->user_data;
+        completions[reaped].res = cqe->res;
+        completions[reaped].flags = cqe->flags;
+    }
+
+    __atomic_store_n(_cq_khead, head, __ATOMIC_RELEASE);
+    return reaped;
+}
+
+//
+// Decode the datagram of a receive completion
+//
+bool uring::get_datagram(const completion& completion, uring_inbox::pending& datagram)
+{
+    if ((completion.flags & IORING_CQE_F_BUFFER) == 0) return false;
+
+    datagram.buffer_id = completion.flags >> IORING_CQE_BUFFER_SHIFT;
+    if (completion.res < 0) {
+        release_buffer(datagram.buffer_id);
+        return false;
+    }
+
+    // Buffer layout: recvmsg header, source address, payload
+    char* buffer = _buffers + datagram.buffer_id * URING_BUFFER_SIZE;
+    struct io_uring_recvmsg_out* out = (struct io_uring_recvmsg_out*)buffer;
+    datagram.from = (struct sockaddr_in*)(buffer + sizeof(struct io_uring_recvmsg_out));
+    datagram.payload = buffer + sizeof(struct io_uring_recvmsg_out) + _recv_msg.msg_namelen;
+    datagram.size = completion.res - sizeof(struct io_uring_recvmsg_out) - _recv_msg.msg_namelen;
+
+    if (out->flags & MSG_TRUNC) {
+        LOG_ERROR("Datagram of " << out->payloadlen << " bytes truncated to " << datagram.size << " bytes!");
+    }
+
+    return true;
+}
+
+void uring::release_buffer(uint16_t buffer_id)
+{
+    // Entries overlay the ring header. Not indexed through bufs[]: its C++ flexible
+    // array wrapper adds padding and doesn't match the kernel layout.
+    struct io_uring_buf* buf = (struct io_uring_buf*)_buf_ring + (_buf_tail & _buf_mask);
+    buf->addr = (uint64_t)(uintptr_t)(_buffers + buffer_id * URING_BUFFER_SIZE);
+    buf->len = URING_BUFFER_SIZE;
+    buf->bid = buffer_id;
+    _buf_tail++;
+    __atomic_store_n(&_buf_ring->tail, _buf_tail, __ATOMIC_RELEASE);
+}
+
+//
+// Copy datagrams of the inbox in the given slots
+//
+uint32_t uring::receive_many(uring_inbox& inbox, socket::datagram* datagrams, uint32_t count)
+{
+    uint32_t received;
+    for (received = 0; received < count && !inbox.empty(); received++, inbox.head++) {
+        uring_inbox::pending& pending = inbox.datagrams[inbox.head];
+        socket::datagram& current = datagrams[received];
+
+        // Same behaviour as recvmmsg: a too big datagram is truncated,
+        // and what doesn't fit in the buffer goes to the payload segment.
+        uint32_t head_size = std::min(pending.size, current.buffer_size);
+        uint32_t tail_size = (current.payload != NULL)? std::min(pending.size - head_size, current.payload_size) : 0;
+        memcpy(current.buffer, pending.payload, head_size);
+        if (tail_size > 0) memcpy(current.payload, pending.payload + head_size, tail_size);
+        current.size = head_size + tail_size;
+
+#ifdef ENABLE_INSTRUMENTATION
+        // Call handler
+        if(ims_socket_handler_recv){
+            ims_socket_handler_recv(pending.payload,
+                                    current.size,
+                                    inet_ntoa(pending.from->sin_addr),
+                                    ntohs(pending.from->sin_port));
+        }
+#endif
+
+        release_buffer(pending.buffer_id);
+    }
+
+    if (inbox.empty()) {
+        inbox.datagrams.clear();
+        inbox.head = 0;
+    }
+
+    return received;
+}
+
+//
+// Release all the buffers still held by the inbox
+//
+void uring::clear(uring_inbox& inbox)
+{
+    for (; !inbox.empty(); inbox.head++) {
+        release_buffer(inbox.datagrams[inbox.head].buffer_id);
+    }
+    inbox.datagrams.clear();
+    inbox.head = 0;
+}
+
+}
+#endif
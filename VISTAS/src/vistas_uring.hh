@@ -0,0 +1,174 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Minimal io_uring instance (Linux only).
+// Used by the socket pool to keep multishot receives armed on its input
+// sockets, and by the send batch to submit a whole cycle at once.
+// Received datagrams are written by the kernel in provided buffers, and
+// wait in the inbox of their socket until its port reads them.
+//
+#ifndef _VISTAS_URING_HH_
+#define _VISTAS_URING_HH_
+#include "vistas_socket.hh"
+#include <vector>
+
+#ifdef __linux
+#include <linux/io_uring.h>
+// Multishot recvmsg and provided buffer rings are both needed (kernel headers >= 6.0)
+#ifdef IORING_RECV_MULTISHOT
+#define VISTAS_HAVE_URING
+#endif
+#endif
+
+namespace vistas
+{
+class uring;
+typedef shared_ptr<uring> uring_ptr;
+
+// Datagrams received for one socket, not yet read by its port
+struct uring_inbox
+{
+    struct pending
+    {
+        uint16_t            buffer_id;
+        char*               payload;
+        uint32_t            size;
+        struct sockaddr_in* from;
+    };
+
+    inline uring_inbox() : head(0), armed(false), ready(false), rearm(false) {}
+    inline bool empty() { return head == datagrams.size(); }
+
+    std::vector<pending> datagrams;
+    uint32_t             head;        // Next datagram to read
+    bool                 armed;       // A multishot receive is (or will be) armed on the socket
+    bool                 ready;       // Already in the ready list of the pool
+    bool                 rearm;       // The multishot receive stopped and must be armed again
+};
+
+#ifdef VISTAS_HAVE_URING
+class uring
+{
+public:
+    struct completion
+    {
+        uint64_t user_data;
+        int32_t  res;
+        uint32_t flags;
+    };
+
+    // Create the ring.
+    // If buffer_count is not 0, a provided buffer ring of buffer_count buffers
+    // is registered for receives (buffer_count must be a power of 2).
+    uring(uint32_t entries, uint32_t buffer_count = 0)
+    throw(ims::exception);
+
+    ~uring();
+
+    // Queue a multishot receive on the given datagram socket.
+    // Each received datagram is reported by a completion with user_data.
+    void arm_receive(IMS_SOCKET fd, uint64_t user_data)
+    throw(ims::exception);
+
+    // user_data of the completions which can be ignored (cancellations)
+    static const uint64_t ignored_data = ~0ULL;
+
+    // Queue the cancellation of the requests with the given user_data.
+    // The cancellation itself completes with ignored_data.
+    void cancel(uint64_t user_data)
+    throw(ims::exception);
+
+    // Queue a sendmsg. msg must stay valid until its completion.
+    // The request after a linked one waits for it, and is cancelled if it fails.
+    // A full socket fails the request with EAGAIN.
+    void send(IMS_SOCKET fd, const struct msghdr* msg, uint64_t user_data, bool linked = false)
+    throw(ims::exception);
+
+    // Number of requests which can still be queued before a submit
+    inline uint32_t space();
+
+    // Submit queued requests, process pending completions and wait for
+    // at least wait_nr of them.
+    void submit(uint32_t wait_nr = 0)
+    throw(ims::exception);
+
+    // Read up to count available completions
+    // @return The number of completions read
+    uint32_t reap(completion* completions, uint32_t count);
+
+    // Decode the datagram of a receive completion.
+    // @return false if the completion doesn't carry a datagram.
+    bool get_datagram(const completion& completion, uring_inbox::pending& datagram);
+
+    // Give a buffer back to the kernel
+    void release_buffer(uint16_t buffer_id);
+
+    // Copy up to count datagrams of the inbox in the given slots, and
+    // release their buffers.
+    // @return The number of datagrams copied
+    uint32_t receive_many(uring_inbox& inbox, socket::datagram* datagrams, uint32_t count);
+
+    // Release all the buffers still held by the inbox
+    void clear(uring_inbox& inbox);
+
+private:
+    struct io_uring_sqe* get_sqe() throw(ims::exception);
+
+    // Unmap and close everything
+    void release();
+
+    int                   _fd;
+
+    // Submission queue
+    void*                 _sq_ring;
+    size_t                _sq_ring_size;
+    uint32_t*             _sq_khead;
+    uint32_t*             _sq_ktail;
+    uint32_t*             _sq_array;
+    uint32_t              _sq_mask;
+    uint32_t              _sq_entries;
+    uint32_t              _sq_tail;          // Local tail, published on submit
+    struct io_uring_sqe*  _sqes;
+    size_t                _sqes_size;
+
+    // Completion queue
+    void*                 _cq_ring;
+    size_t                _cq_ring_size;
+    uint32_t*             _cq_khead;
+    uint32_t*             _cq_ktail;
+    uint32_t              _cq_mask;
+    struct io_uring_cqe*  _cqes;
+
+    // Provided buffers
+    struct io_uring_buf_ring* _buf_ring;
+    size_t                _buf_ring_size;
+    uint16_t              _buf_tail;
+    uint32_t              _buf_mask;
+    char*                 _buffers;
+    size_t                _buffers_size;
+    uint32_t              _buffer_count;
+
+    struct msghdr         _recv_msg;         // Template of multishot receives
+};
+
+//***************************************************************************
+// Inlines
+//***************************************************************************
+uint32_t uring::space()
+{
+    return _sq_entries - (_sq_tail - __atomic_load_n(_sq_khead, __ATOMIC_ACQUIRE));
+}
+#endif
+
+}
+#endif
@@ -0,0 +1,171 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Small pool of threads running the items of a job in parallel (Linux only).
+//
+#include "vistas_worker_pool.hh"
+
+#ifdef VISTAS_HAVE_WORKER_POOL
+#include <string.h>
+
+namespace vistas
+{
+
+worker_pool::worker_pool(uint32_t thread_count)
+throw(ims::exception) :
+    _job(NULL),
+    _generation(0),
+    _busy(0),
+    _stop(false),
+    _item_count(0),
+    _next_item(0),
+    _error(ims_no_error)
+{
+    pthread_mutex_init(&_mutex, NULL);
+    pthread_cond_init(&_start_cond, NULL);
+    pthread_cond_init(&_done_cond, NULL);
+
+    _threads.reserve(thread_count);
+    for (uint32_t ithread = 0; ithread < thread_count; ithread++) {
+        pthread_t thread;
+        int res = pthread_create(&thread, NULL, thread_main, this);
+        if (res != 0) {
+            LOG_WARN("Cannot create import worker " << ithread << ": " << strerror(res));
+            break;
+        }
+        _threads.push_back(thread);
+    }
+}
+
+worker_pool::~worker_pool()
+{
+    pthread_mutex_lock(&_mutex);
+    _stop = true;
+    pthread_cond_broadcast(&_start_cond);
+    pthread_mutex_unlock(&_mutex);
+
+    for (uint32_t ithread = 0; ithread < _threads.size(); ithread++) {
+        pthread_join(_threads[ithread], NULL);
+    }
+
+    pthread_cond_destroy(&_done_cond);
+    pthread_cond_destroy(&_start_cond);
+    pthread_mutex_destroy(&_mutex);
+}
+
+//
+// Run all the items of the job
+//
+void worker_pool::run(job& job, uint32_t item_count)
+throw(ims::exception)
+{
+    if (item_count == 0) return;
+
+    pthread_mutex_lock(&_mutex);
+    _job = &job;
+    _item_count = item_count;
+    __atomic_store_n(&_next_item, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_error, ims_no_error, __ATOMIC_RELAXED);
+    _error_message.clear();
+    _generation++;
+    pthread_cond_broadcast(&_start_cond);
+    pthread_mutex_unlock(&_mutex);
+
+    work();
+
+    // All items are claimed: wait for the ones still running
+    pthread_mutex_lock(&_mutex);
+    while (_busy != 0) {
+        pthread_cond_wait(&_done_cond, &_mutex);
+    }
+    _job = NULL;
+    std::string error_message;
+    error_message.swap(_error_message);
+    pthread_mutex_unlock(&_mutex);
+
+    uint32_t error = __atomic_load_n(&_error, __ATOMIC_ACQUIRE);
+    if (error != ims_no_error) {
+        throw ims::exception((ims_return_code_t)error, error_message);
+    }
+}
+
+void* worker_pool::thread_main(void* self)
+{
+    ((worker_pool*)self)->wait_jobs();
+    return NULL;
+}
+
+//
+// Thread loop: take part in each posted job
+//
+void worker_pool::wait_jobs()
+{
+    pthread_mutex_lock(&_mutex);
+    uint32_t generation = _generation;
+
+    for (;;) {
+        while (_stop == false && (_generation == generation || _job == NULL)) {
+            pthread_cond_wait(&_start_cond, &_mutex);
+        }
+        if (_stop) break;
+
+        generation = _generation;
+        _busy++;
+        pthread_mutex_unlock(&_mutex);
+
+        work();
+
+        pthread_mutex_lock(&_mutex);
+        if (--_busy == 0) {
+            pthread_cond_signal(&_done_cond);
+        }
+    }
+
+    pthread_mutex_unlock(&_mutex);
+}
+
+//
+// Claim and run items of the current job until none is left
+//
+void worker_pool::work()
+{
+    uint32_t item;
+    while ((item = __atomic_fetch_add(&_next_item, 1, __ATOMIC_ACQ_REL)) < _item_count) {
+        try {
+            _job->run(item);
+        } catch (ims::exception& e) {
+            set_error(e.get_ims_return_code(), e.what());
+        } catch (std::exception& e) {
+            set_error(ims_implementation_specific_error, e.what());
+        } catch (...) {
+            set_error(ims_implementation_specific_error, "Unknown exception in a worker item");
+        }
+    }
+}
+
+//
+// Keep the first error of the job, with its message
+//
+void worker_pool::set_error(ims_return_code_t error, const char* message)
+{
+    uint32_t expected = ims_no_error;
+    if (__atomic_compare_exchange_n(&_error, &expected, (uint32_t)error,
+                                    false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        pthread_mutex_lock(&_mutex);
+        _error_message = message;
+        pthread_mutex_unlock(&_mutex);
+    }
+}
+
+}
+#endif
@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Small pool of threads running the items of a job in parallel (Linux only).
+// The calling thread takes part. Items are claimed one at a time, so a
+// thread done with a cheap item takes the next pending one instead of
+// waiting for the others.
+// The threads only wait on the pool mutex between two jobs: items must not
+// share state, nothing protects them.
+//
+#ifndef _VISTAS_WORKER_POOL_HH_
+#define _VISTAS_WORKER_POOL_HH_
+#include "ims_log.hh"
+#include "shared_ptr.hh"
+#include <string>
+#include <vector>
+
+#ifdef __linux
+#include <pthread.h>
+#define VISTAS_HAVE_WORKER_POOL
+#endif
+
+namespace vistas
+{
+#ifdef VISTAS_HAVE_WORKER_POOL
+class worker_pool;
+typedef shared_ptr<worker_pool> worker_pool_ptr;
+
+class worker_pool
+{
+public:
+    class job
+    {
+    public:
+        virtual void run(uint32_t item) = 0;
+        virtual ~job() {}
+    };
+
+    // Start thread_count threads besides the caller
+    worker_pool(uint32_t thread_count)
+    throw(ims::exception);
+
+    // Stop and join the threads
+    ~worker_pool();
+
+    // Run all the items of the job and return once they are all done.
+    // If items throw, the first error is thrown again at the end, with its message.
+    void run(job& job, uint32_t item_count)
+    throw(ims::exception);
+
+    inline uint32_t get_thread_count() { return _threads.size(); }
+
+private:
+    static void* thread_main(void* self);
+    void wait_jobs();
+
+    // Claim and run items of the current job until none is left
+    void work();
+    void set_error(ims_return_code_t error, const char* message);
+
+    std::vector<pthread_t> _threads;
+    pthread_mutex_t        _mutex;
+    pthread_cond_t         _start_cond;     // A job is posted, or the pool stops
+    pthread_cond_t         _done_cond;      // No thread is working anymore
+    job*                   _job;
+    uint32_t               _generation;     // Incremented by each job
+    uint32_t               _busy;           // Threads working on the current job
+    bool                   _stop;
+    uint32_t               _item_count;
+    uint32_t               _next_item;      // Atomic
+    uint32_t               _error;          // Atomic: first ims_return_code_t thrown
+    std::string            _error_message;  // Message of the first error, under _mutex
+};
+#endif
+
+}
+#endif
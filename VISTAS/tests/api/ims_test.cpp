@@ -173,6 +173,14 @@ uint32_t ims_test_mc_input_receive(ims_test_mc_input_t socket_base, char* buffer
     return socket->receive(buffer, buffer_size, timeout_us);
 }
 
+// Read the socket, with the receive date
+uint32_t ims_test_mc_input_receive_dated(ims_test_mc_input_t socket_base, char* buffer, uint32_t buffer_size, uint32_t timeout_us,
+                                         uint64_t* date_us)
+{
+    ims_test::mc_input* socket = static_cast<ims_test::mc_input*>(socket_base);
+    return socket->receive(buffer, buffer_size, timeout_us, date_us);
+}
+
 // Free the socket
 void ims_test_mc_input_free(ims_test_mc_input_t socket_base)
 {
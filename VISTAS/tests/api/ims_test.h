@@ -157,6 +157,10 @@ ims_test_mc_input_t ims_test_mc_input_create(ims_test_actor_t actor, const char*
 // Read the socket
 uint32_t ims_test_mc_input_receive(ims_test_mc_input_t socket, char* buffer, uint32_t buffer_size, uint32_t timeout_us);
 
+// Read the socket, and give the date (us) the datagram has been received by the system
+uint32_t ims_test_mc_input_receive_dated(ims_test_mc_input_t socket, char* buffer, uint32_t buffer_size, uint32_t timeout_us,
+                                         uint64_t* date_us);
+
 // Free the socket
 void ims_test_mc_input_free(ims_test_mc_input_t socket);
 
@@ -18,6 +18,7 @@
 
 #ifdef __linux
 #include <arpa/inet.h>
+#include <sys/time.h>
 #endif
 #ifdef _WIN32
 #include <winsock2.h>
@@ -78,12 +79,19 @@ mc_input::mc_input(ims_test_actor_t actor_base, std::string ip, uint32_t port)
         TEST_ABORT(actor, "Failed to join multicast group %s!", ip.c_str());
     }
 
+#ifdef __linux
+    // Date the datagrams when they arrive, not when they are read
+    if (setsockopt(_sock, SOL_SOCKET, SO_TIMESTAMP, (const char*) &one, sizeof(one)) != 0) {
+        close();
+        TEST_ABORT(actor, "Failed to set SO_TIMESTAMP on socket !");
+    }
+#endif
 }
 
 //
 // Receive from the socket
 //
-uint32_t mc_input::receive(char* buffer, uint32_t buffer_size, uint32_t timeout_us)
+uint32_t mc_input::receive(char* buffer, uint32_t buffer_size, uint32_t timeout_us, uint64_t* date_us)
 {
     struct timeval tv;
     tv.tv_sec = 0;
@@ -94,8 +102,38 @@ uint32_t mc_input::receive(char* buffer, uint32_t buffer_size, uint32_t timeout_
     FD_SET(_sock, &select_set);
 
     int result = select(_sock + 1, &select_set, NULL, NULL, &tv);
-    if (result > 0) {
+    if (result > 0 && date_us == NULL) {
         return recvfrom(_sock, buffer, buffer_size, 0, NULL, NULL);
+    } else if (result > 0) {
+#ifdef __linux
+        struct iovec iov;
+        iov.iov_base = buffer;
+        iov.iov_len = buffer_size;
+
+        char control[CMSG_SPACE(sizeof(struct timeval))];
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        int size = recvmsg(_sock, &message, 0);
+        if (size < 0) return 0;
+
+        *date_us = ims_test_time_us();
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != NULL; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMP) {
+                struct timeval received;
+                memcpy(&received, CMSG_DATA(cmsg), sizeof(received));
+                *date_us = received.tv_sec * 1000000ULL + received.tv_usec;
+            }
+        }
+        return size;
+#else
+        *date_us = ims_test_time_us();
+        return recvfrom(_sock, buffer, buffer_size, 0, NULL, NULL);
+#endif
     } else {
         return 0;
     }
@@ -37,7 +37,8 @@ public:
     mc_input(ims_test_actor_t actor_base, std::string ip, uint32_t port);
     ~mc_input() { close(); }
 
-    uint32_t receive(char* buffer, uint32_t buffer_size, uint32_t timeout_us);
+    // date_us, if not NULL, is the date the system received the datagram
+    uint32_t receive(char* buffer, uint32_t buffer_size, uint32_t timeout_us, uint64_t* date_us = NULL);
 
 private:
     void close();
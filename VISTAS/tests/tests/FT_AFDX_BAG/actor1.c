@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+
+//
+// AFDX BAG test - actor 1
+//
+#include "ims_test.h"
+
+#define IMS_CONFIG_FILE      "config/actor1/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor1/vistas.xml"
+
+#define ACTOR_ID 1
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_SIZE      8
+#define MESSAGE_DEPTH     10
+#define BURST_COUNT       8
+
+#define LINK_COUNT 2
+static const char*    link_names[LINK_COUNT] = { "link1", "link2" };
+static const uint32_t link_bags_us[LINK_COUNT] = { 2000, 4000 };
+
+#define INVALID_POINTER ((void*)42)
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  ims_links[LINK_COUNT];
+    uint32_t       payload[2];
+    uint32_t       ilink;
+    uint32_t       counter;
+    uint32_t       retried_count;
+    uint32_t       dropped_count;
+    int            error = 0;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    TEST_WAIT(actor, 2); // Wait actor2 ready to read before starting our tests
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    for (ilink = 0; ilink < LINK_COUNT; ilink++) {
+        ims_links[ilink] = (ims_message_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, link_names[ilink], MESSAGE_SIZE, MESSAGE_DEPTH, ims_output, &ims_links[ilink]) == ims_no_error &&
+                           ims_links[ilink] != (ims_message_t)INVALID_POINTER && ims_links[ilink] != NULL,
+                           "We can get the message %s.", link_names[ilink]);
+    }
+
+    // A burst on each link: the payload is the link then the counter
+    for (ilink = 0; ilink < LINK_COUNT; ilink++) {
+        for (counter = 0; counter < BURST_COUNT; counter++) {
+            payload[0] = ilink;
+            payload[1] = counter;
+            if (ims_push_queuing_message(ims_links[ilink], (const char*)payload, MESSAGE_SIZE) != ims_no_error) error = 1;
+        }
+    }
+    TEST_ASSERT(actor, error == 0, "The bursts are pushed.");
+
+    // The pacing thread sends them: ims_send_all doesn't wait for the BAGs
+    uint64_t send_start_us = ims_test_time_us();
+    TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "ims_send_all return ims_no_error.");
+    uint64_t send_us = ims_test_time_us() - send_start_us;
+    TEST_LOG(actor, "ims_send_all took %u us.", (uint32_t)send_us);
+    TEST_ASSERT(actor, send_us < (BURST_COUNT - 1) * link_bags_us[0], "ims_send_all returns before the bursts are sent.");
+
+    TEST_WAIT(actor, 2); // actor2 has received the bursts
+
+    for (ilink = 0; ilink < LINK_COUNT; ilink++) {
+        TEST_ASSERT(actor, ims_message_send_counters(ims_links[ilink], &retried_count, &dropped_count) == ims_no_error,
+                    "message_send_counters of %s return no_error.", link_names[ilink]);
+        TEST_ASSERT(actor, dropped_count == 0, "No datagram of %s dropped.", link_names[ilink]);
+    }
+
+    ims_free_context(ims_context);
+
+    return ims_test_end(actor);
+}
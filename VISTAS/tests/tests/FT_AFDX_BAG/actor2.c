@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+
+//
+// AFDX BAG test - actor 2
+//
+#include "ims_test.h"
+
+#define ACTOR_ID 2
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_IP        "226.23.12.4"
+#define MESSAGE_SIZE      8
+#define BURST_COUNT       8
+
+#define LINK_COUNT 2
+static const uint32_t link_ports[LINK_COUNT] = { 5800, 5801 };
+static const uint32_t link_bags_us[LINK_COUNT] = { 2000, 4000 };
+
+// Dates are rounded to the us
+#define GAP_TOLERANCE_US  10
+
+#define RECEIVE_TIMEOUT_US  (5 * TEST_SECOND)
+
+int main()
+{
+    ims_test_mc_input_t sockets[LINK_COUNT];
+    char                received_payload[100];
+    uint32_t            payload[2];
+    uint64_t            date_us;
+    uint64_t            last_date_us[LINK_COUNT] = { 0 };
+    uint64_t            min_gap_us[LINK_COUNT];
+    uint32_t            received_count[LINK_COUNT] = { 0 };
+    int                 in_order[LINK_COUNT];
+    uint32_t            ilink;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    for (ilink = 0; ilink < LINK_COUNT; ilink++) {
+        sockets[ilink] = ims_test_mc_input_create(actor, MESSAGE_IP, link_ports[ilink]);
+        min_gap_us[ilink] = (uint64_t)-1;
+        in_order[ilink] = 1;
+    }
+
+    TEST_SIGNAL(actor, 1); // We are ready
+
+    // The datagrams are dated by the system when they arrive
+    uint64_t start_us = ims_test_time_us();
+    while ((received_count[0] < BURST_COUNT || received_count[1] < BURST_COUNT) &&
+           ims_test_time_us() - start_us < RECEIVE_TIMEOUT_US) {
+        for (ilink = 0; ilink < LINK_COUNT; ilink++) {
+            if (ims_test_mc_input_receive_dated(sockets[ilink], received_payload, 100, TEST_MILISECOND, &date_us) != VISTAS_HEADER_SIZE + MESSAGE_SIZE) {
+                continue;
+            }
+            memcpy(payload, received_payload + VISTAS_HEADER_SIZE, MESSAGE_SIZE);
+            if (payload[0] != ilink || payload[1] != received_count[ilink]) in_order[ilink] = 0;
+
+            if (received_count[ilink] > 0 && date_us - last_date_us[ilink] < min_gap_us[ilink]) {
+                min_gap_us[ilink] = date_us - last_date_us[ilink];
+            }
+            last_date_us[ilink] = date_us;
+            received_count[ilink]++;
+        }
+    }
+
+    for (ilink = 0; ilink < LINK_COUNT; ilink++) {
+        TEST_LOG(actor, "Port %u: %u datagrams received, %u us apart at least.", link_ports[ilink], received_count[ilink], (uint32_t)min_gap_us[ilink]);
+        TEST_ASSERT(actor, received_count[ilink] == BURST_COUNT, "Port %u: the whole burst is received.", link_ports[ilink]);
+        TEST_ASSERT(actor, in_order[ilink], "Port %u: the datagrams are received in order.", link_ports[ilink]);
+        TEST_ASSERT(actor, min_gap_us[ilink] + GAP_TOLERANCE_US >= link_bags_us[ilink], "Port %u: the datagrams are a BAG apart at least.", link_ports[ilink]);
+    }
+
+    TEST_SIGNAL(actor, 1); // We have received
+
+    for (ilink = 0; ilink < LINK_COUNT; ilink++) {
+        ims_test_mc_input_free(sockets[ilink]);
+    }
+
+    return ims_test_end(actor);
+}
@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Asynchronous send test - actor 1
+//
+#include "ims_test.h"
+
+#define IMS_CONFIG_FILE      "config/actor1/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor1/vistas.xml"
+
+#define ACTOR_ID 1
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define COUNTER_SIZE      4
+#define FIRST_TIME_US     10000
+#define STEP_US           1000
+#define LAST_COUNTER      100
+
+#define INVALID_POINTER ((void*)42)
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  ims_counter;
+    uint32_t       counter;
+    int            error = 0;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    TEST_WAIT(actor, 2); // Wait actor2 ready to read before starting our tests
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    ims_counter = (ims_message_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, "counter", COUNTER_SIZE, 1, ims_output, &ims_counter) == ims_no_error &&
+                       ims_counter != (ims_message_t)INVALID_POINTER && ims_counter != NULL,
+                       "We can get the counter message.");
+
+    // The time progresses at once after send_all: the datagram has the date of the call
+    TEST_ASSERT(actor, ims_progress(ims_context, FIRST_TIME_US) == ims_no_error, "ims_progress return ims_no_error.");
+    counter = 0;
+    TEST_ASSERT(actor, ims_write_sampling_message(ims_counter, (const char*)&counter, COUNTER_SIZE) == ims_no_error, "Counter write.");
+    TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "ims_send_all return ims_no_error.");
+    TEST_ASSERT(actor, ims_progress(ims_context, 5 * STEP_US) == ims_no_error, "ims_progress return ims_no_error.");
+
+    TEST_SIGNAL(actor, 2); // Tell actor2 we have sent
+    TEST_WAIT(actor, 2);
+
+    // A send_all per step, without waiting for the I/O thread.
+    // The counter is written at the time FIRST_TIME_US + counter * STEP_US.
+    TEST_ASSERT(actor, ims_reset_all(ims_context) == ims_no_error, "ims_reset_all return ims_no_error.");
+    TEST_ASSERT(actor, ims_progress(ims_context, FIRST_TIME_US + STEP_US) == ims_no_error, "ims_progress return ims_no_error.");
+    for (counter = 1; counter <= LAST_COUNTER; counter++) {
+        if (ims_write_sampling_message(ims_counter, (const char*)&counter, COUNTER_SIZE) != ims_no_error) error = 1;
+        if (ims_send_all(ims_context) != ims_no_error) error = 1;
+        if (counter < LAST_COUNTER && ims_progress(ims_context, STEP_US) != ims_no_error) error = 1;
+        if (counter % 2) ims_test_sleep(200); // Let the I/O thread send some steps alone
+    }
+    TEST_ASSERT(actor, error == 0, "The counter is written and sent at each step.");
+
+    // The last send_all is not lost when the context is freed
+    ims_free_context(ims_context);
+
+    TEST_SIGNAL(actor, 2); // Tell actor2 we have sent
+
+    return ims_test_end(actor);
+}
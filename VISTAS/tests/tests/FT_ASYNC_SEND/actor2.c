@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Asynchronous send test - actor 2
+//
+#include "ims_test.h"
+
+#ifdef __linux
+#include <byteswap.h>
+#else
+#define bswap_64(x) __builtin_bswap64(x)
+#endif
+
+#define ACTOR_ID 2
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define COUNTER_IP        "226.23.12.4"
+#define COUNTER_PORT      5078
+#define COUNTER_SIZE      4
+#define FIRST_TIME_US     10000
+#define STEP_US           1000
+#define LAST_COUNTER      100
+
+#define TIMESTAMP_TOLERANCE (100 * TEST_MILISECOND)
+
+#define QOS_TIMESTAMP(payload)  bswap_64(*(uint64_t*)((payload) + 4))
+#define DATA_TIMESTAMP(payload) bswap_64(*(uint64_t*)((payload) + 12))
+
+int main()
+{
+    char     received_payload[100];
+    uint32_t counter;
+    uint32_t last_counter = 0;
+    uint64_t last_data_timestamp = 0;
+    uint32_t received_count = 0;
+    int      in_order = 1;
+    int      dated = 1;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    ims_test_mc_input_t socket = ims_test_mc_input_create(actor, COUNTER_IP, COUNTER_PORT);
+
+    TEST_SIGNAL(actor, 1); // We are ready
+    TEST_WAIT(actor, 1);
+
+    // Dated at the send_all call, not when the I/O thread sent it
+    TEST_ASSERT(actor, ims_test_mc_input_receive(socket, received_payload, 100, 100 * TEST_MILISECOND) == VISTAS_HEADER_SIZE + COUNTER_SIZE,
+                "We have received the counter.");
+    uint64_t now_us = ims_test_time_us();
+    TEST_ASSERT(actor, DATA_TIMESTAMP(received_payload) == FIRST_TIME_US, "The data timestamp is the time of ims_send_all.");
+    TEST_ASSERT(actor, QOS_TIMESTAMP(received_payload) <= now_us && now_us - QOS_TIMESTAMP(received_payload) < TIMESTAMP_TOLERANCE,
+                "The QoS timestamp is the date of ims_send_all.");
+
+    TEST_SIGNAL(actor, 1);
+    TEST_WAIT(actor, 1);
+
+    // Requests may be merged, but a counter is never dated after its ims_send_all
+    while (ims_test_mc_input_receive(socket, received_payload, 100, 100 * TEST_MILISECOND) == VISTAS_HEADER_SIZE + COUNTER_SIZE) {
+        memcpy(&counter, received_payload + VISTAS_HEADER_SIZE, COUNTER_SIZE);
+        uint64_t data_timestamp = DATA_TIMESTAMP(received_payload);
+        received_count++;
+
+        if (counter <= last_counter || data_timestamp < last_data_timestamp) in_order = 0;
+        if (data_timestamp < FIRST_TIME_US + STEP_US || data_timestamp > FIRST_TIME_US + counter * STEP_US) dated = 0;
+
+        last_counter = counter;
+        last_data_timestamp = data_timestamp;
+    }
+
+    TEST_LOG(actor, "%u counters received.", received_count);
+    TEST_ASSERT(actor, in_order, "The counters are received in order.");
+    TEST_ASSERT(actor, dated, "The counters are dated by their ims_send_all.");
+    TEST_ASSERT(actor, last_counter == LAST_COUNTER, "The last counter is received.");
+    TEST_ASSERT(actor, last_data_timestamp == FIRST_TIME_US + LAST_COUNTER * STEP_US, "The last counter has the date of the last ims_send_all.");
+
+    ims_test_mc_input_free(socket);
+
+    return ims_test_end(actor);
+}
@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Import workers test - actor 1
+//
+#include "ims_test.h"
+#include <stdio.h>
+
+#define IMS_CONFIG_FILE      "config/actor1/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor1/vistas.xml"
+
+#define ACTOR_ID 1
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_SIZE      8
+#define SAMPLING_COUNT    16
+#define QUEUING_COUNT     4
+#define QUEUING_DEPTH     8
+#define ROUND_COUNT       2
+
+#define INVALID_POINTER ((void*)42)
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  sampling_messages[SAMPLING_COUNT];
+    ims_message_t  queuing_messages[QUEUING_COUNT];
+    char           local_name[32];
+    uint32_t       payload[MESSAGE_SIZE / sizeof(uint32_t)];
+    uint32_t       imessage;
+    uint32_t       iround;
+    uint32_t       idepth;
+    int            error;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    for (imessage = 0; imessage < SAMPLING_COUNT; imessage++) {
+        sprintf(local_name, "sampling%02u", imessage);
+        sampling_messages[imessage] = (ims_message_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, local_name, MESSAGE_SIZE, 1, ims_output, &sampling_messages[imessage]) == ims_no_error &&
+                           sampling_messages[imessage] != (ims_message_t)INVALID_POINTER && sampling_messages[imessage] != NULL,
+                           "We can get the message %s.", local_name);
+    }
+
+    for (imessage = 0; imessage < QUEUING_COUNT; imessage++) {
+        sprintf(local_name, "queuing%u", imessage);
+        queuing_messages[imessage] = (ims_message_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, local_name, MESSAGE_SIZE, QUEUING_DEPTH, ims_output, &queuing_messages[imessage]) == ims_no_error &&
+                           queuing_messages[imessage] != (ims_message_t)INVALID_POINTER && queuing_messages[imessage] != NULL,
+                           "We can get the message %s.", local_name);
+    }
+
+    TEST_WAIT(actor, 2); // Wait actor2 ready to read before starting our tests
+
+    // Each round: a new value on every sampling port, a full queue on every queuing port.
+    // The payload is the port index then the round (sampling) or the sequence (queuing).
+    for (iround = 0; iround < ROUND_COUNT; iround++) {
+        error = 0;
+        for (imessage = 0; imessage < SAMPLING_COUNT; imessage++) {
+            payload[0] = imessage;
+            payload[1] = iround;
+            if (ims_write_sampling_message(sampling_messages[imessage], (const char*)payload, MESSAGE_SIZE) != ims_no_error) error = 1;
+        }
+        for (imessage = 0; imessage < QUEUING_COUNT; imessage++) {
+            for (idepth = 0; idepth < QUEUING_DEPTH; idepth++) {
+                payload[0] = imessage;
+                payload[1] = iround * QUEUING_DEPTH + idepth;
+                if (ims_push_queuing_message(queuing_messages[imessage], (const char*)payload, MESSAGE_SIZE) != ims_no_error) error = 1;
+            }
+        }
+        TEST_ASSERT(actor, error == 0, "Round %u: every message is written.", iround);
+        TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "Round %u: ims_send_all return ims_no_error.", iround);
+
+        TEST_SIGNAL(actor, 2); // Tell actor2 we have sent
+        TEST_WAIT(actor, 2);
+    }
+
+    ims_free_context(ims_context);
+
+    return ims_test_end(actor);
+}
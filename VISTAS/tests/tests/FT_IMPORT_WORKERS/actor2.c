@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Import workers test - actor 2
+//
+#include "ims_test.h"
+#include <stdio.h>
+
+#define IMS_CONFIG_FILE      "config/actor2/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor2/vistas.xml"
+
+#define ACTOR_ID 2
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_SIZE      8
+#define SAMPLING_COUNT    16
+#define QUEUING_COUNT     4
+#define QUEUING_DEPTH     8
+#define ROUND_COUNT       2
+
+#define INVALID_POINTER ((void*)42)
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  sampling_messages[SAMPLING_COUNT];
+    ims_message_t  queuing_messages[QUEUING_COUNT];
+    char           local_name[32];
+    uint32_t       payload[MESSAGE_SIZE / sizeof(uint32_t)];
+    uint32_t       received_size;
+    ims_validity_t validity;
+    uint32_t       count;
+    uint32_t       imessage;
+    uint32_t       iround;
+    uint32_t       idepth;
+    uint32_t       sampling_ok;
+    uint32_t       queuing_ok;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    for (imessage = 0; imessage < SAMPLING_COUNT; imessage++) {
+        sprintf(local_name, "sampling%02u", imessage);
+        sampling_messages[imessage] = (ims_message_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, local_name, MESSAGE_SIZE, 1, ims_input, &sampling_messages[imessage]) == ims_no_error &&
+                           sampling_messages[imessage] != (ims_message_t)INVALID_POINTER && sampling_messages[imessage] != NULL,
+                           "We can get the message %s.", local_name);
+    }
+
+    for (imessage = 0; imessage < QUEUING_COUNT; imessage++) {
+        sprintf(local_name, "queuing%u", imessage);
+        queuing_messages[imessage] = (ims_message_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, local_name, MESSAGE_SIZE, QUEUING_DEPTH, ims_input, &queuing_messages[imessage]) == ims_no_error &&
+                           queuing_messages[imessage] != (ims_message_t)INVALID_POINTER && queuing_messages[imessage] != NULL,
+                           "We can get the message %s.", local_name);
+    }
+
+    TEST_SIGNAL(actor, 1); // We are ready
+
+    // The ports are shared between the import workers:
+    // every port must be imported once, each queue in order.
+    for (iround = 0; iround < ROUND_COUNT; iround++) {
+        TEST_WAIT(actor, 1); // Wait actor1 has sent
+
+        TEST_ASSERT(actor, ims_import(ims_context, 1000*1000) == ims_no_error, "Round %u: import success.", iround);
+
+        sampling_ok = 0;
+        for (imessage = 0; imessage < SAMPLING_COUNT; imessage++) {
+            memset(payload, 0xFF, MESSAGE_SIZE);
+            if (ims_read_sampling_message(sampling_messages[imessage], (char*)payload, &received_size, &validity) == ims_no_error &&
+                received_size == MESSAGE_SIZE && validity == ims_valid &&
+                payload[0] == imessage && payload[1] == iround) {
+                sampling_ok++;
+            }
+        }
+        TEST_ASSERT(actor, sampling_ok == SAMPLING_COUNT, "Round %u: %u/%u sampling messages have their new value.",
+                    iround, sampling_ok, SAMPLING_COUNT);
+
+        queuing_ok = 0;
+        for (imessage = 0; imessage < QUEUING_COUNT; imessage++) {
+            if (ims_queuing_message_pending(queuing_messages[imessage], &count) != ims_no_error || count != QUEUING_DEPTH) {
+                TEST_LOG(actor, "Round %u: queuing%u has %u messages pending.", iround, imessage, count);
+                continue;
+            }
+            for (idepth = 0; idepth < QUEUING_DEPTH; idepth++) {
+                memset(payload, 0xFF, MESSAGE_SIZE);
+                if (ims_pop_queuing_message(queuing_messages[imessage], (char*)payload, &received_size) != ims_no_error ||
+                    received_size != MESSAGE_SIZE || payload[0] != imessage || payload[1] != iround * QUEUING_DEPTH + idepth) {
+                    break;
+                }
+            }
+            if (idepth == QUEUING_DEPTH) queuing_ok++;
+        }
+        TEST_ASSERT(actor, queuing_ok == QUEUING_COUNT, "Round %u: %u/%u queues are complete and in order.",
+                    iround, queuing_ok, QUEUING_COUNT);
+
+        TEST_SIGNAL(actor, 1);
+    }
+
+    ims_free_context(ims_context);
+
+    return ims_test_end(actor);
+}
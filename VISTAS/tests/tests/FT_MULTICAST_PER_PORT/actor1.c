@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Multicast sockets shared by UDP port test - actor 1
+//
+#include "ims_test.h"
+#include <stdio.h>
+
+#define IMS_CONFIG_FILE      "config/actor1/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor1/vistas.xml"
+
+#define ACTOR_ID 1
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_SIZE      8
+#define GROUP_COUNT       4
+#define QUEUING_PUSHES    4
+#define ROUND_COUNT       2
+
+#define INVALID_POINTER ((void*)42)
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  group_messages[GROUP_COUNT];
+    ims_message_t  queuing_message;
+    char           local_name[32];
+    uint32_t       payload[MESSAGE_SIZE / sizeof(uint32_t)];
+    uint32_t       igroup;
+    uint32_t       iround;
+    uint32_t       ipush;
+    int            error;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    for (igroup = 0; igroup < GROUP_COUNT; igroup++) {
+        sprintf(local_name, "group%u", igroup);
+        group_messages[igroup] = (ims_message_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, local_name, MESSAGE_SIZE, 1, ims_output, &group_messages[igroup]) == ims_no_error &&
+                           group_messages[igroup] != (ims_message_t)INVALID_POINTER && group_messages[igroup] != NULL,
+                           "We can get the message %s.", local_name);
+    }
+
+    queuing_message = (ims_message_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, "queuing", MESSAGE_SIZE, 2 * QUEUING_PUSHES, ims_output, &queuing_message) == ims_no_error &&
+                       queuing_message != (ims_message_t)INVALID_POINTER && queuing_message != NULL,
+                       "We can get the queuing message.");
+
+    TEST_WAIT(actor, 2); // Wait actor2 ready to read before starting our tests
+
+    // All the groups share the UDP port 5400. The payload is the group index then the round.
+    // The first round writes every group, the next ones only the odd groups.
+    for (iround = 0; iround < ROUND_COUNT; iround++) {
+        error = 0;
+        for (igroup = 0; igroup < GROUP_COUNT; igroup++) {
+            if (iround > 0 && igroup % 2 == 0) continue;
+            payload[0] = igroup;
+            payload[1] = iround;
+            if (ims_write_sampling_message(group_messages[igroup], (const char*)payload, MESSAGE_SIZE) != ims_no_error) error = 1;
+        }
+        for (ipush = 0; ipush < QUEUING_PUSHES; ipush++) {
+            payload[0] = GROUP_COUNT;
+            payload[1] = iround * QUEUING_PUSHES + ipush;
+            if (ims_push_queuing_message(queuing_message, (const char*)payload, MESSAGE_SIZE) != ims_no_error) error = 1;
+        }
+        TEST_ASSERT(actor, error == 0, "Round %u: the messages are written.", iround);
+        TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "Round %u: ims_send_all return ims_no_error.", iround);
+
+        TEST_SIGNAL(actor, 2); // Tell actor2 we have sent
+        TEST_WAIT(actor, 2);
+    }
+
+    ims_free_context(ims_context);
+
+    return ims_test_end(actor);
+}
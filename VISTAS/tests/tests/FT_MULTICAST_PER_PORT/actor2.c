@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Multicast sockets shared by UDP port test - actor 2
+//
+#include "ims_test.h"
+#include <stdio.h>
+
+#define IMS_CONFIG_FILE      "config/actor2/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor2/vistas.xml"
+
+#define ACTOR_ID 2
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_SIZE      8
+#define GROUP_COUNT       4
+#define QUEUING_PUSHES    4
+#define ROUND_COUNT       2
+
+#define INVALID_POINTER ((void*)42)
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  group_messages[GROUP_COUNT];
+    ims_message_t  queuing_message;
+    char           local_name[32];
+    uint32_t       payload[MESSAGE_SIZE / sizeof(uint32_t)];
+    uint32_t       received_size;
+    ims_validity_t validity;
+    uint32_t       count;
+    uint32_t       igroup;
+    uint32_t       iround;
+    uint32_t       ipush;
+    uint32_t       expected_round;
+    uint32_t       group_ok;
+    int            in_order;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    for (igroup = 0; igroup < GROUP_COUNT; igroup++) {
+        sprintf(local_name, "group%u", igroup);
+        group_messages[igroup] = (ims_message_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, local_name, MESSAGE_SIZE, 1, ims_input, &group_messages[igroup]) == ims_no_error &&
+                           group_messages[igroup] != (ims_message_t)INVALID_POINTER && group_messages[igroup] != NULL,
+                           "We can get the message %s.", local_name);
+    }
+
+    queuing_message = (ims_message_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, "queuing", MESSAGE_SIZE, 2 * QUEUING_PUSHES, ims_input, &queuing_message) == ims_no_error &&
+                       queuing_message != (ims_message_t)INVALID_POINTER && queuing_message != NULL,
+                       "We can get the queuing message.");
+
+    TEST_SIGNAL(actor, 1); // We are ready
+
+    // One socket receives all the groups: each datagram must reach the message of its group only
+    for (iround = 0; iround < ROUND_COUNT; iround++) {
+        TEST_WAIT(actor, 1); // Wait actor1 has sent
+
+        TEST_ASSERT(actor, ims_import(ims_context, 1000*1000) == ims_no_error, "Round %u: import success.", iround);
+
+        group_ok = 0;
+        for (igroup = 0; igroup < GROUP_COUNT; igroup++) {
+            expected_round = (igroup % 2 == 0)? 0 : iround;
+            memset(payload, 0xFF, MESSAGE_SIZE);
+            if (ims_read_sampling_message(group_messages[igroup], (char*)payload, &received_size, &validity) == ims_no_error &&
+                received_size == MESSAGE_SIZE && payload[0] == igroup && payload[1] == expected_round) {
+                group_ok++;
+            } else {
+                TEST_LOG(actor, "Round %u: group%u has %u/%u, expected %u/%u.", iround, igroup, payload[0], payload[1], igroup, expected_round);
+            }
+        }
+        TEST_ASSERT(actor, group_ok == GROUP_COUNT, "Round %u: %u/%u groups have their own value.", iround, group_ok, GROUP_COUNT);
+
+        TEST_ASSERT(actor, ims_queuing_message_pending(queuing_message, &count) == ims_no_error && count == QUEUING_PUSHES,
+                    "Round %u: %u queued messages received.", iround, count);
+        in_order = 1;
+        for (ipush = 0; ipush < QUEUING_PUSHES; ipush++) {
+            memset(payload, 0xFF, MESSAGE_SIZE);
+            if (ims_pop_queuing_message(queuing_message, (char*)payload, &received_size) != ims_no_error ||
+                received_size != MESSAGE_SIZE || payload[0] != GROUP_COUNT || payload[1] != iround * QUEUING_PUSHES + ipush) {
+                in_order = 0;
+            }
+        }
+        TEST_ASSERT(actor, in_order, "Round %u: the queued messages are received in order.", iround);
+
+        TEST_SIGNAL(actor, 1);
+    }
+
+    ims_free_context(ims_context);
+
+    return ims_test_end(actor);
+}
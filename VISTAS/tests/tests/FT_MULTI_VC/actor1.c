@@ -25,6 +25,10 @@
 #define VISTAS_CONFIG_FILE_2    "config/actor1/vistas2.xml"
 #define VISTAS_CONFIG_FILE_3    "config/actor1/vistas3.xml"
 #define VISTAS_CONFIG_FILE_4    "config/actor1/vistas4.xml"
+#define VISTAS_CONFIG_FILE_5    "config/actor1/vistas5.xml"
+#define VISTAS_CONFIG_FILE_6    "config/actor1/vistas6.xml"
+
+#define LOOPBACK_MESSAGE_SIZE   42
 
 #define ACTOR_ID 1
 ims_test_actor_t actor;
@@ -37,9 +41,20 @@ ims_test_actor_t actor;
 int main()
 {
     ims_node_t              ims_context;
+    ims_node_t              ims_consumer_context;
+    ims_node_t              ims_equipment;
+    ims_node_t              ims_application;
+    ims_message_t           ims_produced;
+    ims_message_t           ims_consumed;
+    ims_reactor_t           ims_reactor;
 
     ims_return_code_t       ims_return_code;
 
+    char                    sent_payload[LOOPBACK_MESSAGE_SIZE];
+    char                    received_payload[LOOPBACK_MESSAGE_SIZE];
+    uint32_t                received_size;
+    ims_validity_t          validity;
+
     actor = ims_test_init(ACTOR_ID);
 
     ims_create_context_parameter_t create_parameter = IMS_CREATE_CONTEXT_INITIALIZER;
@@ -73,5 +88,74 @@ int main()
     ims_return_code = ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE_4, &create_parameter, &ims_context);
     TEST_ASSERT(actor, ims_return_code == ims_init_failure, "We cannot create context from vistas4.xml");
 
+    // Case 5: Two contexts of the process exchange a message through the in-process transport
+    ims_consumer_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE_5, NULL, &ims_consumer_context) == ims_no_error &&
+                       ims_consumer_context != (ims_node_t)INVALID_POINTER && ims_consumer_context != NULL,
+                       "We can create the consumer context from vistas5.xml");
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE_5, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create the producer context from vistas5.xml");
+
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_get_message(ims_application, ims_afdx, "LOCAL_AFDX1_S_O", LOOPBACK_MESSAGE_SIZE, 1, ims_output, &ims_produced) == ims_no_error,
+                       "We can get the produced message.");
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_consumer_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_get_message(ims_application, ims_afdx, "LOCAL_AFDX2_Q_I", LOOPBACK_MESSAGE_SIZE, 1, ims_input, &ims_consumed) == ims_no_error,
+                       "We can get the consumed message.");
+
+    memset(sent_payload, 0x5A, LOOPBACK_MESSAGE_SIZE);
+    TEST_ASSERT(actor, ims_write_sampling_message(ims_produced, sent_payload, LOOPBACK_MESSAGE_SIZE) == ims_no_error, "Message written.");
+    TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "Message sent.");
+
+    // Delivered in memory: the next import of the consumer gets it, without waiting
+    TEST_ASSERT(actor, ims_import(ims_consumer_context, 0) == ims_no_error, "Import success.");
+    TEST_ASSERT(actor, ims_read_sampling_message(ims_consumed, received_payload, &received_size, &validity) == ims_no_error, "Message read.");
+    TEST_ASSERT(actor, received_size == LOOPBACK_MESSAGE_SIZE, "Message has the expected length.");
+    TEST_ASSERT(actor, validity == ims_valid, "Message is valid.");
+    TEST_ASSERT(actor, memcmp(received_payload, sent_payload, LOOPBACK_MESSAGE_SIZE) == 0, "Message has the expected content.");
+
+    ims_free_context(ims_context);
+    ims_free_context(ims_consumer_context);
+
+    // Case 6: A reactor imports both contexts with one call
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE_6, NULL, &ims_consumer_context) == ims_no_error &&
+                       ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE_6, NULL, &ims_context) == ims_no_error,
+                       "We can create two contexts from vistas6.xml");
+    TEST_ASSERT(actor, ims_create_reactor(&ims_reactor) == ims_no_error, "We can create a reactor.");
+    TEST_ASSERT(actor, ims_reactor_attach(ims_reactor, ims_context) == ims_no_error &&
+                       ims_reactor_attach(ims_reactor, ims_consumer_context) == ims_no_error,
+                       "We can attach both contexts.");
+
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_get_message(ims_application, ims_afdx, "LOCAL_AFDX1_S_O", LOOPBACK_MESSAGE_SIZE, 1, ims_output, &ims_produced) == ims_no_error,
+                       "We can get the produced message.");
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_consumer_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_get_message(ims_application, ims_afdx, "LOCAL_AFDX2_Q_I", LOOPBACK_MESSAGE_SIZE, 1, ims_input, &ims_consumed) == ims_no_error,
+                       "We can get the consumed message.");
+
+    memset(sent_payload, 0xA5, LOOPBACK_MESSAGE_SIZE);
+    TEST_ASSERT(actor, ims_write_sampling_message(ims_produced, sent_payload, LOOPBACK_MESSAGE_SIZE) == ims_no_error, "Message written.");
+    TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "Message sent.");
+
+    TEST_ASSERT(actor, ims_reactor_import(ims_reactor, 1000*1000) == ims_no_error, "Reactor import success.");
+    TEST_ASSERT(actor, ims_read_sampling_message(ims_consumed, received_payload, &received_size, &validity) == ims_no_error, "Message read.");
+    TEST_ASSERT(actor, received_size == LOOPBACK_MESSAGE_SIZE, "Message has the expected length.");
+    TEST_ASSERT(actor, validity == ims_valid, "Message is valid.");
+    TEST_ASSERT(actor, memcmp(received_payload, sent_payload, LOOPBACK_MESSAGE_SIZE) == 0, "Message has the expected content.");
+
+    // A freed context leaves the reactor
+    TEST_ASSERT(actor, ims_reactor_detach(ims_reactor, ims_context) == ims_no_error, "We can detach the producer context.");
+    TEST_ASSERT(actor, ims_reactor_detach(ims_reactor, ims_context) != ims_no_error, "We cannot detach it twice.");
+    ims_free_context(ims_consumer_context);
+    TEST_ASSERT(actor, ims_reactor_import(ims_reactor, 0) == ims_no_error, "Reactor import success without any context.");
+
+    ims_free_reactor(ims_reactor);
+    ims_free_context(ims_context);
+
     return ims_test_end(actor);
 }
@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Packet ring test - actor 2
+//
+#include "ims_test.h"
+#include <stdio.h>
+
+#ifdef __linux
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#define IMS_CONFIG_FILE      "config/actor2/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor2/vistas.xml"
+
+#define ACTOR_ID 2
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_SIZE      8
+#define SAMPLING_COUNT    4
+#define QUEUING_DEPTH     32
+#define ROUND_COUNT       3
+
+#define INVALID_POINTER ((void*)42)
+
+//
+// Return 1 if this process can open the packet socket of the ring
+//
+static int has_packet_socket()
+{
+#ifdef __linux
+    int fd = socket(AF_PACKET, SOCK_DGRAM, 0);
+    if (fd < 0) return 0;
+    close(fd);
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  sampling_messages[SAMPLING_COUNT];
+    ims_message_t  queuing_message;
+    char           local_name[32];
+    uint32_t       payload[MESSAGE_SIZE / sizeof(uint32_t)];
+    uint32_t       received_size;
+    ims_validity_t validity;
+    uint32_t       count;
+    uint32_t       imessage;
+    uint32_t       iround;
+    uint32_t       idepth;
+    uint32_t       sampling_ok;
+    int            in_order;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    // Without CAP_NET_RAW, the same datagrams must come from the UDP sockets
+    if (has_packet_socket()) {
+        TEST_LOG(actor, "The multicast inputs are read from the packet ring.");
+    } else {
+        TEST_LOG(actor, "No CAP_NET_RAW: the multicast inputs are read from the UDP sockets.");
+    }
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    for (imessage = 0; imessage < SAMPLING_COUNT; imessage++) {
+        sprintf(local_name, "sampling%u", imessage);
+        sampling_messages[imessage] = (ims_message_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, local_name, MESSAGE_SIZE, 1, ims_input, &sampling_messages[imessage]) == ims_no_error &&
+                           sampling_messages[imessage] != (ims_message_t)INVALID_POINTER && sampling_messages[imessage] != NULL,
+                           "We can get the message %s.", local_name);
+    }
+
+    queuing_message = (ims_message_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, "queuing", MESSAGE_SIZE, QUEUING_DEPTH, ims_input, &queuing_message) == ims_no_error &&
+                       queuing_message != (ims_message_t)INVALID_POINTER && queuing_message != NULL,
+                       "We can get the queuing message.");
+
+    TEST_SIGNAL(actor, 1); // We are ready
+
+    // Each datagram reaches its own message, once, and the queue keeps the send order
+    for (iround = 0; iround < ROUND_COUNT; iround++) {
+        TEST_WAIT(actor, 1); // Wait actor1 has sent
+
+        TEST_ASSERT(actor, ims_import(ims_context, 1000*1000) == ims_no_error, "Round %u: import success.", iround);
+
+        sampling_ok = 0;
+        for (imessage = 0; imessage < SAMPLING_COUNT; imessage++) {
+            memset(payload, 0xFF, MESSAGE_SIZE);
+            if (ims_read_sampling_message(sampling_messages[imessage], (char*)payload, &received_size, &validity) == ims_no_error &&
+                received_size == MESSAGE_SIZE && validity == ims_valid &&
+                payload[0] == imessage && payload[1] == iround) {
+                sampling_ok++;
+            }
+        }
+        TEST_ASSERT(actor, sampling_ok == SAMPLING_COUNT, "Round %u: %u/%u sampling messages have their new value.",
+                    iround, sampling_ok, SAMPLING_COUNT);
+
+        TEST_ASSERT(actor, ims_queuing_message_pending(queuing_message, &count) == ims_no_error && count == QUEUING_DEPTH,
+                    "Round %u: %u queued messages received.", iround, count);
+        in_order = 1;
+        for (idepth = 0; idepth < QUEUING_DEPTH; idepth++) {
+            memset(payload, 0xFF, MESSAGE_SIZE);
+            if (ims_pop_queuing_message(queuing_message, (char*)payload, &received_size) != ims_no_error ||
+                received_size != MESSAGE_SIZE || payload[0] != SAMPLING_COUNT || payload[1] != iround * QUEUING_DEPTH + idepth) {
+                in_order = 0;
+            }
+        }
+        TEST_ASSERT(actor, in_order, "Round %u: the queued messages are received in order.", iround);
+
+        TEST_SIGNAL(actor, 1);
+    }
+
+    ims_free_context(ims_context);
+
+    return ims_test_end(actor);
+}
@@ -76,9 +76,10 @@ int main()
 
     TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "Messages sent.");
 
-    TEST_SIGNAL(actor, 2);
-
+    // Datagrams a full socket buffer refused are sent when the context is freed
     ims_free_context(ims_context);
 
+    TEST_SIGNAL(actor, 2);
+
     return ims_test_end(actor);
 }
@@ -0,0 +1,104 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+
+//
+// Priority test - actor 1
+//
+#include "ims_test.h"
+#include <stdio.h>
+
+#define IMS_CONFIG_FILE      "config/actor1/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor1/vistas.xml"
+
+#define ACTOR_ID 1
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_SIZE      8
+#define MESSAGE_DEPTH     16
+#define BURST_COUNT       8
+#define PRIORITY_COUNT    4
+
+#define ROUND_COUNT 2
+
+#define INVALID_POINTER ((void*)42)
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  ims_messages[PRIORITY_COUNT];
+    char           local_name[16];
+    uint32_t       payload[2];
+    uint32_t       priority;
+    uint32_t       counter;
+    uint32_t       round;
+    int            error;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    for (priority = 0; priority < PRIORITY_COUNT; priority++) {
+        sprintf(local_name, "prio%u", priority);
+        ims_messages[priority] = (ims_message_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, local_name, MESSAGE_SIZE, MESSAGE_DEPTH, ims_output, &ims_messages[priority]) == ims_no_error &&
+                           ims_messages[priority] != (ims_message_t)INVALID_POINTER && ims_messages[priority] != NULL,
+                           "We can get the message %s.", local_name);
+    }
+
+    // Round 0: actor2 checks the send order. Round 1: it checks the import order.
+    for (round = 0; round < ROUND_COUNT; round++) {
+
+        TEST_WAIT(actor, 2); // Wait actor2 ready to read
+
+        // Pushed from the lowest priority to the highest one
+        error = 0;
+        for (counter = 0; counter < BURST_COUNT; counter++) {
+            for (priority = 0; priority < PRIORITY_COUNT; priority++) {
+                payload[0] = priority;
+                payload[1] = counter;
+                if (ims_push_queuing_message(ims_messages[priority], (const char*)payload, MESSAGE_SIZE) != ims_no_error) error = 1;
+            }
+        }
+        TEST_ASSERT(actor, error == 0, "Round %u: the messages are pushed.", round);
+        TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "Round %u: ims_send_all return ims_no_error.", round);
+
+        TEST_SIGNAL(actor, 2); // Tell actor2 we have sent
+    }
+
+    TEST_WAIT(actor, 2); // actor2 has read
+
+    ims_free_context(ims_context);
+
+    return ims_test_end(actor);
+}
@@ -0,0 +1,158 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+
+//
+// Priority test - actor 2
+//
+#include "ims_test.h"
+#include <stdio.h>
+
+#define IMS_CONFIG_FILE      "config/actor2/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor2/vistas.xml"
+
+#define ACTOR_ID 2
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_IP        "226.23.12.4"
+#define FIRST_PORT        5900
+#define MESSAGE_SIZE      8
+#define MESSAGE_DEPTH     16
+#define BURST_COUNT       8
+#define PRIORITY_COUNT    4
+
+#define RECEIVE_TIMEOUT_US  (5 * TEST_SECOND)
+
+#define INVALID_POINTER ((void*)42)
+
+int main()
+{
+    ims_test_mc_input_t sockets[PRIORITY_COUNT];
+    char                received_payload[100];
+    uint32_t            payload[2];
+    uint64_t            date_us;
+    uint64_t            first_date_us[PRIORITY_COUNT];
+    uint64_t            last_date_us[PRIORITY_COUNT] = { 0 };
+    uint32_t            received_count[PRIORITY_COUNT] = { 0 };
+    uint32_t            total_count = 0;
+    int                 in_order = 1;
+    ims_node_t          ims_context;
+    ims_node_t          ims_equipment;
+    ims_node_t          ims_application;
+    ims_message_t       ims_messages[PRIORITY_COUNT];
+    char                local_name[16];
+    uint32_t            pending_count[PRIORITY_COUNT];
+    uint32_t            priority;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    //
+    // Send order: the ports of the highest priority go first
+    //
+    for (priority = 0; priority < PRIORITY_COUNT; priority++) {
+        sockets[priority] = ims_test_mc_input_create(actor, MESSAGE_IP, FIRST_PORT + priority);
+        first_date_us[priority] = (uint64_t)-1;
+    }
+
+    TEST_SIGNAL(actor, 1); // We are ready
+
+    // The datagrams are dated by the system when they arrive
+    uint64_t start_us = ims_test_time_us();
+    while (total_count < PRIORITY_COUNT * BURST_COUNT && ims_test_time_us() - start_us < RECEIVE_TIMEOUT_US) {
+        for (priority = 0; priority < PRIORITY_COUNT; priority++) {
+            if (ims_test_mc_input_receive_dated(sockets[priority], received_payload, 100, TEST_MILISECOND, &date_us) != VISTAS_HEADER_SIZE + MESSAGE_SIZE) {
+                continue;
+            }
+            memcpy(payload, received_payload + VISTAS_HEADER_SIZE, MESSAGE_SIZE);
+            if (payload[0] != priority || payload[1] != received_count[priority]) in_order = 0;
+
+            if (date_us < first_date_us[priority]) first_date_us[priority] = date_us;
+            if (date_us > last_date_us[priority]) last_date_us[priority] = date_us;
+            received_count[priority]++;
+            total_count++;
+        }
+    }
+
+    TEST_ASSERT(actor, total_count == PRIORITY_COUNT * BURST_COUNT, "All the messages are received.");
+    TEST_ASSERT(actor, in_order, "Each port keeps its messages order.");
+    for (priority = 1; priority < PRIORITY_COUNT; priority++) {
+        TEST_ASSERT(actor, last_date_us[priority] <= first_date_us[priority - 1],
+                    "Priority %u is sent before priority %u.", priority, priority - 1);
+    }
+
+    TEST_WAIT(actor, 1); // actor1 has sent
+
+    for (priority = 0; priority < PRIORITY_COUNT; priority++) {
+        ims_test_mc_input_free(sockets[priority]);
+    }
+
+    //
+    // Import order: once out of time, the lower priority inputs wait for the next import
+    //
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    for (priority = 0; priority < PRIORITY_COUNT; priority++) {
+        sprintf(local_name, "prio%u", priority);
+        ims_messages[priority] = (ims_message_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, local_name, MESSAGE_SIZE, MESSAGE_DEPTH, ims_input, &ims_messages[priority]) == ims_no_error &&
+                           ims_messages[priority] != (ims_message_t)INVALID_POINTER && ims_messages[priority] != NULL,
+                           "We can get the message %s.", local_name);
+    }
+
+    TEST_SIGNAL(actor, 1); // We are ready
+    TEST_WAIT(actor, 1);   // actor1 has sent
+
+    // Let all the datagrams arrive
+    ims_test_sleep(20 * TEST_MILISECOND);
+
+    // No time: the highest priority input is read, the others are deferred
+    TEST_ASSERT(actor, ims_import(ims_context, 0) == ims_no_error, "ims_import return ims_no_error.");
+    for (priority = 0; priority < PRIORITY_COUNT; priority++) {
+        TEST_ASSERT_SILENT(actor, ims_queuing_message_pending(ims_messages[priority], &pending_count[priority]) == ims_no_error,
+                           "ims_queuing_message_pending return ims_no_error.");
+    }
+    TEST_LOG(actor, "Pending after an import without time: %u %u %u %u.", pending_count[0], pending_count[1], pending_count[2], pending_count[3]);
+    TEST_ASSERT(actor, pending_count[PRIORITY_COUNT - 1] == BURST_COUNT, "The highest priority input is read first.");
+    for (priority = 0; priority < PRIORITY_COUNT - 1; priority++) {
+        TEST_ASSERT(actor, pending_count[priority] == 0, "Priority %u is left for the next import.", priority);
+    }
+
+    // The next import reads them
+    TEST_ASSERT(actor, ims_import(ims_context, 1000 * 1000) == ims_no_error, "ims_import return ims_no_error.");
+    for (priority = 0; priority < PRIORITY_COUNT; priority++) {
+        TEST_ASSERT(actor, ims_queuing_message_pending(ims_messages[priority], &pending_count[priority]) == ims_no_error &&
+                    pending_count[priority] == BURST_COUNT,
+                    "Priority %u is read by the next import.", priority);
+    }
+
+    ims_free_context(ims_context);
+
+    TEST_SIGNAL(actor, 1); // We have read
+
+    return ims_test_end(actor);
+}
@@ -47,6 +47,8 @@ int main()
     ims_message_t     input_queuing;
     ims_message_t     sampling_message;
     uint32_t          count;
+    uint32_t          retried_count;
+    uint32_t          dropped_count;
     const char*       payload = "never sent";
 
     actor = ims_test_init(ACTOR_ID);
@@ -147,6 +149,13 @@ int main()
     TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "ims_send_all return ims_no_error.");
     TEST_SIGNAL(actor, 2); // Signal we have sent
 
+    // Nothing waited for room in the socket buffer
+    TEST_ASSERT(actor, ims_message_send_counters(ims_message1, &retried_count, &dropped_count) == ims_no_error,
+                "message_send_counters return no_error");
+    TEST_ASSERT(actor, retried_count == 0 && dropped_count == 0, "No message retried nor dropped.");
+    TEST_ASSERT(actor, ims_message_send_counters(input_queuing, &retried_count, &dropped_count) == ims_invalid_configuration,
+                "An input message has no send counters.");
+
     ims_free_context(ims_context);
 
     return ims_test_end(actor);
@@ -49,6 +49,9 @@ int main()
     ims_validity_t    validity;
     uint32_t          received_size;
     char              received_payload[RECEIVE_MAX_SIZE];
+    ims_message_view_t view;
+    ims_message_t     batch_messages[2];
+    ims_io_desc_t     batch_descs[2];
 
     // Internal data
     uint32_t data_internal_max_size = 100;
@@ -172,6 +175,29 @@ int main()
     TEST_ASSERT(actor, validity == ims_valid, "Message1 is valid.");
     TEST_ASSERT(actor, memcmp(received_payload, expected_last_payload1, MESSAGE1_SIZE) == 0, "Message1 has the expected content.");
 
+    // The view gives the same data, without copy
+    TEST_ASSERT(actor, ims_read_sampling_message_view(ims_message1, &view) == ims_no_error, "Message1 view read.");
+    TEST_ASSERT(actor, view.size == MESSAGE1_SIZE, "Message1 view has the expected length.");
+    TEST_ASSERT(actor, view.validity == ims_valid, "Message1 view is valid.");
+    TEST_ASSERT(actor, view.generation == 2, "Message1 view counts the receptions.");
+    TEST_ASSERT(actor, memcmp(view.data, expected_last_payload1, MESSAGE1_SIZE) == 0, "Message1 view has the expected content.");
+    TEST_ASSERT(actor, ims_release_view(ims_message1, &view) == ims_no_error, "Message1 view released.");
+    TEST_ASSERT(actor, view.data == NULL, "Released view is cleared.");
+    TEST_ASSERT(actor, ims_read_sampling_message_view(output_message, &view) == ims_invalid_configuration,
+                "Viewing output message return ims_invalid_configuration.");
+
+    // Batched read: each message gets its own result
+    batch_messages[0] = ims_message1;
+    batch_messages[1] = output_message;
+    batch_descs[0].data = received_payload;
+    batch_descs[1].data = received_payload + MESSAGE1_SIZE;
+    TEST_ASSERT(actor, ims_read_sampling_messages(batch_messages, 2, batch_descs) == ims_invalid_configuration,
+                "Batched read return the worst result.");
+    TEST_ASSERT(actor, batch_descs[0].result == ims_no_error && batch_descs[0].size == MESSAGE1_SIZE &&
+                batch_descs[0].validity == ims_valid, "Batched read of message1 succeeds.");
+    TEST_ASSERT(actor, memcmp(received_payload, expected_last_payload1, MESSAGE1_SIZE) == 0, "Batched read of message1 has the expected content.");
+    TEST_ASSERT(actor, batch_descs[1].result == ims_invalid_configuration, "Batched read of output message fails.");
+
     // Validity tests
 
     // The message validity is 50ms, so if the time progress of 25 ms, the message still valid
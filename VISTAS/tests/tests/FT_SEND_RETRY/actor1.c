@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+
+//
+// Send retry test - actor 1
+//
+#include "ims_test.h"
+
+#define IMS_CONFIG_FILE      "config/actor1/ims.xml"
+
+#define ACTOR_ID 1
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_SIZE      1000
+#define BURST_COUNT       200
+#define DRAIN_SENDS       100
+#define MAX_BURSTS        10
+#define END_COUNTER       0xFFFFFFFF
+
+#define INVALID_POINTER ((void*)42)
+
+// Same burst with the sendmmsg engine, then with io_uring
+#define ENGINE_COUNT 2
+static const char* vistas_config_files[ENGINE_COUNT] = { "config/actor1/vistas.xml", "config/actor1/vistas_uring.xml" };
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  ims_burst;
+    char           payload[MESSAGE_SIZE];
+    uint32_t       engine;
+    uint32_t       counter;
+    uint32_t       burst;
+    uint32_t       burst_count;
+    uint32_t       retried_count;
+    uint32_t       dropped_count;
+    int            error;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    for (engine = 0; engine < ENGINE_COUNT; engine++) {
+
+        TEST_WAIT(actor, 2); // Wait actor2 ready to read
+
+        ims_context = (ims_node_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, vistas_config_files[engine], NULL, &ims_context) == ims_no_error &&
+                           ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                           "We can create a valid context.");
+
+        ims_equipment = (ims_node_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                           ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                           "We can get the first equipment.");
+
+        ims_application = (ims_node_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                           ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                           "We can get the first application.");
+
+        ims_burst = (ims_message_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, "burst", MESSAGE_SIZE, BURST_COUNT, ims_output, &ims_burst) == ims_no_error &&
+                           ims_burst != (ims_message_t)INVALID_POINTER && ims_burst != NULL,
+                           "We can get the burst message.");
+
+        // How fast the interface frees the socket buffer varies: burst again
+        // until the socket has refused and dropped datagrams
+        burst_count = 0;
+        do {
+            burst = burst_count++;
+
+            // The burst is far bigger than the socket buffer
+            error = 0;
+            memset(payload, 0, MESSAGE_SIZE);
+            for (counter = burst * BURST_COUNT; counter < burst_count * BURST_COUNT; counter++) {
+                memcpy(payload, &engine, sizeof(uint32_t));
+                memcpy(payload + sizeof(uint32_t), &counter, sizeof(uint32_t));
+                if (ims_push_queuing_message(ims_burst, payload, MESSAGE_SIZE) != ims_no_error) error = 1;
+            }
+            TEST_ASSERT(actor, error == 0, "Engine %u: the burst %u is pushed.", engine, burst);
+
+            // The datagrams refused by the socket wait for the next send, which never blocks
+            uint64_t send_start_us = ims_test_time_us();
+            TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "Engine %u: ims_send_all return ims_no_error.", engine);
+            uint64_t send_us = ims_test_time_us() - send_start_us;
+            TEST_LOG(actor, "Engine %u: the burst %u took %u us to send.", engine, burst, (uint32_t)send_us);
+            TEST_ASSERT(actor, send_us < 100 * TEST_MILISECOND, "Engine %u: ims_send_all does not wait for the socket.", engine);
+
+            // The next sends submit the waiting datagrams
+            error = 0;
+            for (counter = 0; counter < DRAIN_SENDS; counter++) {
+                ims_test_sleep(TEST_MILISECOND);
+                if (ims_send_all(ims_context) != ims_no_error) error = 1;
+            }
+            TEST_ASSERT(actor, error == 0, "Engine %u: the waiting datagrams are sent.", engine);
+
+            TEST_ASSERT(actor, ims_message_send_counters(ims_burst, &retried_count, &dropped_count) == ims_no_error,
+                        "Engine %u: ims_message_send_counters return ims_no_error.", engine);
+        } while (dropped_count == 0 && burst_count < MAX_BURSTS);
+
+        TEST_LOG(actor, "Engine %u: %u bursts, %u datagrams retried, %u dropped.", engine, burst_count, retried_count, dropped_count);
+        TEST_ASSERT(actor, retried_count > 0, "Engine %u: datagrams refused by the full socket are retried.", engine);
+        TEST_ASSERT(actor, dropped_count > 0, "Engine %u: the oldest waiting datagrams are dropped.", engine);
+        TEST_ASSERT(actor, dropped_count < retried_count, "Engine %u: the newest waiting datagrams are kept.", engine);
+
+        // Tell actor2 how many datagrams were pushed
+        memcpy(payload, &engine, sizeof(uint32_t));
+        counter = END_COUNTER;
+        memcpy(payload + sizeof(uint32_t), &counter, sizeof(uint32_t));
+        memcpy(payload + 2 * sizeof(uint32_t), &burst_count, sizeof(uint32_t));
+        TEST_ASSERT(actor, ims_push_queuing_message(ims_burst, payload, MESSAGE_SIZE) == ims_no_error &&
+                    ims_send_all(ims_context) == ims_no_error, "Engine %u: the end of the bursts is sent.", engine);
+
+        ims_free_context(ims_context);
+
+        TEST_SIGNAL(actor, 2); // Tell actor2 we have sent
+    }
+
+    return ims_test_end(actor);
+}
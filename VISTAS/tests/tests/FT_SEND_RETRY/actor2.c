@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+
+//
+// Send retry test - actor 2
+//
+#include "ims_test.h"
+
+#define ACTOR_ID 2
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_IP        "226.23.12.4"
+#define MESSAGE_PORT      5700
+#define MESSAGE_SIZE      1000
+#define BURST_COUNT       200
+#define END_COUNTER       0xFFFFFFFF
+
+#define ENGINE_COUNT 2
+
+#define RECEIVE_TIMEOUT_US  (5 * TEST_SECOND)
+
+int main()
+{
+    char     received_payload[VISTAS_HEADER_SIZE + MESSAGE_SIZE];
+    uint32_t engine;
+    uint32_t received_engine;
+    uint32_t counter;
+    int32_t  last_counter;
+    uint32_t received_count;
+    uint32_t burst_count;
+    int      in_order;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    ims_test_mc_input_t socket = ims_test_mc_input_create(actor, MESSAGE_IP, MESSAGE_PORT);
+
+    for (engine = 0; engine < ENGINE_COUNT; engine++) {
+
+        TEST_SIGNAL(actor, 1); // We are ready
+
+        // Read while actor1 sends, until the end of the bursts
+        last_counter = -1;
+        received_count = 0;
+        burst_count = 0;
+        in_order = 1;
+        uint64_t start_us = ims_test_time_us();
+        while (burst_count == 0 && ims_test_time_us() - start_us < RECEIVE_TIMEOUT_US) {
+            if (ims_test_mc_input_receive(socket, received_payload, sizeof(received_payload), TEST_MILISECOND) != VISTAS_HEADER_SIZE + MESSAGE_SIZE) {
+                continue;
+            }
+            memcpy(&received_engine, received_payload + VISTAS_HEADER_SIZE, sizeof(uint32_t));
+            memcpy(&counter, received_payload + VISTAS_HEADER_SIZE + sizeof(uint32_t), sizeof(uint32_t));
+            if (received_engine != engine) in_order = 0;
+            if (counter == END_COUNTER) {
+                memcpy(&burst_count, received_payload + VISTAS_HEADER_SIZE + 2 * sizeof(uint32_t), sizeof(uint32_t));
+                continue;
+            }
+            if ((int32_t)counter <= last_counter) in_order = 0;
+            last_counter = counter;
+            received_count++;
+        }
+
+        TEST_LOG(actor, "Engine %u: %u bursts, %u datagrams received.", engine, burst_count, received_count);
+        TEST_ASSERT(actor, burst_count > 0, "Engine %u: the end of the bursts is received.", engine);
+        TEST_ASSERT(actor, in_order, "Engine %u: the datagrams are received in order.", engine);
+        TEST_ASSERT(actor, last_counter == (int32_t)(burst_count * BURST_COUNT) - 1, "Engine %u: the last datagram of the bursts is received.", engine);
+        TEST_ASSERT(actor, received_count < burst_count * BURST_COUNT, "Engine %u: the oldest waiting datagrams are dropped.", engine);
+
+        TEST_WAIT(actor, 1); // actor1 has sent
+    }
+
+    ims_test_mc_input_free(socket);
+
+    return ims_test_end(actor);
+}
@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Send workers test - actor 1
+//
+#include "ims_test.h"
+#include <stdio.h>
+
+#define IMS_CONFIG_FILE      "config/actor1/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor1/vistas.xml"
+
+#define ACTOR_ID 1
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_SIZE      8
+#define PORT_COUNT        32
+#define QUEUING_DEPTH     4
+#define ROUND_COUNT       10
+
+#define INVALID_POINTER ((void*)42)
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  ims_messages[PORT_COUNT];
+    char           local_name[32];
+    uint32_t       payload[MESSAGE_SIZE / sizeof(uint32_t)];
+    uint32_t       imessage;
+    uint32_t       iround;
+    uint32_t       idepth;
+    int            error = 0;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    TEST_WAIT(actor, 2); // Wait actor2 ready to read before starting our tests
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    for (imessage = 0; imessage < PORT_COUNT; imessage++) {
+        sprintf(local_name, "queuing%02u", imessage);
+        ims_messages[imessage] = (ims_message_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, local_name, MESSAGE_SIZE, QUEUING_DEPTH, ims_output, &ims_messages[imessage]) == ims_no_error &&
+                           ims_messages[imessage] != (ims_message_t)INVALID_POINTER && ims_messages[imessage] != NULL,
+                           "We can get the message %s.", local_name);
+    }
+
+    // Each round fills every queue, then the workers share the ports.
+    // The payload is the port index then the sequence of the message on its port.
+    for (iround = 0; iround < ROUND_COUNT; iround++) {
+        for (imessage = 0; imessage < PORT_COUNT; imessage++) {
+            for (idepth = 0; idepth < QUEUING_DEPTH; idepth++) {
+                payload[0] = imessage;
+                payload[1] = iround * QUEUING_DEPTH + idepth;
+                if (ims_push_queuing_message(ims_messages[imessage], (const char*)payload, MESSAGE_SIZE) != ims_no_error) error = 1;
+            }
+        }
+        if (ims_send_all(ims_context) != ims_no_error) error = 1;
+        ims_test_sleep(TEST_MILISECOND); // Let actor2 keep up
+    }
+    TEST_ASSERT(actor, error == 0, "Every message is pushed and sent.");
+
+    ims_free_context(ims_context);
+
+    TEST_SIGNAL(actor, 2); // Tell actor2 we have sent
+
+    return ims_test_end(actor);
+}
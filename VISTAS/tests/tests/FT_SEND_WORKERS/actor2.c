@@ -0,0 +1,83 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Send workers test - actor 2
+//
+#include "ims_test.h"
+
+#define ACTOR_ID 2
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_IP        "226.23.12.4"
+#define FIRST_PORT        5200
+#define MESSAGE_SIZE      8
+#define PORT_COUNT        32
+#define QUEUING_DEPTH     4
+#define ROUND_COUNT       10
+
+#define MESSAGE_COUNT     (QUEUING_DEPTH * ROUND_COUNT)
+
+int main()
+{
+    ims_test_mc_input_t sockets[PORT_COUNT];
+    char                received_payload[100];
+    uint32_t            payload[MESSAGE_SIZE / sizeof(uint32_t)];
+    uint32_t            received_count[PORT_COUNT] = { 0 };
+    uint32_t            disorder_count[PORT_COUNT] = { 0 };
+    uint32_t            complete_count = 0;
+    uint32_t            in_order_count = 0;
+    uint32_t            imessage;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    for (imessage = 0; imessage < PORT_COUNT; imessage++) {
+        sockets[imessage] = ims_test_mc_input_create(actor, MESSAGE_IP, FIRST_PORT + imessage);
+    }
+
+    TEST_SIGNAL(actor, 1); // We are ready
+    TEST_WAIT(actor, 1);
+
+    // Each port must receive all its messages, in the order they were pushed
+    for (imessage = 0; imessage < PORT_COUNT; imessage++) {
+        while (ims_test_mc_input_receive(sockets[imessage], received_payload, 100, 10 * TEST_MILISECOND) == VISTAS_HEADER_SIZE + MESSAGE_SIZE) {
+            memcpy(payload, received_payload + VISTAS_HEADER_SIZE, MESSAGE_SIZE);
+            if (payload[0] != imessage || payload[1] != received_count[imessage]) {
+                disorder_count[imessage]++;
+            }
+            received_count[imessage]++;
+        }
+
+        if (received_count[imessage] == MESSAGE_COUNT) {
+            complete_count++;
+        } else {
+            TEST_LOG(actor, "Port %u: %u/%u messages received.", FIRST_PORT + imessage, received_count[imessage], MESSAGE_COUNT);
+        }
+        if (disorder_count[imessage] == 0) {
+            in_order_count++;
+        } else {
+            TEST_LOG(actor, "Port %u: %u messages out of order.", FIRST_PORT + imessage, disorder_count[imessage]);
+        }
+    }
+
+    TEST_ASSERT(actor, complete_count == PORT_COUNT, "%u/%u ports have received all their messages.", complete_count, PORT_COUNT);
+    TEST_ASSERT(actor, in_order_count == PORT_COUNT, "%u/%u ports have received their messages in order.", in_order_count, PORT_COUNT);
+
+    for (imessage = 0; imessage < PORT_COUNT; imessage++) {
+        ims_test_mc_input_free(sockets[imessage]);
+    }
+
+    return ims_test_end(actor);
+}
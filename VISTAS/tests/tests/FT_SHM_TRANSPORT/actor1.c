@@ -0,0 +1,104 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Shared memory transport test - actor 1
+//
+#include "ims_test.h"
+
+#define IMS_CONFIG_FILE      "config/actor1/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor1/vistas.xml"
+
+#define ACTOR_ID 1
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define COUNTER_SIZE      4
+#define COUNTER_DEPTH     10
+#define COUNTER_COUNT     100     // More than the 64 datagrams of a ring
+
+#define BIG_MAX_SIZE      20000   // More than a ring slot
+#define SMALL_SIZE        100
+
+#define INVALID_POINTER ((void*)42)
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  ims_counter;
+    ims_message_t  ims_big;
+    static char    big_payload[BIG_MAX_SIZE];
+    uint32_t       counter;
+    int            error = 0;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    TEST_WAIT(actor, 2); // Wait actor2 ready to read before starting our tests
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    ims_counter = (ims_message_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, "counter", COUNTER_SIZE, COUNTER_DEPTH, ims_output, &ims_counter) == ims_no_error &&
+                       ims_counter != (ims_message_t)INVALID_POINTER && ims_counter != NULL,
+                       "We can get the counter message.");
+
+    ims_big = (ims_message_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, "big", BIG_MAX_SIZE, 2, ims_output, &ims_big) == ims_no_error &&
+                       ims_big != (ims_message_t)INVALID_POINTER && ims_big != NULL,
+                       "We can get the big message.");
+
+    // Lapped reader: actor2 doesn't read while we send more than the ring holds
+    for (counter = 0; counter < COUNTER_COUNT; counter++) {
+        if (ims_push_queuing_message(ims_counter, (const char*)&counter, COUNTER_SIZE) != ims_no_error) error = 1;
+        if ((counter + 1) % COUNTER_DEPTH == 0 && ims_send_all(ims_context) != ims_no_error) error = 1;
+    }
+    TEST_ASSERT(actor, error == 0, "%u counters are pushed and sent.", COUNTER_COUNT);
+
+    TEST_SIGNAL(actor, 2); // Tell actor2 we have sent
+    TEST_WAIT(actor, 2);
+
+    // Too big datagram: it is dropped and doesn't block the port
+    memset(big_payload, 'B', BIG_MAX_SIZE);
+    TEST_ASSERT(actor, ims_push_queuing_message(ims_big, big_payload, BIG_MAX_SIZE) == ims_no_error, "Push the big message.");
+    TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "ims_send_all return ims_no_error.");
+
+    memset(big_payload, 'S', SMALL_SIZE);
+    TEST_ASSERT(actor, ims_push_queuing_message(ims_big, big_payload, SMALL_SIZE) == ims_no_error, "Push a small message on the same port.");
+    TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "The small message is sent.");
+
+    TEST_SIGNAL(actor, 2); // Tell actor2 we have sent
+    TEST_WAIT(actor, 2);
+
+    ims_free_context(ims_context);
+
+    return ims_test_end(actor);
+}
@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Shared memory transport test - actor 2
+//
+#include "ims_test.h"
+
+#define IMS_CONFIG_FILE      "config/actor2/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor2/vistas.xml"
+
+#define ACTOR_ID 2
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define COUNTER_SIZE      4
+#define COUNTER_DEPTH     128
+#define COUNTER_COUNT     100
+#define RING_SLOT_COUNT   64
+
+#define BIG_MAX_SIZE      20000
+#define SMALL_SIZE        100
+
+#define INVALID_POINTER ((void*)42)
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  ims_counter;
+    ims_message_t  ims_big;
+    static char    received_payload[BIG_MAX_SIZE];
+    uint32_t       received_size;
+    uint32_t       count;
+    uint32_t       counter;
+    uint32_t       expected;
+    int            in_order = 1;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    ims_counter = (ims_message_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, "counter", COUNTER_SIZE, COUNTER_DEPTH, ims_input, &ims_counter) == ims_no_error &&
+                       ims_counter != (ims_message_t)INVALID_POINTER && ims_counter != NULL,
+                       "We can get the counter message.");
+
+    ims_big = (ims_message_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, "big", BIG_MAX_SIZE, 2, ims_input, &ims_big) == ims_no_error &&
+                       ims_big != (ims_message_t)INVALID_POINTER && ims_big != NULL,
+                       "We can get the big message.");
+
+    TEST_SIGNAL(actor, 1); // We are ready
+    TEST_WAIT(actor, 1);
+
+    // The emitter went round the ring: only the newest datagrams are left, in order
+    TEST_ASSERT(actor, ims_import(ims_context, 1000*1000) == ims_no_error, "Import success.");
+    TEST_ASSERT(actor, ims_queuing_message_pending(ims_counter, &count) == ims_no_error, "queuing_message_pending return no_error.");
+    TEST_ASSERT(actor, count == RING_SLOT_COUNT, "The lapped reader has the last %u counters (%u pending).", RING_SLOT_COUNT, count);
+
+    expected = COUNTER_COUNT - RING_SLOT_COUNT;
+    while (ims_pop_queuing_message(ims_counter, (char*)&counter, &received_size) == ims_no_error && received_size == COUNTER_SIZE) {
+        if (counter != expected) in_order = 0;
+        expected++;
+    }
+    TEST_ASSERT(actor, in_order && expected == COUNTER_COUNT, "The counters from %u to %u are received in order.",
+                COUNTER_COUNT - RING_SLOT_COUNT, COUNTER_COUNT - 1);
+
+    TEST_SIGNAL(actor, 1);
+    TEST_WAIT(actor, 1);
+
+    // The big message, bigger than a ring slot, is dropped: only the small one went through
+    TEST_ASSERT(actor, ims_import(ims_context, 1000*1000) == ims_no_error, "Import success.");
+    TEST_ASSERT(actor, ims_queuing_message_pending(ims_big, &count) == ims_no_error && count == 1, "Only one message is received on the big port.");
+    TEST_ASSERT(actor, ims_pop_queuing_message(ims_big, received_payload, &received_size) == ims_no_error &&
+                received_size == SMALL_SIZE && received_payload[0] == 'S' && received_payload[SMALL_SIZE - 1] == 'S',
+                "The small message is received.");
+    TEST_ASSERT(actor, ims_queuing_message_pending(ims_counter, &count) == ims_no_error && count == 0, "No counter is received again.");
+
+    TEST_SIGNAL(actor, 1);
+
+    ims_free_context(ims_context);
+
+    return ims_test_end(actor);
+}
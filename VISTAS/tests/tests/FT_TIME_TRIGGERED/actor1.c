@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+
+//
+// Time-triggered test - actor 1
+//
+#include "ims_test.h"
+
+#define IMS_CONFIG_FILE      "config/actor1/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor1/vistas.xml"
+#define IMS_INIT_FILE        "config/actor1/init.xml"
+
+#define ACTOR_ID 1
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define DISC_FALSE  0
+
+#define GRP2_SIG1_SIZE  1
+
+#define INVALID_POINTER ((void*)42)
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t ims_equipment;
+    ims_node_t ims_application;
+    ims_message_t     grp2_sig1;
+    char              payload[4];
+
+    actor = ims_test_init(ACTOR_ID);
+
+    TEST_WAIT(actor, 2); // Wait actor2 ready to read before starting our tests
+
+    ims_create_context_parameter_t create_parameter = IMS_CREATE_CONTEXT_INITIALIZER;
+    create_parameter.init_file_path = IMS_INIT_FILE;
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, &create_parameter, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    grp2_sig1 = (ims_message_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_discrete, "signal3", GRP2_SIG1_SIZE, 1, ims_output, &grp2_sig1) == ims_no_error &&
+                       grp2_sig1 != (ims_message_t)INVALID_POINTER && grp2_sig1 != NULL,
+                       "We can get the grp2_sig1.");
+
+    // Periodic ports are sent by the library, without send_all nor progress
+    TEST_SIGNAL(actor, 2);
+    TEST_WAIT(actor, 2);
+
+    // A modified port is sent by the next send_all, before its period boundary
+    memset(payload, 0, 4);
+    *(payload + GRP2_SIG1_SIZE - 1) = DISC_FALSE;
+    TEST_ASSERT(actor, ims_write_sampling_message(grp2_sig1, payload, GRP2_SIG1_SIZE) == ims_no_error, "grp2_sig1 write.");
+    TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "ims_send_all return ims_no_error.");
+
+    TEST_SIGNAL(actor, 2); // Tell actor2 we have sent
+    TEST_WAIT(actor, 2);
+
+    // Done
+    ims_free_context(ims_context);
+    return ims_test_end(actor);
+}
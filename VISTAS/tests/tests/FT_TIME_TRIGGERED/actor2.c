@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+
+//
+// Time-triggered test - actor 2
+//
+#include "ims_test.h"
+
+#define ACTOR_ID 2
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define GRP2_SIG1_FALSE    3
+
+#define GROUP1_IP             "226.23.12.4"
+#define GROUP1_PORT           5078
+#define GROUP1_SIZE           2
+#define GROUP1_PERIOD_US      20000
+
+#define GROUP2_IP             "226.23.12.4"
+#define GROUP2_PORT           5079
+#define GROUP2_SIZE           2
+
+#define RECEIVED_COUNT        5
+
+int main()
+{
+    char      received_payload[50];
+    uint64_t  first_us = 0;
+    uint32_t  ireceived;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    ims_test_mc_input_t socket_group1 = ims_test_mc_input_create(actor, GROUP1_IP, GROUP1_PORT);
+    ims_test_mc_input_t socket_group2 = ims_test_mc_input_create(actor, GROUP2_IP, GROUP2_PORT);
+
+    TEST_SIGNAL(actor, 1);
+    TEST_WAIT(actor, 1);
+
+    // Actor1 never calls send_all: group 1 is sent on its period anyway
+    for (ireceived = 0; ireceived < RECEIVED_COUNT; ireceived++) {
+        TEST_ASSERT_SILENT(actor, ims_test_mc_input_receive(socket_group1, received_payload, 50, 1000 * 100) == VISTAS_HEADER_SIZE + GROUP1_SIZE,
+                           "We have received the group 1.");
+        if (ireceived == 0) first_us = ims_test_time_us();
+    }
+    TEST_ASSERT(actor, ims_test_time_us() - first_us >= (RECEIVED_COUNT - 1) * GROUP1_PERIOD_US / 2,
+                "Group 1 is sent once per period.");
+
+    // Forget the group 2 sent on its period, if any
+    while (ims_test_mc_input_receive(socket_group2, received_payload, 50, 0) > 0);
+
+    TEST_SIGNAL(actor, 1);
+    TEST_WAIT(actor, 1);
+
+    // Actor1 has modified group 2 and called send_all
+    TEST_ASSERT(actor, ims_test_mc_input_receive(socket_group2, received_payload, 50, 1000 * 100) == VISTAS_HEADER_SIZE + GROUP2_SIZE,
+                "We have received the group 2.");
+    TEST_ASSERT(actor, received_payload[VISTAS_HEADER_SIZE + 0] == GRP2_SIG1_FALSE, "GRP2_SIG1 has the expected value.");
+
+    TEST_SIGNAL(actor, 1);
+
+    ims_test_mc_input_free(socket_group1);
+    ims_test_mc_input_free(socket_group2);
+
+    return ims_test_end(actor);
+}
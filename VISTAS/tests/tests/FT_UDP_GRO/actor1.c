@@ -0,0 +1,105 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// UDP GRO test - actor 1
+//
+#include "ims_test.h"
+
+#define IMS_CONFIG_FILE      "config/actor1/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor1/vistas.xml"
+
+#define ACTOR_ID 1
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_MAX_SIZE  100
+#define SHORT_SIZE        40
+#define QUEUING_DEPTH     32
+#define ROUND_COUNT       3
+
+#define INVALID_POINTER ((void*)42)
+
+//
+// Size of a message of the burst:
+// - round 0: all the same size, one GSO datagram
+// - round 1: the same, but a shorter last one, allowed as the last GSO segment
+// - round 2: sizes alternate, nothing can be coalesced
+//
+static uint32_t message_size(uint32_t round, uint32_t index)
+{
+    if (round == 1 && index == QUEUING_DEPTH - 1) return SHORT_SIZE;
+    if (round == 2 && index % 2) return SHORT_SIZE;
+    return MESSAGE_MAX_SIZE;
+}
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  ims_burst;
+    char           payload[MESSAGE_MAX_SIZE];
+    uint32_t       iround;
+    uint32_t       imessage;
+    uint32_t       sequence;
+    int            error;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    ims_burst = (ims_message_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, "burst", MESSAGE_MAX_SIZE, QUEUING_DEPTH, ims_output, &ims_burst) == ims_no_error &&
+                       ims_burst != (ims_message_t)INVALID_POINTER && ims_burst != NULL,
+                       "We can get the burst message.");
+
+    TEST_WAIT(actor, 2); // Wait actor2 ready to read before starting our tests
+
+    // Each message is its sequence then the same byte repeated
+    for (iround = 0; iround < ROUND_COUNT; iround++) {
+        error = 0;
+        for (imessage = 0; imessage < QUEUING_DEPTH; imessage++) {
+            sequence = iround * QUEUING_DEPTH + imessage;
+            memset(payload, (char)sequence, MESSAGE_MAX_SIZE);
+            memcpy(payload, &sequence, sizeof(sequence));
+            if (ims_push_queuing_message(ims_burst, payload, message_size(iround, imessage)) != ims_no_error) error = 1;
+        }
+        TEST_ASSERT(actor, error == 0, "Round %u: the burst is pushed.", iround);
+        TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "Round %u: ims_send_all return ims_no_error.", iround);
+
+        TEST_SIGNAL(actor, 2); // Tell actor2 we have sent
+        TEST_WAIT(actor, 2);
+    }
+
+    ims_free_context(ims_context);
+
+    return ims_test_end(actor);
+}
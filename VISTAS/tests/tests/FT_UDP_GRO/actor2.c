@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// UDP GRO test - actor 2
+//
+#include "ims_test.h"
+
+#define IMS_CONFIG_FILE      "config/actor2/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor2/vistas.xml"
+
+#define ACTOR_ID 2
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_MAX_SIZE  100
+#define SHORT_SIZE        40
+#define QUEUING_DEPTH     32
+#define ROUND_COUNT       3
+
+#define INVALID_POINTER ((void*)42)
+
+// Same sizes as actor1
+static uint32_t message_size(uint32_t round, uint32_t index)
+{
+    if (round == 1 && index == QUEUING_DEPTH - 1) return SHORT_SIZE;
+    if (round == 2 && index % 2) return SHORT_SIZE;
+    return MESSAGE_MAX_SIZE;
+}
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  ims_burst;
+    char           received_payload[MESSAGE_MAX_SIZE];
+    uint32_t       received_size;
+    uint32_t       received_sequence;
+    uint32_t       count;
+    uint32_t       iround;
+    uint32_t       imessage;
+    uint32_t       ibyte;
+    uint32_t       sequence;
+    uint32_t       split_ok;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    ims_burst = (ims_message_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, "burst", MESSAGE_MAX_SIZE, QUEUING_DEPTH, ims_input, &ims_burst) == ims_no_error &&
+                       ims_burst != (ims_message_t)INVALID_POINTER && ims_burst != NULL,
+                       "We can get the burst message.");
+
+    TEST_SIGNAL(actor, 1); // We are ready
+
+    // Coalesced or not, each message comes out alone, with its size and content
+    for (iround = 0; iround < ROUND_COUNT; iround++) {
+        TEST_WAIT(actor, 1); // Wait actor1 has sent
+
+        TEST_ASSERT(actor, ims_import(ims_context, 1000*1000) == ims_no_error, "Round %u: import success.", iround);
+        TEST_ASSERT(actor, ims_queuing_message_pending(ims_burst, &count) == ims_no_error && count == QUEUING_DEPTH,
+                    "Round %u: %u/%u messages received.", iround, count, QUEUING_DEPTH);
+
+        split_ok = 0;
+        for (imessage = 0; imessage < QUEUING_DEPTH; imessage++) {
+            sequence = iround * QUEUING_DEPTH + imessage;
+            memset(received_payload, 0, MESSAGE_MAX_SIZE);
+            if (ims_pop_queuing_message(ims_burst, received_payload, &received_size) != ims_no_error ||
+                received_size != message_size(iround, imessage)) {
+                continue;
+            }
+            memcpy(&received_sequence, received_payload, sizeof(received_sequence));
+            if (received_sequence != sequence) continue;
+            for (ibyte = sizeof(sequence); ibyte < received_size; ibyte++) {
+                if (received_payload[ibyte] != (char)sequence) break;
+            }
+            if (ibyte == received_size) split_ok++;
+        }
+        TEST_ASSERT(actor, split_ok == QUEUING_DEPTH, "Round %u: %u/%u messages have their own size and content, in order.",
+                    iround, split_ok, QUEUING_DEPTH);
+
+        TEST_SIGNAL(actor, 1);
+    }
+
+    ims_free_context(ims_context);
+
+    return ims_test_end(actor);
+}
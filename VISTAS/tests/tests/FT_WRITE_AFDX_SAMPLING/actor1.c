@@ -29,6 +29,7 @@ ims_test_actor_t actor;
 static const char message1_payload[MESSAGE1_SIZE] = "hello, world!";
 static const char message2_payload[MESSAGE2_SIZE] = "You too!";
 static const char message1_last_payload[MESSAGE1_SIZE] = "Ok, see you!";
+static const char message2_last_payload[MESSAGE2_SIZE] = "Bye!";
 
 #define INVALID_POINTER ((void*)42)
 
@@ -44,6 +45,8 @@ int main()
     ims_message_t     ims_message2;
     ims_message_t     ims_input_message;
     ims_message_t     ims_queuing_message;
+    char*             buffer;
+    uint32_t          capacity;
 
     actor = ims_test_init(ACTOR_ID);
 
@@ -120,6 +123,22 @@ int main()
 
     TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "ims_send_all return ims_no_error.");
 
+    TEST_SIGNAL(actor, 2); // Signal we have sent
+    TEST_WAIT(actor, 2);
+
+    // Write the message2 in place
+    TEST_ASSERT(actor, ims_acquire_output_buffer(ims_message2, &buffer, &capacity) == ims_no_error,
+                "Acquire message2 buffer return no_error.");
+    TEST_ASSERT(actor, capacity == MESSAGE2_SIZE, "Message2 buffer has the message size.");
+    memcpy(buffer, message2_last_payload, MESSAGE2_SIZE);
+    TEST_ASSERT(actor, ims_commit_output_buffer(ims_message2, MESSAGE2_SIZE) == ims_no_error,
+                "Commit message2 buffer return no_error.");
+
+    TEST_ASSERT(actor, ims_acquire_output_buffer(ims_input_message, &buffer, &capacity) == ims_invalid_configuration,
+                "Cannot acquire the buffer of an input message.");
+
+    TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "ims_send_all return ims_no_error.");
+
     TEST_SIGNAL(actor, 2); // Signal we have sent
 
     ims_free_context(ims_context);
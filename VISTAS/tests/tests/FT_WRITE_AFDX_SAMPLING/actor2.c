@@ -30,6 +30,7 @@ ims_test_actor_t actor;
 static const char expected_payload1[MESSAGE1_SIZE] = "hello, world!";
 static const char expected_payload2[MESSAGE2_SIZE] = "You too!";
 static const char expected_last_payload1[MESSAGE1_SIZE] = "Ok, see you!";
+static const char expected_last_payload2[MESSAGE2_SIZE] = "Bye!";
 
 #define MESSAGE1_IP    "226.23.12.4"
 #define MESSAGE1_PORT  5078
@@ -87,6 +88,13 @@ int main()
     TEST_ASSERT(actor, ims_test_mc_input_receive(socket2, received_payload, MESSAGE2_SIZE, 100 * 1000) == 0,
                 "No message2 received");
 
+    TEST_SIGNAL(actor, 1);  // Ask to write message2 in place
+    TEST_WAIT(actor, 1);    // Send done
+
+    TEST_ASSERT(actor, ims_test_mc_input_receive(socket2, received_payload, MESSAGE2_SIZE + VISTAS_HEADER_SIZE, 100 * 1000) == MESSAGE2_SIZE + VISTAS_HEADER_SIZE,
+                "Message2 received and has the good length.");
+    TEST_ASSERT(actor, strcmp(received_payload + VISTAS_HEADER_SIZE, expected_last_payload2) == 0, "Message2 has the expected content.");
+
     ims_test_mc_input_free(socket1);
     ims_test_mc_input_free(socket2);
 
@@ -0,0 +1,218 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Thread-safe write test - actor 1
+//
+#include "ims_test.h"
+#include <pthread.h>
+
+#define IMS_CONFIG_FILE      "config/actor1/ims.xml"
+#define VISTAS_CONFIG_FILE   "config/actor1/vistas.xml"
+
+#define ACTOR_ID 1
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_SIZE   64
+#define FINAL_PATTERN  0xEE
+
+#define WRITER_COUNT   2
+#define MESSAGE_COUNT  (WRITER_COUNT + 2)   // Shared, one per writer, copied
+#define RUN_US         (300 * TEST_MILISECOND)
+
+#define INVALID_POINTER ((void*)42)
+
+//
+// A writer thread: writes its own message, the shared one and the copied one, until stopped.
+// The payload is the writer id then the same byte repeated.
+//
+typedef struct {
+    uint32_t      id;
+    ims_message_t own_message;
+    ims_message_t shared_message;
+    ims_message_t copied_message;
+    uint32_t      write_count;
+    uint32_t      shared_write_count;
+    uint32_t      busy_count;
+    uint32_t      error_count;
+} writer_t;
+
+static volatile int stop_requested = 0;
+
+static void fill(char* payload, uint32_t id, uint32_t counter)
+{
+    payload[0] = (char)id;
+    memset(payload + 1, (char)counter, MESSAGE_SIZE - 1);
+}
+
+static void* writer_main(void* arg)
+{
+    writer_t* writer = (writer_t*)arg;
+    char      payload[MESSAGE_SIZE];
+    char*     buffer;
+    uint32_t  capacity;
+    uint32_t  counter = 0;
+
+    while (stop_requested == 0) {
+        counter++;
+
+        // Own message: one copy, one in place
+        if (counter & 1) {
+            fill(payload, writer->id, counter);
+            if (ims_write_sampling_message(writer->own_message, payload, MESSAGE_SIZE) != ims_no_error) writer->error_count++;
+        } else if (ims_acquire_output_buffer(writer->own_message, &buffer, &capacity) == ims_no_error) {
+            fill(buffer, writer->id, counter);
+            if (ims_commit_output_buffer(writer->own_message, MESSAGE_SIZE) != ims_no_error) writer->error_count++;
+        } else {
+            writer->error_count++;
+        }
+        writer->write_count++;
+
+        // Shared message: only one writer can hold its buffer
+        ims_return_code_t result = ims_acquire_output_buffer(writer->shared_message, &buffer, &capacity);
+        if (result == ims_no_error) {
+            fill(buffer, writer->id, counter);
+            if (ims_commit_output_buffer(writer->shared_message, MESSAGE_SIZE) != ims_no_error) writer->error_count++;
+            writer->shared_write_count++;
+        } else if (result == ims_implementation_specific_error) {
+            writer->busy_count++;
+        } else {
+            writer->error_count++;
+        }
+
+        // Copied message: all the writers copy it at the same time
+        fill(payload, writer->id, counter);
+        if (ims_write_sampling_message(writer->copied_message, payload, MESSAGE_SIZE) != ims_no_error) writer->error_count++;
+    }
+    return NULL;
+}
+
+//
+// Main
+//
+int main()
+{
+    ims_node_t     ims_context;
+    ims_node_t     ims_equipment;
+    ims_node_t     ims_application;
+    ims_message_t  ims_messages[MESSAGE_COUNT];
+    const char*    local_names[MESSAGE_COUNT] = { "shared", "writer1", "writer2", "copied" };
+    writer_t       writers[WRITER_COUNT];
+    pthread_t      threads[WRITER_COUNT];
+    char           payload[MESSAGE_SIZE];
+    char*          buffer;
+    uint32_t       capacity;
+    uint32_t       imessage;
+    uint32_t       iwriter;
+    uint32_t       send_count = 0;
+    uint64_t       send_max_us = 0;
+    int            send_error = 0;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    TEST_WAIT(actor, 2); // Wait actor2 ready to read before starting our tests
+
+    ims_context = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_create_context(IMS_CONFIG_FILE, VISTAS_CONFIG_FILE, NULL, &ims_context) == ims_no_error &&
+                       ims_context != (ims_node_t)INVALID_POINTER && ims_context != NULL,
+                       "We can create a valid context.");
+
+    ims_equipment = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_equipment(ims_context, "firstEquipment", &ims_equipment) == ims_no_error &&
+                       ims_equipment != (ims_node_t)INVALID_POINTER && ims_equipment != NULL,
+                       "We can get the first equipment.");
+
+    ims_application = (ims_node_t)INVALID_POINTER;
+    TEST_ASSERT_SILENT(actor, ims_get_application(ims_equipment, "firstApplication", &ims_application) == ims_no_error &&
+                       ims_application != (ims_node_t)INVALID_POINTER && ims_application != NULL,
+                       "We can get the first application.");
+
+    for (imessage = 0; imessage < MESSAGE_COUNT; imessage++) {
+        ims_messages[imessage] = (ims_message_t)INVALID_POINTER;
+        TEST_ASSERT_SILENT(actor, ims_get_message(ims_application, ims_afdx, local_names[imessage], MESSAGE_SIZE, 1, ims_output, &ims_messages[imessage]) == ims_no_error &&
+                           ims_messages[imessage] != (ims_message_t)INVALID_POINTER && ims_messages[imessage] != NULL,
+                           "We can get the message %s.", local_names[imessage]);
+    }
+
+    // One writer at a time on a buffer
+    TEST_ASSERT(actor, ims_acquire_output_buffer(ims_messages[0], &buffer, &capacity) == ims_no_error,
+                "Acquire the shared message buffer.");
+    TEST_ASSERT(actor, ims_acquire_output_buffer(ims_messages[0], &buffer, &capacity) == ims_implementation_specific_error,
+                "Cannot acquire the shared message buffer twice.");
+
+    // An open write does not hold send_all
+    TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "ims_send_all return ims_no_error while a buffer is acquired.");
+
+    fill(buffer, 0, 0);
+    TEST_ASSERT(actor, ims_commit_output_buffer(ims_messages[0], MESSAGE_SIZE) == ims_no_error,
+                "Commit the shared message buffer.");
+    TEST_ASSERT(actor, ims_commit_output_buffer(ims_messages[0], MESSAGE_SIZE) == ims_invalid_configuration,
+                "Cannot commit a buffer not acquired.");
+
+    // Writers run while this thread sends
+    memset(writers, 0, sizeof(writers));
+    for (iwriter = 0; iwriter < WRITER_COUNT; iwriter++) {
+        writers[iwriter].id = iwriter + 1;
+        writers[iwriter].own_message = ims_messages[iwriter + 1];
+        writers[iwriter].shared_message = ims_messages[0];
+        writers[iwriter].copied_message = ims_messages[MESSAGE_COUNT - 1];
+        TEST_ASSERT(actor, pthread_create(&threads[iwriter], NULL, writer_main, &writers[iwriter]) == 0,
+                    "Writer %d started.", iwriter + 1);
+    }
+
+    uint64_t start_us = ims_test_time_us();
+    while (ims_test_time_us() - start_us < RUN_US) {
+        uint64_t send_start_us = ims_test_time_us();
+        if (ims_send_all(ims_context) != ims_no_error) send_error = 1;
+        uint64_t send_us = ims_test_time_us() - send_start_us;
+        if (send_us > send_max_us) send_max_us = send_us;
+        send_count++;
+        ims_test_sleep(100);
+    }
+
+    stop_requested = 1;
+    for (iwriter = 0; iwriter < WRITER_COUNT; iwriter++) {
+        pthread_join(threads[iwriter], NULL);
+    }
+
+    TEST_ASSERT(actor, send_error == 0, "ims_send_all return ims_no_error while the writers run.");
+    TEST_LOG(actor, "%u ims_send_all, the longest took %u us.", send_count, (uint32_t)send_max_us);
+    TEST_ASSERT(actor, send_max_us < 100 * TEST_MILISECOND, "ims_send_all is not held by the writers.");
+
+    for (iwriter = 0; iwriter < WRITER_COUNT; iwriter++) {
+        TEST_LOG(actor, "Writer %d: %u writes, %u on the shared message, %u busy.", writers[iwriter].id,
+                 writers[iwriter].write_count, writers[iwriter].shared_write_count, writers[iwriter].busy_count);
+        TEST_ASSERT(actor, writers[iwriter].error_count == 0, "Writer %d had no error.", writers[iwriter].id);
+        TEST_ASSERT(actor, writers[iwriter].write_count > 0, "Writer %d has written its message.", writers[iwriter].id);
+        TEST_ASSERT(actor, writers[iwriter].shared_write_count > 0, "Writer %d has written the shared message.", writers[iwriter].id);
+    }
+
+    // Let actor2 drain its sockets, then send the last values
+    ims_test_sleep(50 * TEST_MILISECOND);
+
+    memset(payload, FINAL_PATTERN, MESSAGE_SIZE);
+    payload[0] = 0;
+    for (imessage = 0; imessage < MESSAGE_COUNT; imessage++) {
+        TEST_ASSERT(actor, ims_write_sampling_message(ims_messages[imessage], payload, MESSAGE_SIZE) == ims_no_error,
+                    "Write the last value of %s.", local_names[imessage]);
+    }
+    TEST_ASSERT(actor, ims_send_all(ims_context) == ims_no_error, "ims_send_all return ims_no_error.");
+
+    TEST_SIGNAL(actor, 2); // Signal we have sent the last values
+
+    ims_free_context(ims_context);
+
+    return ims_test_end(actor);
+}
@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * Copyright (c) 2018 Airbus Operations S.A.S                                  *
+ *                                                                             *
+ * This program and the accompanying materials are made available under the    *
+ * terms of the Eclipse Public License v. 2.0 which is available at            *
+ * http://www.eclipse.org/legal/epl-2.0, or the Eclipse Distribution License   *
+ * v. 1.0 which is available at                                                *
+ * http://www.eclipse.org/org/documents/edl-v10.php.                           *
+ *                                                                             *
+ * SPDX-License-Identifier: EPL-2.0 OR BSD-3-Clause                            *
+ *******************************************************************************/
+
+//
+// Thread-safe write test - actor 2
+//
+#include "ims_test.h"
+
+#define ACTOR_ID 2
+ims_test_actor_t actor;
+
+//
+// Message data
+//
+#define MESSAGE_SIZE   64
+#define FINAL_PATTERN  0xEE
+
+#define MESSAGE_IP     "226.23.12.4"
+#define MESSAGE_COUNT  4
+static const uint32_t message_ports[MESSAGE_COUNT] = { 5078, 5079, 5080, 5081 };
+
+#define RECEIVE_TIMEOUT_US  (5 * TEST_SECOND)
+
+int main()
+{
+    ims_test_mc_input_t sockets[MESSAGE_COUNT];
+    char                received_payload[100];
+    uint32_t            received_count[MESSAGE_COUNT] = { 0 };
+    uint32_t            torn_count[MESSAGE_COUNT] = { 0 };
+    int                 final_received[MESSAGE_COUNT] = { 0 };
+    uint32_t            final_count = 0;
+    uint32_t            imessage;
+    uint32_t            ibyte;
+
+    actor = ims_test_init(ACTOR_ID);
+
+    for (imessage = 0; imessage < MESSAGE_COUNT; imessage++) {
+        sockets[imessage] = ims_test_mc_input_create(actor, MESSAGE_IP, message_ports[imessage]);
+    }
+
+    TEST_SIGNAL(actor, 1); // We are ready
+
+    // Each datagram must hold one write: the writer id, then the same byte
+    uint64_t start_us = ims_test_time_us();
+    while (final_count < MESSAGE_COUNT && ims_test_time_us() - start_us < RECEIVE_TIMEOUT_US) {
+        for (imessage = 0; imessage < MESSAGE_COUNT; imessage++) {
+            if (ims_test_mc_input_receive(sockets[imessage], received_payload, 100, TEST_MILISECOND) != VISTAS_HEADER_SIZE + MESSAGE_SIZE) {
+                continue;
+            }
+            received_count[imessage]++;
+
+            const char* payload = received_payload + VISTAS_HEADER_SIZE;
+            for (ibyte = 2; ibyte < MESSAGE_SIZE; ibyte++) {
+                if (payload[ibyte] != payload[1]) {
+                    torn_count[imessage]++;
+                    break;
+                }
+            }
+
+            if (payload[0] == 0 && (uint8_t)payload[1] == FINAL_PATTERN && final_received[imessage] == 0) {
+                final_received[imessage] = 1;
+                final_count++;
+            }
+        }
+    }
+
+    for (imessage = 0; imessage < MESSAGE_COUNT; imessage++) {
+        TEST_LOG(actor, "Port %u: %u datagrams received.", message_ports[imessage], received_count[imessage]);
+        TEST_ASSERT(actor, received_count[imessage] > 1, "Port %u has been sent while written.", message_ports[imessage]);
+        TEST_ASSERT(actor, torn_count[imessage] == 0, "Port %u has never been sent half written.", message_ports[imessage]);
+        TEST_ASSERT(actor, final_received[imessage], "Port %u has been sent with its last value.", message_ports[imessage]);
+    }
+
+    TEST_WAIT(actor, 1); // Last values sent
+
+    for (imessage = 0; imessage < MESSAGE_COUNT; imessage++) {
+        ims_test_mc_input_free(sockets[imessage]);
+    }
+
+    return ims_test_end(actor);
+}
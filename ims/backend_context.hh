@@ -96,6 +96,34 @@ typedef shared_ptr<context> context_ptr;
 //
 context::factory_ptr create_factory(const char* backend_config_file_path);
 
+//
+// Import several contexts of the process together
+//
+class reactor
+{
+public:
+    //
+    // Add/remove a context
+    //
+    virtual void attach(context_ptr context) = 0;
+    virtual void detach(context_ptr context) = 0;
+
+    //
+    // Import incoming data of all the contexts
+    //
+    virtual ims_return_code_t import(uint32_t timeout) = 0;
+
+    //
+    // Free, without freeing the contexts
+    //
+    virtual ~reactor() {}
+};
+
+//
+// Implemented by the backend to create a reactor. Freed by the caller.
+//
+reactor* create_reactor();
+
 //
 // Backend factory
 //
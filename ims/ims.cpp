@@ -406,6 +406,18 @@ ims_return_code_t ims_read_sampling_message(ims_message_t   message_base,
     CATCH(ims_implementation_specific_error, "Failed to read message!");
 }
 
+ims_return_code_t ims_read_sampling_message_view(ims_message_t       message_base,
+                                                 ims_message_view_t* view)
+{
+    try {
+        ims::message* message = static_cast<ims::message*>(message_base);
+        LOG_INFO("CALL ims_read_sampling_message_view(" << message->get_name() << ")");
+
+        return message->read_sampling_view(view);
+    }
+    CATCH(ims_implementation_specific_error, "Failed to read message!");
+}
+
 ims_return_code_t ims_push_queuing_message(ims_message_t message_base,
                                            const char*   message_addr,
                                            uint32_t      message_size)
@@ -462,6 +474,142 @@ ims_return_code_t ims_read_nad_message(ims_message_t   message_base,
     CATCH(ims_implementation_specific_error, "Failed to read message!");
 }
 
+ims_return_code_t ims_read_nad_message_view(ims_message_t       message_base,
+                                            ims_message_view_t* view)
+{
+    try {
+        ims::message* message = static_cast<ims::message*>(message_base);
+        LOG_INFO("CALL ims_read_nad_message_view(" << message->get_name() << ")");
+
+        return message->read_nad_view(view);
+    }
+    CATCH(ims_implementation_specific_error, "Failed to read message!");
+}
+
+ims_return_code_t ims_release_view(ims_message_t       message_base,
+                                   ims_message_view_t* view)
+{
+    try {
+        ims::message* message = static_cast<ims::message*>(message_base);
+        LOG_INFO("CALL ims_release_view(" << message->get_name() << ")");
+
+        return message->release_view(view);
+    }
+    CATCH(ims_implementation_specific_error, "Failed to release view!");
+}
+
+ims_return_code_t ims_acquire_output_buffer(ims_message_t message_base,
+                                            char**        buffer,
+                                            uint32_t*     capacity)
+{
+    try {
+        ims::message* message = static_cast<ims::message*>(message_base);
+        LOG_INFO("CALL ims_acquire_output_buffer(" << message->get_name() << ")");
+
+        return message->acquire_output_buffer(buffer, capacity);
+    }
+    CATCH(ims_implementation_specific_error, "Failed to acquire output buffer!");
+}
+
+ims_return_code_t ims_commit_output_buffer(ims_message_t message_base,
+                                           uint32_t      message_size)
+{
+    try {
+        ims::message* message = static_cast<ims::message*>(message_base);
+        LOG_INFO("CALL ims_commit_output_buffer(" << message->get_name() << ")");
+
+        return message->commit_output_buffer(message_size);
+    }
+    CATCH(ims_implementation_specific_error, "Failed to commit output buffer!");
+}
+
+/******************
+ * Batched access *
+ ******************/
+
+// Apply the given operation on each message.
+// Errors are stored in each descriptor, the worst one is returned.
+typedef ims_return_code_t (*batch_operation_t)(ims::message* message, ims_io_desc_t* desc);
+
+static ims_return_code_t batch_apply(const char*          name,
+                                     batch_operation_t    operation,
+                                     const ims_message_t* messages,
+                                     uint32_t             count,
+                                     ims_io_desc_t*       descs)
+{
+    LOG_INFO("CALL " << name << "(" << count << " messages)");
+
+    ims_return_code_t result = ims_no_error;
+    for (uint32_t id = 0; id < count; id++) {
+        ims::message* message = static_cast<ims::message*>(messages[id]);
+        ims_io_desc_t* desc = &descs[id];
+
+        try {
+            desc->result = operation(message, desc);
+        }
+        catch(ims::exception& error) {
+            LOG_ERROR(name << ": failed on message " << message->get_name() << "!");
+            desc->result = error.get_ims_return_code();
+        }
+        catch(...) {
+            LOG_ERROR(name << ": failed on message " << message->get_name() << "! (unkown error)");
+            desc->result = ims_implementation_specific_error;
+        }
+
+        if (desc->result > result) result = desc->result;
+    }
+
+    return result;
+}
+
+static ims_return_code_t batch_read_sampling(ims::message* message, ims_io_desc_t* desc)
+{
+    return message->read_sampling(desc->data, &desc->size, &desc->validity);
+}
+
+static ims_return_code_t batch_write_sampling(ims::message* message, ims_io_desc_t* desc)
+{
+    return message->write_sampling(desc->data, desc->size);
+}
+
+static ims_return_code_t batch_push_queuing(ims::message* message, ims_io_desc_t* desc)
+{
+    return message->push_queuing(desc->data, desc->size);
+}
+
+static ims_return_code_t batch_pop_queuing(ims::message* message, ims_io_desc_t* desc)
+{
+    return message->pop_queuing(desc->data, &desc->size);
+}
+
+ims_return_code_t ims_read_sampling_messages(const ims_message_t* messages,
+                                             uint32_t             count,
+                                             ims_io_desc_t*       descs)
+{
+    return batch_apply("ims_read_sampling_messages", batch_read_sampling, messages, count, descs);
+}
+
+ims_return_code_t ims_write_sampling_messages(const ims_message_t* messages,
+                                              uint32_t             count,
+                                              ims_io_desc_t*       descs)
+{
+    return batch_apply("ims_write_sampling_messages", batch_write_sampling, messages, count, descs);
+}
+
+ims_return_code_t ims_push_queuing_messages(const ims_message_t* messages,
+                                            uint32_t             count,
+                                            ims_io_desc_t*       descs)
+{
+    return batch_apply("ims_push_queuing_messages", batch_push_queuing, messages, count, descs);
+}
+
+ims_return_code_t ims_pop_queuing_messages(const ims_message_t* messages,
+                                           uint32_t             count,
+                                           ims_io_desc_t*       descs)
+{
+    return batch_apply("ims_pop_queuing_messages", batch_pop_queuing, messages, count, descs);
+}
+
 /****************
  * Send/receive *
  ****************/
@@ -486,6 +634,64 @@ ims_return_code_t ims_import(ims_node_t ims_context, uint32_t timeout_us)
     CATCH(ims_implementation_specific_error, "Failed to import messages!");
 }
 
+/***********
+ * Reactor *
+ ***********/
+
+ims_return_code_t ims_create_reactor(ims_reactor_t* reactor)
+{
+    LOG_INFO("CALL ims_create_reactor()");
+
+    *reactor = NULL;
+
+    try {
+        *reactor = (ims_reactor_t)backend::create_reactor();
+    }
+    CATCH(ims_init_failure, "Failed to create reactor!");
+
+    return ims_no_error;
+}
+
+void ims_free_reactor(ims_reactor_t reactor)
+{
+    LOG_INFO("CALL ims_free_reactor()");
+    delete (backend::reactor*)reactor;
+}
+
+ims_return_code_t ims_reactor_attach(ims_reactor_t reactor, ims_node_t ims_context)
+{
+    LOG_INFO("CALL ims_reactor_attach()");
+
+    try {
+        ims::context* context = static_cast<ims::context*>(ims_context);
+        ((backend::reactor*)reactor)->attach(context->get_backend_context());
+    }
+    CATCH(ims_implementation_specific_error, "Failed to attach context to reactor!");
+
+    return ims_no_error;
+}
+
+ims_return_code_t ims_reactor_detach(ims_reactor_t reactor, ims_node_t ims_context)
+{
+    LOG_INFO("CALL ims_reactor_detach()");
+
+    try {
+        ims::context* context = static_cast<ims::context*>(ims_context);
+        ((backend::reactor*)reactor)->detach(context->get_backend_context());
+    }
+    CATCH(ims_implementation_specific_error, "Failed to detach context from reactor!");
+
+    return ims_no_error;
+}
+
+ims_return_code_t ims_reactor_import(ims_reactor_t reactor, uint32_t timeout_us)
+{
+    try {
+        return ((backend::reactor*)reactor)->import(timeout_us);
+    }
+    CATCH(ims_implementation_specific_error, "Failed to import messages!");
+}
+
 /*****************
  * Time handling *
  *****************/
@@ -572,6 +778,23 @@ ims_return_code_t ims_queuing_message_pending(ims_message_t message_base,
     CATCH(ims_implementation_specific_error, "Failed to get pending count!");
 }
 
+/*****************
+ * Send counters *
+ *****************/
+
+ims_return_code_t ims_message_send_counters(ims_message_t message_base,
+                                            uint32_t*     retried_count,
+                                            uint32_t*     dropped_count)
+{
+    try {
+        ims::message* message = static_cast<ims::message*>(message_base);
+        LOG_INFO("CALL ims_message_send_counters(" << message->get_name() << ")");
+
+        return message->send_counters(retried_count, dropped_count);
+    }
+    CATCH(ims_implementation_specific_error, "Failed to get send counters!");
+}
+
 /***********
  * Helpers *
  ***********/
@@ -30,9 +30,10 @@ namespace ims
 
     inline backend::context_ptr get_backend_context() { return _backend_context; }
 
+    inline virtual ~context() { log::detach_context(); }
 
   protected:
-    inline context(std::string vc_name) : node(vc_name) {}
+    inline context(std::string vc_name) : node(vc_name) { log::attach_context(); }
     class factory;
 
     backend::context_ptr _backend_context;
@@ -16,9 +16,19 @@
 #include <fstream>
 #include <stdlib.h>
 #include <iomanip>
+#include <string.h>
 
 #include <sys/time.h>
 
+#ifdef __linux
+#define IMS_LOG_HAVE_RING
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <sys/prctl.h>
+#include <time.h>
+#endif
+
 namespace ims
 {
 
@@ -27,7 +37,8 @@ namespace ims
 //
 const char* exception::what() const throw()
 {
-    //@TODO: better error message
+    if (_what.empty() == false) return _what.c_str();
+
     std::stringstream ss;
     ss << "IMS return code " << _ims_return_code << '.';
     _what = ss.str();
@@ -47,6 +58,213 @@ level_t max_level = disabled;
 // Backend. std::cerr by default
 //
 static std::ostream* backend = &std::cerr;
+static bool          backend_is_file = false;
+
+//
+// Lines logged by different threads (import workers, I/O thread) must not
+// interleave: the backend is held from the date to the end of the line.
+// Taken again by a nested log of the same thread, e.g. while the message is built.
+//
+static uint32_t         backend_lock = 0;
+static __thread uint32_t backend_lock_depth = 0;
+
+static void backend_acquire()
+{
+    if (backend_lock_depth++ != 0) return;
+    while (__atomic_exchange_n(&backend_lock, 1, __ATOMIC_ACQUIRE) != 0) {
+        while (__atomic_load_n(&backend_lock, __ATOMIC_RELAXED) != 0) {
+#if defined(__i386__) || defined(__x86_64__)
+            __builtin_ia32_pause();
+#endif
+        }
+    }
+}
+
+static void backend_release()
+{
+    if (--backend_lock_depth != 0) return;
+    __atomic_store_n(&backend_lock, 0, __ATOMIC_RELEASE);
+}
+
+//
+// Write a record: date then text
+//
+static void write_record(const record_t& record)
+{
+    struct tm s_tm;
+    // with mingw, we need to convert tv_sec (a long) to localtime_r (a long long)
+    time_t converted_time = record.tv_sec;
+    localtime_r(&converted_time, &s_tm);
+
+    *backend << std::setfill('0') << std::setw(2) << s_tm.tm_hour << ":" << std::setfill('0') << std::setw(2) << s_tm.tm_min << ":" << std::setfill('0') << std::setw(2) << s_tm.tm_sec << "," << std::setfill('0') << std::setw(6) << record.tv_usec << " : " ;
+    backend->write(record.text, record.length);
+
+    if (backend_is_file && record.level > warn) {
+        *backend << '\n';
+    } else {
+        *backend << std::endl;
+    }
+}
+
+#ifdef IMS_LOG_HAVE_RING
+//
+// Ring of the records logged while a context exists, with a file backend.
+// Bounded multi-producer queue: a slot is free for the producer of position
+// pos when its sequence is pos, and ready for the drain thread when it is pos + 1.
+//
+#define LOG_RING_SIZE 1024 // Records, power of 2
+
+// Drain thread period when the ring is empty, in ns
+#define LOG_DRAIN_PERIOD_NS 1000000
+
+static record_t*       ring = NULL;
+static uint32_t        ring_head = 0;     // Next position to fill
+static uint32_t        ring_tail = 0;     // Next position to write, drain thread only
+static uint32_t        ring_dropped = 0;  // Debug and info lines lost on a full ring
+static uint32_t        ring_active = 0;   // Producers use the ring
+static uint32_t        ring_producers = 0; // Producers between their ring_active check and their push
+static uint32_t        drain_stop = 0;
+static bool            drain_running = false;
+static pthread_t       drain_thread;
+static uint32_t        context_count = 0;
+static pthread_mutex_t context_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static bool ring_push(const record_t& record)
+{
+    uint32_t pos = __atomic_load_n(&ring_head, __ATOMIC_RELAXED);
+    for (;;) {
+        record_t* slot = &ring[pos & (LOG_RING_SIZE - 1)];
+        int32_t diff = (int32_t)(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring_head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                slot->level   = record.level;
+                slot->tv_sec  = record.tv_sec;
+                slot->tv_usec = record.tv_usec;
+                slot->length  = record.length;
+                memcpy(slot->text, record.text, record.length);
+                __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false; // Full
+        } else {
+            pos = __atomic_load_n(&ring_head, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+//
+// Write the records ready in the ring. Return their count.
+// Called by one thread at a time: the drain thread, or the last context once it is stopped.
+//
+static uint32_t ring_drain()
+{
+    uint32_t count = 0;
+
+    backend_acquire();
+    for (;;) {
+        record_t* slot = &ring[ring_tail & (LOG_RING_SIZE - 1)];
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != ring_tail + 1) break;
+
+        write_record(*slot);
+        __atomic_store_n(&slot->sequence, ring_tail + LOG_RING_SIZE, __ATOMIC_RELEASE);
+        ring_tail++;
+        count++;
+    }
+
+    uint32_t dropped = __atomic_exchange_n(&ring_dropped, 0, __ATOMIC_RELAXED);
+    if (dropped != 0) {
+        record_t record;
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        record.level   = warn;
+        record.tv_sec  = tv.tv_sec;
+        record.tv_usec = tv.tv_usec;
+        record.length  = snprintf(record.text, sizeof(record.text), "%u log lines dropped, the log ring was full!", dropped);
+        write_record(record);
+    }
+    backend_release();
+
+    return count;
+}
+
+static void* drain_main(void*)
+{
+    prctl(PR_SET_NAME, "ims-log", 0, 0, 0);
+
+    struct timespec period;
+    period.tv_sec  = 0;
+    period.tv_nsec = LOG_DRAIN_PERIOD_NS;
+
+    while (ring_drain() != 0 || __atomic_load_n(&drain_stop, __ATOMIC_ACQUIRE) == 0) {
+        nanosleep(&period, NULL);
+    }
+    return NULL;
+}
+
+//
+// Stop the drain thread and write what is left. context_mutex is held.
+// The producers which saw the ring active finish their push first: the
+// drain thread, still running, makes room for the ones waiting on a full ring.
+//
+static void drain_thread_stop()
+{
+    __atomic_store_n(&ring_active, 0, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&ring_producers, __ATOMIC_SEQ_CST) != 0) {
+        sched_yield();
+    }
+
+    __atomic_store_n(&drain_stop, 1, __ATOMIC_RELEASE);
+    pthread_join(drain_thread, NULL);
+    drain_running = false;
+
+    // Nothing can be pushed anymore: write the last lines
+    ring_drain();
+}
+#endif
+
+//
+// Start the drain thread with the first context
+//
+void attach_context()
+{
+#ifdef IMS_LOG_HAVE_RING
+    // Logs to stderr stay synchronous
+    if (backend_is_file == false || max_level == disabled) return;
+
+    pthread_mutex_lock(&context_mutex);
+    if (context_count++ == 0) {
+        if (ring == NULL) {
+            ring = new record_t[LOG_RING_SIZE];
+            for (uint32_t pos = 0; pos < LOG_RING_SIZE; pos++) {
+                ring[pos].sequence = pos;
+            }
+        }
+        __atomic_store_n(&drain_stop, 0, __ATOMIC_RELAXED);
+        if (pthread_create(&drain_thread, NULL, drain_main, NULL) == 0) {
+            drain_running = true;
+            __atomic_store_n(&ring_active, 1, __ATOMIC_RELEASE);
+        }
+    }
+    pthread_mutex_unlock(&context_mutex);
+#endif
+}
+
+//
+// Stop the drain thread with the last context
+//
+void detach_context()
+{
+#ifdef IMS_LOG_HAVE_RING
+    if (backend_is_file == false || max_level == disabled) return;
+
+    pthread_mutex_lock(&context_mutex);
+    if (--context_count == 0 && drain_running) {
+        drain_thread_stop();
+    }
+    pthread_mutex_unlock(&context_mutex);
+#endif
+}
 
 //
 // Initialize the log API
@@ -66,38 +284,90 @@ __attribute__((constructor)) void load()
             LOG_ERROR("Failed to open log file '" << log_file << "'!");
             exit(1);
         }
+        backend_is_file = true;
     }
 }
 
 //
-// Return the back-end
+// Write and flush what is still buffered
 //
-std::ostream& backend_stream()
+__attribute__((destructor)) void unload()
 {
-    return *backend;
+#ifdef IMS_LOG_HAVE_RING
+    pthread_mutex_lock(&context_mutex);
+    if (drain_running) {
+        drain_thread_stop();
+    }
+    pthread_mutex_unlock(&context_mutex);
+#endif
+    backend->flush();
 }
 
 //
-// Log the current date
+// Log line
 //
-void backend_log_date()
+line::line(level_t level) :
+    _buffer(_record.text, sizeof(_record.text)),
+    _stream(&_buffer)
 {
-  struct timeval tv;
-  struct tm s_tm;
-  gettimeofday(&tv, NULL);
-  // with mingw, we need to convert tv_sec (a long) to localtime_r (a long long)
-  time_t converted_time = tv.tv_sec;
-  localtime_r(&converted_time, &s_tm);
-  
-  *backend << std::setfill('0') << std::setw(2) << s_tm.tm_hour << ":" << std::setfill('0') << std::setw(2) << s_tm.tm_min << ":" << std::setfill('0') << std::setw(2) << s_tm.tm_sec << "," << std::setfill('0') << std::setw(6) << tv.tv_usec << " : " ;
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    _record.level   = level;
+    _record.tv_sec  = tv.tv_sec;
+    _record.tv_usec = tv.tv_usec;
+}
+
+line::~line()
+{
+    _record.length = _buffer.length();
+    if (_stream.bad() && _record.length >= 3) {
+        memcpy(_record.text + _record.length - 3, "...", 3);
+    }
+
+#ifdef IMS_LOG_HAVE_RING
+    // Counted before checking the ring, so it is not stopped under our push
+    __atomic_add_fetch(&ring_producers, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&ring_active, __ATOMIC_SEQ_CST) != 0) {
+        if (ring_push(_record)) {
+            __atomic_sub_fetch(&ring_producers, 1, __ATOMIC_RELEASE);
+            return;
+        }
+
+        // Full: only warnings and errors wait for the drain thread
+        if (_record.level > warn) {
+            __atomic_add_fetch(&ring_dropped, 1, __ATOMIC_RELAXED);
+            __atomic_sub_fetch(&ring_producers, 1, __ATOMIC_RELEASE);
+            return;
+        }
+        sched_yield();
+    }
+    __atomic_sub_fetch(&ring_producers, 1, __ATOMIC_RELEASE);
+#endif
+
+    backend_acquire();
+    write_record(_record);
+    backend_release();
 }
 
 //
-// Close current line in the current back end
+// Rate limiter
 //
-void backend_endl()
+bool rate_limiter::allow(uint32_t& suppressed)
 {
-    *backend << std::endl;
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+
+    // Several threads may hit the same log point: one of them wins the new second
+    int64_t last_second = __atomic_load_n(&_last_second, __ATOMIC_RELAXED);
+    if (tv.tv_sec == last_second ||
+        __atomic_compare_exchange_n(&_last_second, &last_second, (int64_t)tv.tv_sec, false,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED) == false) {
+        __atomic_add_fetch(&_suppressed, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    suppressed = __atomic_exchange_n(&_suppressed, 0, __ATOMIC_RELAXED);
+    return true;
 }
 
 //
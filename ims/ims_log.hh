@@ -19,11 +19,14 @@
 #include "ims.h"
 #include <exception>
 #include <ostream>
+#include <sstream>
+#include <streambuf>
 
 namespace ims {
 
 //
-// Basic exception witch just store and ims_return_code_t
+// Basic exception witch just store and ims_return_code_t,
+// and the message of THROW_IMS_ERROR if any
 //
 class exception : public std::exception
 {
@@ -31,6 +34,9 @@ public:
     inline exception(ims_return_code_t ims_return_code) :
         _ims_return_code(ims_return_code) {}
     
+    inline exception(ims_return_code_t ims_return_code, const std::string& message) :
+        _ims_return_code(ims_return_code), _what(message) {}
+    
     virtual const char* what() const throw();
     
     virtual ~exception() throw () {}
@@ -44,6 +50,14 @@ private:
 
 namespace log {
 
+//
+// Highest log level compiled in. Log points above it are removed at compile
+// time, whatever the IMS_LOG_LEVEL environment variable says.
+//
+#ifndef IMS_LOG_MAX_LEVEL
+#define IMS_LOG_MAX_LEVEL 4
+#endif
+
 //
 // Shortcuts for each log level
 //
@@ -55,23 +69,51 @@ namespace log {
 //
 // Helpers to check level
 //
-#define IS_LOG_DEBUG()   (ims::log::debug <= ims::log::max_level)
-#define IS_LOG_INFO()    (ims::log::info  <= ims::log::max_level)
-#define IS_LOG_WARN()    (ims::log::warn  <= ims::log::max_level)
-#define IS_LOG_ERROR()   (ims::log::error <= ims::log::max_level)
+#define IS_LOG_DEBUG()   LOG_IS_ENABLED(ims::log::debug)
+#define IS_LOG_INFO()    LOG_IS_ENABLED(ims::log::info)
+#define IS_LOG_WARN()    LOG_IS_ENABLED(ims::log::warn)
+#define IS_LOG_ERROR()   LOG_IS_ENABLED(ims::log::error)
 
 //
 // Log a string without file/line and without checking log level
 //
 #define LOG_SAY(message) LOG_PROCESS(ims::log::disabled, message)
 
+//
+// Log an error at most once per second for each call site.
+// For routine errors of the data path, which may happen at every cycle.
+//
+#define LOG_ERROR_RATE_LIMITED(message)                                              \
+    do {                                                                             \
+    if (LOG_IS_ENABLED(ims::log::error)) {                                         \
+    static ims::log::rate_limiter limiter;                                       \
+    uint32_t suppressed;                                                         \
+    if (limiter.allow(suppressed)) {                                             \
+    LOG_ERROR(message << " (" << suppressed << " similar errors suppressed)"); \
+}                                                                            \
+}                                                                              \
+} while (0)
+
+//
+// Helper to return an error code without exception.
+// To be used instead of THROW_IMS_ERROR for routine errors of the data path
+// (queue full, bad size...). Configuration errors keep throwing.
+//
+#define RETURN_IMS_ERROR(ims_return_code, message)                                   \
+    do {                                                                             \
+    LOG_ERROR_RATE_LIMITED(message);                                               \
+    return ims_return_code;                                                        \
+} while (0)
+
 //
 // Helper to throw an exception
 //
 #define THROW_IMS_ERROR(ims_return_code, message)                                    \
     do {                                                                             \
-    LOG_PROCESS(ims::log::error, __FILE__ << ':' << __LINE__ << ' ' << message);   \
-    throw ims::exception(ims_return_code);                                         \
+    std::ostringstream _throw_message;                                             \
+    _throw_message << __FILE__ << ':' << __LINE__ << ' ' << message;               \
+    LOG_PROCESS(ims::log::error, _throw_message.str());                            \
+    throw ims::exception(ims_return_code, _throw_message.str());                   \
 } while (0)
 
 // Helper class to "streamize" a payload
@@ -88,6 +130,24 @@ private:
     uint32_t       _len;
 };
 
+//
+// State of a rate limited log point.
+// Updated with atomics: a log point may be hit by several threads.
+//
+class rate_limiter
+{
+public:
+    rate_limiter() : _last_second(0), _suppressed(0) {}
+
+    // Return true if the log point can log now.
+    // suppressed is set to the number of logs dropped since the last one.
+    bool allow(uint32_t& suppressed);
+
+private:
+    int64_t  _last_second;
+    uint32_t _suppressed;
+};
+
 //
 // Log levels
 //
@@ -100,19 +160,54 @@ enum level_t {
 };
 
 //
-// Access to the backend stream
+// A log line, with a fixed size. Longer texts are truncated.
 //
-std::ostream& backend_stream();
+#define IMS_LOG_RECORD_SIZE 512
+
+struct record_t
+{
+    uint32_t sequence; // State of the ring slot holding the record
+    uint32_t level;
+    int64_t  tv_sec;
+    int32_t  tv_usec;
+    uint32_t length;
+    char     text[IMS_LOG_RECORD_SIZE - 24];
+};
 
 //
-// Log the current date
+// One log line, written by its destructor.
+// The text is formatted by the caller into the record. With a file backend
+// and while a context exists, the record is pushed to a lock-free ring and
+// the date and the write are done by a background thread. Otherwise the
+// line is written at once.
 //
-void backend_log_date();
+class line
+{
+public:
+    line(level_t level);
+    ~line();
+
+    inline std::ostream& stream() { return _stream; }
+
+private:
+    // Stream buffer over the record text
+    class buffer : public std::streambuf
+    {
+    public:
+        buffer(char* text, uint32_t size) { setp(text, text + size); }
+        inline uint32_t length() const { return pptr() - pbase(); }
+    };
+
+    record_t     _record;
+    buffer       _buffer;
+    std::ostream _stream;
+};
 
 //
-// Close the current line for the current backend
+// A context starts the drain thread of the ring, the last one stops it.
 //
-void backend_endl();
+void attach_context();
+void detach_context();
 
 //
 // Internal log level
@@ -120,14 +215,23 @@ void backend_endl();
 extern level_t max_level;
 
 //
-// internal LOG macro
+// internal LOG macros
+// The message is only evaluated when the level is enabled.
 //
+#ifdef __GNUC__
+#define LOG_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#else
+#define LOG_UNLIKELY(condition) (condition)
+#endif
+
+#define LOG_IS_ENABLED(level) \
+    ((level) <= IMS_LOG_MAX_LEVEL && LOG_UNLIKELY((level) <= ims::log::max_level))
+
 #define LOG_PROCESS(level, message)             \
     do {                                        \
-    if (level <= ims::log::max_level) {       \
-    ims::log::backend_log_date();            \
-    ims::log::backend_stream() << message;  \
-    ims::log::backend_endl();               \
+    if (LOG_IS_ENABLED(level)) {              \
+    ims::log::line _log_line(level);         \
+    _log_line.stream() << message;           \
 }                                         \
 } while (0)
 
@@ -15,6 +15,7 @@
  */
 #include "ims_message.hh"
 #include "ims_log.hh"
+#include <string.h>
 
 namespace ims
 {
@@ -70,6 +71,28 @@ throw(ims::exception)
                     "Cannot read from this message ! (internal error).");
 }
 
+ims_return_code_t message::read_sampling_view(__attribute__((__unused__)) ims_message_view_t* view)
+throw(ims::exception)
+{
+    if (_direction == ims_output) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot read from an OUTPUT message !");
+    }
+
+    if (_mode == ims_queuing) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot read from a QUEUING message ! Use pop() method instead.");
+    }
+
+    if (_protocol == ims_nad) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot use sampling functions for NAD protocol !");
+    }
+
+    THROW_IMS_ERROR(ims_implementation_specific_error,
+                    "Cannot get a view on this message ! Use ims_read_sampling_message() instead.");
+}
+
 ims_return_code_t message::push_queuing(__attribute__((__unused__)) const char* message_addr,
                                         __attribute__((__unused__)) uint32_t    message_size)
 throw(ims::exception)
@@ -179,6 +202,14 @@ throw(ims::exception)
     return ims_no_error;
 }
 
+ims_return_code_t message::send_counters(__attribute__((__unused__)) uint32_t* retried_count,
+                                         __attribute__((__unused__)) uint32_t* dropped_count)
+throw(ims::exception)
+{
+    THROW_IMS_ERROR(ims_implementation_specific_error,
+                    "Cannot get send counters of message " << get_name() << " !");
+}
+
 ims_return_code_t message::set_id(__attribute__((__unused__)) const uint32_t pId)
 throw(ims::exception)
 {
@@ -241,6 +272,60 @@ throw(ims::exception)
                     "Cannot read from this message ! (internal error).");
 }
 
+ims_return_code_t message::read_nad_view(__attribute__((__unused__)) ims_message_view_t* view)
+throw(ims::exception)
+{
+    if (_direction == ims_output) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot read from an OUTPUT message !");
+    }
+
+    if (_protocol != ims_nad) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot use NAD functions for " << ims_protocol_string(_protocol) << " protocol !");
+    }
+
+    THROW_IMS_ERROR(ims_implementation_specific_error,
+                    "Cannot get a view on this message ! (internal error).");
+}
+
+ims_return_code_t message::release_view(ims_message_view_t* view)
+throw(ims::exception)
+{
+    memset(view, 0, sizeof(ims_message_view_t));
+    return ims_no_error;
+}
+
+ims_return_code_t message::acquire_output_buffer(__attribute__((__unused__)) char**    buffer,
+                                                 __attribute__((__unused__)) uint32_t* capacity)
+throw(ims::exception)
+{
+    if (_direction == ims_input) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot write to an INPUT message !");
+    }
+
+    if (_mode == ims_queuing) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot write to a QUEUING message ! Use push() method instead.");
+    }
+
+    THROW_IMS_ERROR(ims_implementation_specific_error,
+                    "Cannot write in place to this message ! Use ims_write_sampling_message() instead.");
+}
+
+ims_return_code_t message::commit_output_buffer(__attribute__((__unused__)) uint32_t message_size)
+throw(ims::exception)
+{
+    if (_direction == ims_input) {
+        THROW_IMS_ERROR(ims_invalid_configuration,
+                        "Cannot write to an INPUT message !");
+    }
+
+    THROW_IMS_ERROR(ims_implementation_specific_error,
+                    "Cannot write in place to this message ! Use ims_write_sampling_message() instead.");
+}
+
 /***************
  * Debug stuff *
  ***************/
@@ -43,7 +43,7 @@ class message : public ims_internal_message_t
     // Basic accessors
     //***************************************************************************
 public:
-    inline std::string get_name();
+    inline const std::string& get_name();
     inline ims_protocol_t get_protocol();
     inline ims_direction_t get_direction();
     inline ims_mode_t get_mode();
@@ -84,6 +84,9 @@ public:
                                             ims_validity_t* message_validity)
     throw(ims::exception);
     
+    virtual ims_return_code_t read_sampling_view(ims_message_view_t* view)
+    throw(ims::exception);
+    
     virtual ims_return_code_t push_queuing(const char* message_addr,
                                            uint32_t    message_size)
     throw(ims::exception);
@@ -102,6 +105,21 @@ public:
                                        ims_validity_t* message_validity)
     throw(ims::exception);
     
+    virtual ims_return_code_t read_nad_view(ims_message_view_t* view)
+    throw(ims::exception);
+    
+    // Default implementation just clears the view
+    virtual ims_return_code_t release_view(ims_message_view_t* view)
+    throw(ims::exception);
+    
+    // In place write of output messages
+    virtual ims_return_code_t acquire_output_buffer(char**    buffer,
+                                                    uint32_t* capacity)
+    throw(ims::exception);
+    
+    virtual ims_return_code_t commit_output_buffer(uint32_t message_size)
+    throw(ims::exception);
+    
     
     virtual ims_return_code_t get_max_size(uint32_t* max_size)
     throw(ims::exception);
@@ -128,6 +146,9 @@ public:
     throw(ims::exception);
     
     virtual ims_return_code_t get_depth(uint32_t* depth)
+    throw(ims::exception);
+
+    virtual ims_return_code_t send_counters(uint32_t* retried_count, uint32_t* dropped_count)
     throw(ims::exception);
 
 	virtual ims_return_code_t set_id(const uint32_t pId)
@@ -197,7 +218,7 @@ message::~message()
 {
 }
 
-std::string message::get_name()
+const std::string& message::get_name()
 {
     return _name;
 }
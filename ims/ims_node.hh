@@ -43,9 +43,9 @@ public:
     inline virtual ~node() {}
 
     // Accessor
-    inline std::string   get_name();
-    inline weak_node_ptr get_parent();
-    inline std::string   get_path();    // Will alloc for all non-root nodes
+    inline const std::string& get_name();
+    inline weak_node_ptr      get_parent();
+    inline std::string        get_path();    // Will alloc for all non-root nodes
 
     // Children
     void add_child(node_ptr child) throw (ims::exception);
@@ -91,9 +91,9 @@ node::node(std::string name, weak_node_ptr parent) :
 {
 }
 
-std::string   node::get_name()   { return _name;                                                }
-weak_node_ptr node::get_parent() { return _parent;                                              }
-std::string   node::get_path()   { return (_parent)? _parent->get_path() + '/' + _name : _name; }
+const std::string& node::get_name()   { return _name;                                                }
+weak_node_ptr      node::get_parent() { return _parent;                                              }
+std::string        node::get_path()   { return (_parent)? _parent->get_path() + '/' + _name : _name; }
 
 node_map_t::iterator node::children_begin()    { return _children.begin(); }
 node_map_t::iterator node::children_end()      { return _children.end();   }
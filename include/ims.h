@@ -145,6 +145,40 @@ typedef struct ims_internal_node_list_t*     ims_node_list_t;
  */
 typedef struct ims_internal_messages_list_t* ims_messages_list_t;
 
+/**
+ * @ingroup group_reactor
+ * @brief LIBIMS reactor type structure.
+ */
+typedef struct ims_internal_reactor_t*       ims_reactor_t;
+
+/**
+ * @ingroup group_message_content
+ * @brief Read only view on the payload of an input message, without copy.
+ * @see ims_read_sampling_message_view()
+ * @see ims_read_nad_message_view()
+ */
+typedef struct {
+    const char*    data;        ///< Message payload, in LIBIMS memory. Stable until the next ims_import(). NULL if there is no payload.
+    uint32_t       size;        ///< Payload size.
+    ims_validity_t validity;    ///< Payload validity, same as the one of ims_read_sampling_message() or ims_read_nad_message().
+    uint32_t       generation;  ///< Incremented each time a new payload is received. Compare it to know if the payload changed.
+} ims_message_view_t;
+
+/**
+ * @ingroup group_message_content
+ * @brief One element of a batched read/write.
+ * @see ims_read_sampling_messages()
+ * @see ims_write_sampling_messages()
+ * @see ims_push_queuing_messages()
+ * @see ims_pop_queuing_messages()
+ */
+typedef struct {
+    char*             data;      ///< Payload buffer. Same requirements as the message_addr of the single message function.
+    uint32_t          size;      ///< [in] Payload size to write or push. [out] Payload size read or popped.
+    ims_validity_t    validity;  ///< [out] Payload validity, for reads only.
+    ims_return_code_t result;    ///< [out] Return code of the single message function for this element.
+} ims_io_desc_t;
+
 #pragma pack (push, 1)
 
 /**
@@ -659,6 +693,60 @@ extern LIBIMS_EXPORT ims_return_code_t ims_import(ims_node_t ims_context, uint32
  */
 extern LIBIMS_EXPORT ims_return_code_t ims_send_all(ims_node_t ims_context);
 
+/**
+ * @defgroup group_reactor Reactor
+ * @brief Import the messages of several contexts of the process with one call.@n
+ * The reactor waits for the incoming data of all its contexts at once, then
+ * lets only the contexts which received something import it. It is meant for
+ * processes hosting many virtual components.
+ */
+
+/**
+ * @ingroup group_reactor
+ * @brief Create an empty reactor.
+ * @param reactor [out] The new reactor.
+ * @return The @ref ims_return_code_t return code.
+ */
+extern LIBIMS_EXPORT ims_return_code_t ims_create_reactor(ims_reactor_t* reactor);
+
+/**
+ * @ingroup group_reactor
+ * @brief Free a reactor previously allocated by @ref ims_create_reactor().
+ * Its contexts are detached, not freed.
+ * @param reactor [in] The reactor.
+ */
+extern LIBIMS_EXPORT void ims_free_reactor(ims_reactor_t reactor);
+
+/**
+ * @ingroup group_reactor
+ * @brief Import the messages of the context with ims_reactor_import().@n
+ * A context belongs to one reactor at most. A freed context leaves its reactor.
+ * @param reactor [in] The reactor.
+ * @param ims_context [in] The LIBIMS context previously created.
+ * @return The @ref ims_return_code_t return code.
+ */
+extern LIBIMS_EXPORT ims_return_code_t ims_reactor_attach(ims_reactor_t reactor, ims_node_t ims_context);
+
+/**
+ * @ingroup group_reactor
+ * @brief Remove a context from the reactor. ims_import() can still be called on it.
+ * @param reactor [in] The reactor.
+ * @param ims_context [in] The LIBIMS context previously attached.
+ * @return The @ref ims_return_code_t return code.
+ */
+extern LIBIMS_EXPORT ims_return_code_t ims_reactor_detach(ims_reactor_t reactor, ims_node_t ims_context);
+
+/**
+ * @ingroup group_reactor
+ * @brief Same as ims_import() on each context of the reactor, with a single wait for all of them.@n
+ * This function will return immediatelly when no more messages available or
+ * timeout_us reached.
+ * @param reactor [in] The reactor.
+ * @param timeout_us [in] Maximum time available for this method.
+ * @return The @ref ims_return_code_t return code.
+ */
+extern LIBIMS_EXPORT ims_return_code_t ims_reactor_import(ims_reactor_t reactor, uint32_t timeout_us);
+
 /***********************
  * Stop/Hold functions *
  ***********************/
@@ -770,6 +858,22 @@ extern LIBIMS_EXPORT ims_return_code_t ims_read_sampling_message(ims_message_t
                                                                  uint32_t*       message_size,
                                                                  ims_validity_t* message_validity);
 
+/**
+ * @ingroup group_message_content
+ * @brief Read a sampling message without copying its payload.@n
+ * Same as ims_read_sampling_message(), but the view points to the payload kept by LIBIMS.
+ * The payload must not be modified. It is stable until the next ims_import().@n
+ * In thread-safe mode, ims_import() may run in another thread: compare the generation
+ * with a new view after use to know if the payload changed meanwhile.@n
+ * Only AFDX, A429 and CAN messages support views.
+ * @see ims_release_view()
+ * @param message [in] The message element.
+ * @param view [out] Will be filled with the payload address, size, validity and generation.
+ * @return The @ref ims_return_code_t return code.
+ */
+extern LIBIMS_EXPORT ims_return_code_t ims_read_sampling_message_view(ims_message_t       message,
+                                                                      ims_message_view_t* view);
+
 /**
  * @ingroup group_message_content
  * @brief Push a queuing message.@n
@@ -814,6 +918,20 @@ extern LIBIMS_EXPORT ims_return_code_t ims_pop_queuing_message(ims_message_t mes
 extern LIBIMS_EXPORT ims_return_code_t ims_queuing_message_pending(ims_message_t message,
                                                                    uint32_t*     messages_count);
 
+/**
+ * @ingroup group_message_content
+ * @brief Return the send counters of an output message, since its context creation.@n
+ * Messages the network cannot take at once are not lost: they are sent again by the next ims_send_all().@n
+ * When too many of them are waiting, the oldest ones are dropped.
+ * @param message [in] The message element.
+ * @param retried_count [out] Will be filled with the number of messages which had to be sent again.
+ * @param dropped_count [out] Will be filled with the number of messages dropped.
+ * @return The @ref ims_return_code_t return code.
+ */
+extern LIBIMS_EXPORT ims_return_code_t ims_message_send_counters(ims_message_t message,
+                                                                 uint32_t*     retried_count,
+                                                                 uint32_t*     dropped_count);
+
 /**
  * @ingroup group_message_content
  * @brief Write to a NAD message.@n
@@ -848,6 +966,111 @@ extern LIBIMS_EXPORT ims_return_code_t ims_read_nad_message(ims_message_t   mess
                                                             uint32_t*       message_size,
                                                             ims_validity_t* message_validity);
 
+/**
+ * @ingroup group_message_content
+ * @brief Read a NAD message without copying its payload.@n
+ * Same as ims_read_nad_message(), but the view points to the payload kept by LIBIMS.
+ * The payload must not be modified. It is stable until the next ims_import().
+ * @see ims_release_view()
+ * @param message [in] The message element.
+ * @param view [out] Will be filled with the payload address, size, validity and generation.
+ * @return The @ref ims_return_code_t return code.
+ */
+extern LIBIMS_EXPORT ims_return_code_t ims_read_nad_message_view(ims_message_t       message,
+                                                                 ims_message_view_t* view);
+
+/**
+ * @ingroup group_message_content
+ * @brief Release a view got from ims_read_sampling_message_view() or ims_read_nad_message_view().@n
+ * The view is cleared and must not be used anymore.
+ * @param message [in] The message element of the view.
+ * @param view [in,out] The view to release.
+ * @return The @ref ims_return_code_t return code.
+ */
+extern LIBIMS_EXPORT ims_return_code_t ims_release_view(ims_message_t       message,
+                                                        ims_message_view_t* view);
+
+/**
+ * @ingroup group_message_content
+ * @brief Get the buffer of an output message, to write its payload in place.@n
+ * The payload written in the buffer is sent after a call to ims_commit_output_buffer(),
+ * like with ims_write_sampling_message() or ims_write_nad_message(), but without copy.@n
+ * Only AFDX, A429, CAN and NAD messages support it.@n
+ * In thread-safe mode, a sampling message gives a private copy of its data, written to the message
+ * by ims_commit_output_buffer(), and can only be acquired by one writer at a time.
+ * @param message [in] The message element.
+ * @param buffer [out] Will be filled with the address of the message buffer.
+ * @param capacity [out] Will be filled with the size of the message buffer.
+ * @return The @ref ims_return_code_t return code.
+ */
+extern LIBIMS_EXPORT ims_return_code_t ims_acquire_output_buffer(ims_message_t message,
+                                                                 char**        buffer,
+                                                                 uint32_t*     capacity);
+
+/**
+ * @ingroup group_message_content
+ * @brief Commit the payload written in the buffer got from ims_acquire_output_buffer().@n
+ * The message will be sent on the next ims_send_all().
+ * @param message [in] The message element.
+ * @param message_size [in] The size of the payload written in the buffer.
+ * @return The @ref ims_return_code_t return code. Same as ims_write_sampling_message() or ims_write_nad_message().
+ */
+extern LIBIMS_EXPORT ims_return_code_t ims_commit_output_buffer(ims_message_t message,
+                                                                uint32_t      message_size);
+
+/**
+ * @ingroup group_message_content
+ * @brief Read several sampling messages in one call.@n
+ * Same as calling ims_read_sampling_message() on each message, the result of each one is stored in its descriptor.
+ * Ordering the messages by port gives a better memory locality.
+ * @param messages [in] The message elements.
+ * @param count [in] Number of message elements and descriptors.
+ * @param descs [in,out] One descriptor per message.
+ * @return The worst @ref ims_return_code_t return code of all messages.
+ */
+extern LIBIMS_EXPORT ims_return_code_t ims_read_sampling_messages(const ims_message_t* messages,
+                                                                  uint32_t             count,
+                                                                  ims_io_desc_t*       descs);
+
+/**
+ * @ingroup group_message_content
+ * @brief Write several sampling messages in one call.@n
+ * Same as calling ims_write_sampling_message() on each message, the result of each one is stored in its descriptor.
+ * @param messages [in] The message elements.
+ * @param count [in] Number of message elements and descriptors.
+ * @param descs [in,out] One descriptor per message.
+ * @return The worst @ref ims_return_code_t return code of all messages.
+ */
+extern LIBIMS_EXPORT ims_return_code_t ims_write_sampling_messages(const ims_message_t* messages,
+                                                                   uint32_t             count,
+                                                                   ims_io_desc_t*       descs);
+
+/**
+ * @ingroup group_message_content
+ * @brief Push several queuing messages in one call.@n
+ * Same as calling ims_push_queuing_message() on each message, the result of each one is stored in its descriptor.
+ * @param messages [in] The message elements.
+ * @param count [in] Number of message elements and descriptors.
+ * @param descs [in,out] One descriptor per message.
+ * @return The worst @ref ims_return_code_t return code of all messages.
+ */
+extern LIBIMS_EXPORT ims_return_code_t ims_push_queuing_messages(const ims_message_t* messages,
+                                                                 uint32_t             count,
+                                                                 ims_io_desc_t*       descs);
+
+/**
+ * @ingroup group_message_content
+ * @brief Pop several queuing messages in one call.@n
+ * Same as calling ims_pop_queuing_message() on each message, the result of each one is stored in its descriptor.
+ * @param messages [in] The message elements.
+ * @param count [in] Number of message elements and descriptors.
+ * @param descs [in,out] One descriptor per message.
+ * @return The worst @ref ims_return_code_t return code of all messages.
+ */
+extern LIBIMS_EXPORT ims_return_code_t ims_pop_queuing_messages(const ims_message_t* messages,
+                                                                uint32_t             count,
+                                                                ims_io_desc_t*       descs);
+
 #ifdef __cplusplus
 };
 #endif